@@ -0,0 +1,254 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCAllocCounter.hpp"
+#include "HCBench.hpp"
+#include "HCLog.hpp"
+#include "HCSideKernel.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    /**
+     * @brief JSON number, null if not available
+     */
+    std::string toJson(double value, bool available = true)
+    {
+        if (!available)
+            return "null";
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.9g", value);
+        return buf;
+    }
+
+    std::string toJson(const std::string& s)
+    {
+        std::string res = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                res += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                res += c;
+        }
+        return res + "\"";
+    }
+
+    /**
+     * @brief model of the CPU, empty if unknown
+     */
+    std::string getCpuName()
+    {
+        std::ifstream in("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                auto pos = line.find(':');
+                if (pos != std::string::npos && pos + 2 <= line.size())
+                    return line.substr(pos + 2);
+            }
+        }
+        return std::string();
+    }
+}
+
+HCBench::HCBench(double minTime, unsigned repetitions, const std::string& filter):
+    m_minTime(minTime),
+    m_repetitions(std::max(1u, repetitions)),
+    m_filter(filter)
+{
+    if (!m_counters.isAvailable())
+        HCLogInfo("Hardware counters not available (perf_event_open), time only");
+}
+
+HCBench::~HCBench() = default;
+
+bool HCBench::isSelected(const std::string& name) const
+{
+    return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void HCBench::run(const std::string& name, const std::string& item, double itemsPerOp,
+                const Body& body, uint64_t maxIterations)
+{
+    if (!isSelected(name))
+        return;
+
+    double counters[HC_NB_COUNTERS];
+    std::vector<double> nsPerOp;
+    double sums[HC_NB_COUNTERS] = {};
+    uint64_t allocs = 0;
+    uint64_t allocSum = 0;
+    uint64_t n = 1;
+    try {
+        // Warm up and calibrate the number of operations of a repetition
+        const double target = m_minTime * 1e9;
+        for (;;) {
+            double ns = measure(body, n, counters, allocs);
+            if (ns >= target || n >= maxIterations)
+                break;
+            double factor = ns > 0.0 ? 1.2 * target / ns : 100.0;
+            factor = std::min(100.0, std::max(2.0, factor));
+            n = std::min(maxIterations, static_cast<uint64_t>(static_cast<double>(n) * factor));
+        }
+
+        for (unsigned r = 0; r < m_repetitions; ++r) {
+            nsPerOp.push_back(measure(body, n, counters, allocs) / static_cast<double>(n));
+            allocSum += allocs;
+            for (int c = 0; c < HC_NB_COUNTERS; ++c)
+                sums[c] += counters[c];
+        }
+    } catch (const std::exception& e) {
+        m_counters.stop();
+        HCLogError(name + " failed: " + e.what());
+        return;
+    }
+
+    BenchResult res;
+    res.name = name;
+    res.item = item;
+    res.itemsPerOp = itemsPerOp;
+    res.iterations = n;
+    res.repetitions = m_repetitions;
+
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    res.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+    res.nsPerOpMin = nsPerOp.front();
+    res.nsPerOpMax = nsPerOp.back();
+    for (int c = 0; c < HC_NB_COUNTERS; ++c) {
+        res.hasCounter[c] = m_counters.isAvailable(static_cast<HCCounter>(c));
+        res.counterPerOp[c] = sums[c] / static_cast<double>(n * m_repetitions);
+    }
+    res.allocsPerOp = static_cast<double>(allocSum) / static_cast<double>(n * m_repetitions);
+
+    char line[256];
+    int len = snprintf(line, sizeof(line), "%-40s %12.1f ns/op %12.4g %s/s", name.c_str(),
+                        res.nsPerOp, itemsPerOp * 1e9 / res.nsPerOp, item.c_str());
+    if (res.hasCounter[HC_CYCLES] && res.hasCounter[HC_INSTRUCTIONS] && res.counterPerOp[HC_CYCLES] > 0)
+        snprintf(line + len, sizeof(line) - static_cast<size_t>(len), "  IPC %5.2f",
+                res.counterPerOp[HC_INSTRUCTIONS] / res.counterPerOp[HC_CYCLES]);
+    len = static_cast<int>(std::strlen(line));
+    if (HCAllocCounter::isEnabled())
+        snprintf(line + len, sizeof(line) - static_cast<size_t>(len), "  %.3g allocs/op", res.allocsPerOp);
+    HCLogInfo(std::string(line));
+
+    m_results.push_back(res);
+}
+
+void HCBench::addAccuracy(const std::string& name, const std::vector<double>& computed,
+                        const std::vector<double>& reference, double scale)
+{
+    AccuracyResult res;
+    res.name = name;
+    res.points = std::min(computed.size(), reference.size());
+    for (size_t i = 0; i < res.points; ++i) {
+        double error = std::fabs(computed[i] - reference[i]);
+        if (scale > 0.0)
+            error /= scale;
+        else if (reference[i] != 0.0)
+            error /= std::fabs(reference[i]);
+        res.maxError = std::max(res.maxError, error);
+        res.meanError += error;
+    }
+    if (res.points > 0)
+        res.meanError /= static_cast<double>(res.points);
+
+    char line[256];
+    snprintf(line, sizeof(line), "%-40s %12.3g max error %12.3g mean, %zu points", name.c_str(),
+                res.maxError, res.meanError, res.points);
+    HCLogInfo(std::string(line));
+
+    m_accuracy.push_back(res);
+}
+
+const std::vector<BenchResult>& HCBench::getResults() const
+{
+    return m_results;
+}
+
+void HCBench::writeJson(std::ostream& out, const std::string& version) const
+{
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"version\": " << toJson(version) << ",\n";
+    out << "  \"date\": " << toJson(std::string(date)) << ",\n";
+    out << "  \"cpu\": " << toJson(getCpuName()) << ",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"isa\": " << toJson(std::string(HCSideKernel::getIsaName(HCSideKernel::getIsa()))) << ",\n";
+    out << "  \"min_time_s\": " << toJson(m_minTime) << ",\n";
+    out << "  \"perf_counters\": " << (m_counters.isAvailable() ? "true" : "false") << ",\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchResult& r = m_results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n";
+        out << "      \"name\": " << toJson(r.name) << ",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"repetitions\": " << r.repetitions << ",\n";
+        out << "      \"ns_per_op\": " << toJson(r.nsPerOp) << ",\n";
+        out << "      \"ns_per_op_min\": " << toJson(r.nsPerOpMin) << ",\n";
+        out << "      \"ns_per_op_max\": " << toJson(r.nsPerOpMax) << ",\n";
+        out << "      \"item\": " << toJson(r.item) << ",\n";
+        out << "      \"items_per_op\": " << toJson(r.itemsPerOp) << ",\n";
+        out << "      \"items_per_second\": " << toJson(r.itemsPerOp * 1e9 / r.nsPerOp) << ",\n";
+        for (int c = 0; c < HC_NB_COUNTERS; ++c)
+            out << "      \"" << HCPerfCounters::getName(static_cast<HCCounter>(c)) << "_per_op\": "
+                << toJson(r.counterPerOp[c], r.hasCounter[c]) << ",\n";
+        out << "      \"allocs_per_op\": " << toJson(r.allocsPerOp, HCAllocCounter::isEnabled()) << ",\n";
+        bool ipc = r.hasCounter[HC_CYCLES] && r.hasCounter[HC_INSTRUCTIONS] && r.counterPerOp[HC_CYCLES] > 0;
+        out << "      \"ipc\": " << toJson(ipc ? r.counterPerOp[HC_INSTRUCTIONS] / r.counterPerOp[HC_CYCLES] : 0.0, ipc)
+            << "\n    }";
+    }
+    out << "\n  ],\n";
+    out << "  \"accuracy\": [";
+    for (size_t i = 0; i < m_accuracy.size(); ++i) {
+        const AccuracyResult& r = m_accuracy[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n";
+        out << "      \"name\": " << toJson(r.name) << ",\n";
+        out << "      \"points\": " << r.points << ",\n";
+        out << "      \"max_error\": " << toJson(r.maxError) << ",\n";
+        out << "      \"mean_error\": " << toJson(r.meanError) << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+double HCBench::measure(const Body& body, uint64_t n, double counters[HC_NB_COUNTERS], uint64_t& allocs)
+{
+    const uint64_t allocStart = HCAllocCounter::getThreadCount();
+    m_counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+    body(n);
+    auto tstop = std::chrono::steady_clock::now();
+    m_counters.stop();
+    allocs = HCAllocCounter::getThreadCount() - allocStart;
+
+    for (int c = 0; c < HC_NB_COUNTERS; ++c)
+        counters[c] = static_cast<double>(m_counters.get(static_cast<HCCounter>(c)));
+    return std::chrono::duration<double, std::nano>(tstop - tstart).count();
+}
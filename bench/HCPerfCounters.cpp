@@ -0,0 +1,129 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCPerfCounters.hpp"
+
+using namespace HydroCpp;
+
+#ifdef __linux__
+namespace
+{
+    const uint32_t  COUNTER_TYPES[HC_NB_COUNTERS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+    const uint64_t  COUNTER_CONFIGS[HC_NB_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+    int openCounter(uint32_t type, uint64_t config, int groupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = groupFd == -1 ? 1 : 0;  // the group follows its leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+}
+#endif
+
+HCPerfCounters::HCPerfCounters()
+{
+    for (int c = 0; c < HC_NB_COUNTERS; ++c) {
+        m_fd[c] = -1;
+        m_slot[c] = -1;
+        m_values[c] = 0;
+    }
+
+#ifdef __linux__
+    for (int c = 0; c < HC_NB_COUNTERS; ++c) {
+        m_fd[c] = openCounter(COUNTER_TYPES[c], COUNTER_CONFIGS[c], m_leader);
+        if (m_fd[c] < 0)
+            continue;
+        if (m_leader < 0)
+            m_leader = m_fd[c];
+        m_slot[c] = m_nOpen++;
+    }
+#endif
+}
+
+HCPerfCounters::~HCPerfCounters()
+{
+#ifdef __linux__
+    // Members first, the leader last
+    for (int c = HC_NB_COUNTERS - 1; c >= 0; --c)
+        if (m_fd[c] >= 0)
+            close(m_fd[c]);
+#endif
+}
+
+bool HCPerfCounters::isAvailable() const
+{
+    return m_nOpen > 0;
+}
+
+bool HCPerfCounters::isAvailable(HCCounter counter) const
+{
+    return m_slot[counter] >= 0;
+}
+
+void HCPerfCounters::start()
+{
+#ifdef __linux__
+    if (m_leader < 0)
+        return;
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void HCPerfCounters::stop()
+{
+#ifdef __linux__
+    if (m_leader < 0)
+        return;
+    ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time enabled, time running, then a value per counter
+    uint64_t data[3 + HC_NB_COUNTERS];
+    if (read(m_leader, data, sizeof(data)) < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+        return;
+    const double scale = data[2] > 0 ? static_cast<double>(data[1]) / static_cast<double>(data[2]) : 0.0;
+    for (int c = 0; c < HC_NB_COUNTERS; ++c)
+        if (m_slot[c] >= 0 && static_cast<uint64_t>(m_slot[c]) < data[0])
+            m_values[c] = static_cast<uint64_t>(static_cast<double>(data[3 + m_slot[c]]) * scale);
+#endif
+}
+
+uint64_t HCPerfCounters::get(HCCounter counter) const
+{
+    return m_values[counter];
+}
+
+const char* HCPerfCounters::getName(HCCounter counter)
+{
+    static const char* const NAMES[HC_NB_COUNTERS] = {
+        "cycles", "instructions", "cache_misses", "branch_misses" };
+    return NAMES[counter];
+}
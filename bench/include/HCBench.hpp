@@ -0,0 +1,153 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCPerfCounters.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief measures of one benchmark
+     */
+    struct BenchResult
+    {
+        std::string name;
+        std::string item;                           // unit of the throughput
+        double      itemsPerOp          {0.0};
+        uint64_t    iterations          {0};        // per repetition
+        unsigned    repetitions         {0};
+        double      nsPerOp             {0.0};      // median of the repetitions
+        double      nsPerOpMin          {0.0};
+        double      nsPerOpMax          {0.0};
+        bool        hasCounter[HC_NB_COUNTERS]  {};
+        double      counterPerOp[HC_NB_COUNTERS] {};
+        double      allocsPerOp         {0.0};      // calling thread, 0 unless HYDROCPP_COUNT_ALLOCS
+    };
+
+    /**
+     * @brief deviation of computed values from a reference
+     */
+    struct AccuracyResult
+    {
+        std::string name;
+        size_t      points              {0};
+        double      maxError            {0.0};      // relative, absolute where the reference is 0
+        double      meanError           {0.0};
+    };
+
+    /**
+     * @brief Microbenchmark runner. Each benchmark body runs a given
+     * number of operations; the runner calibrates this number so that
+     * one repetition lasts the min time, then times several repetitions
+     * and reports the median, with the hardware counters per operation
+     * when available and the heap allocations per operation in the
+     * HYDROCPP_COUNT_ALLOCS builds.
+     */
+    class HCBench
+    {
+    public:
+        /**
+         * @brief body of a benchmark, runs n operations
+         */
+        using Body = std::function<void(uint64_t n)>;
+
+        /**
+         * @brief constructor
+         * @param minTime min duration of a repetition, in seconds
+         * @param repetitions number of timed repetitions
+         * @param filter only the benchmarks whose name contains it run
+         */
+        HCBench(double minTime, unsigned repetitions, const std::string& filter);
+
+        /**
+         * @brief destructor
+         */
+        ~HCBench();
+
+        /**
+         * @brief return true if a benchmark would run, to skip the
+         * preparation of the filtered out ones
+         */
+        bool isSelected(const std::string& name) const;
+
+        /**
+         * @brief run a benchmark, if selected, and log its result.
+         * A benchmark throwing is logged and left out of the results
+         * @param name unique name, '/' separated
+         * @param item unit of the throughput (vertices, sections...)
+         * @param itemsPerOp number of items processed per operation
+         * @param body the operations to be timed
+         * @param maxIterations cap of the calibration, for the slow
+         * operations with side effects (file writes)
+         */
+        void run(const std::string& name, const std::string& item, double itemsPerOp,
+                const Body& body, uint64_t maxIterations = UINT64_MAX);
+
+        /**
+         * @brief record and log the accuracy of computed values
+         * @param name unique name, '/' separated
+         * @param computed values, in the order of the reference
+         * @param reference closed form values
+         * @param scale the errors are relative to it if positive, e.g.
+         * for values crossing zero, otherwise to each reference value
+         * (absolute where it is zero)
+         */
+        void addAccuracy(const std::string& name, const std::vector<double>& computed,
+                        const std::vector<double>& reference, double scale = 0.0);
+
+        /**
+         * @brief return the results, in the order of the runs
+         */
+        const std::vector<BenchResult>& getResults() const;
+
+        /**
+         * @brief write the results as JSON
+         * @param out the stream
+         * @param version of HydroCpp
+         */
+        void writeJson(std::ostream& out, const std::string& version) const;
+
+        /**
+         * @brief prevent the compiler from optimizing a result away
+         */
+        template <typename T>
+        static void keep(const T& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile const void* sink;
+            sink = &value;
+#endif
+        }
+
+    private:
+        /**
+         * @brief time n operations of the body, counters included
+         * @param allocs set to the heap allocations of the calling thread
+         * @return the duration in nanoseconds
+         */
+        double measure(const Body& body, uint64_t n, double counters[HC_NB_COUNTERS], uint64_t& allocs);
+
+    private:
+        double                      m_minTime;
+        unsigned                    m_repetitions;
+        std::string                 m_filter;
+        HCPerfCounters              m_counters;
+        std::vector<BenchResult>    m_results;
+        std::vector<AccuracyResult> m_accuracy;
+    };
+
+}  // namespace std
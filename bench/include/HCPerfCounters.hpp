@@ -0,0 +1,91 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstdint>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief hardware counters read by HCPerfCounters
+     */
+    enum HCCounter
+    {
+        HC_CYCLES = 0,
+        HC_INSTRUCTIONS,
+        HC_CACHE_MISSES,
+        HC_BRANCH_MISSES,
+        HC_NB_COUNTERS
+    };
+
+    /**
+     * @brief Hardware counters of the calling thread, user space only,
+     * through perf_event_open (Linux). The counters are opened as one
+     * group, so they are read over the same interval. A counter the
+     * kernel or the CPU doesn't provide (virtual machine,
+     * perf_event_paranoid > 2...) is reported as not available, the
+     * others are still read.
+     */
+    class HCPerfCounters
+    {
+    public:
+        /**
+         * @brief constructor, open the counters
+         */
+        HCPerfCounters();
+
+        /**
+         * @brief destructor, close the counters
+         */
+        ~HCPerfCounters();
+
+        HCPerfCounters(const HCPerfCounters&) = delete;
+        HCPerfCounters& operator=(const HCPerfCounters&) = delete;
+
+        /**
+         * @brief return true if at least one counter is available
+         */
+        bool isAvailable() const;
+
+        /**
+         * @brief return true if the counter is available
+         */
+        bool isAvailable(HCCounter counter) const;
+
+        /**
+         * @brief reset and start the counters
+         */
+        void start();
+
+        /**
+         * @brief stop the counters and read them
+         */
+        void stop();
+
+        /**
+         * @brief value of a counter between the last start and stop,
+         * scaled if the kernel multiplexed the group
+         */
+        uint64_t get(HCCounter counter) const;
+
+        /**
+         * @brief name of a counter, as in the JSON reports
+         */
+        static const char* getName(HCCounter counter);
+
+    private:
+        int         m_fd[HC_NB_COUNTERS];
+        int         m_leader    { -1 };
+        int         m_slot[HC_NB_COUNTERS];     // position in the group read, -1 if not open
+        int         m_nOpen     { 0 };
+        uint64_t    m_values[HC_NB_COUNTERS];
+    };
+
+}  // namespace std
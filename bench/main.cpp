@@ -0,0 +1,571 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+#define _USE_MATH_DEFINES
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ===== External Includes ===== //
+#include <OpenXLSX.hpp>
+
+// ===== HydroCpp Includes ===== //
+#include "HCBench.hpp"
+#include "HCHalfPlaneClip.hpp"
+#include "HCHullGenerator.hpp"
+#include "HCLoader.hpp"
+#include "HCLog.hpp"
+#include "HCPolygon.hpp"
+#include "HCPolygonSplitter.hpp"
+#include "HCSectionShape.hpp"
+
+// ===== Config Includes ===== //
+#include "HydroCppConfig.h"
+
+
+using namespace std;
+using namespace HydroCpp;
+
+namespace
+{
+    const double    BREADTH     = 20.0;
+    const double    DEPTH       = 8.0;
+    const double    LENGTH      = 100.0;
+    const double    HEEL        = 20.0;     // angle of the heeled lines, in degrees
+
+    const char* const LOADER_BENCHMARKS[] = {
+        "loader/waterline/upright", "loader/waterline/heeled", "loader/hydro_table",
+        "loader/hydro_table/adaptive", "loader/hydro_table/float", "loader/hydro_table/general",
+        "loader/kn_datas", "loader/kn_datas/float", "loader/kn_datas/general",
+        "loader/equilibrium", "loader/write_workbook" };
+
+    // Tolerance of the adaptive hydrostatic table benchmark
+    const double    ADAPTIVE_TOL = 1e-6;
+
+    // Loading conditions solved by each operation of the equilibrium benchmark
+    const size_t    EQUILIBRIUM_CONDITIONS = 100;
+
+    /**
+     * @brief points of a closed outline, each edge subdivided so that
+     * the ring has about n vertices
+     */
+    vector<HCPoint> densify(const vector<HCPoint>& outline, size_t n)
+    {
+        double perimeter = 0.0;
+        for (size_t i = 0; i < outline.size(); ++i)
+            perimeter += outline[i].distanceTo(outline[(i + 1) % outline.size()]);
+
+        vector<HCPoint> res;
+        for (size_t i = 0; i < outline.size(); ++i) {
+            const HCPoint& a = outline[i];
+            const HCPoint& b = outline[(i + 1) % outline.size()];
+            size_t k = max<size_t>(1, static_cast<size_t>(std::round(n * a.distanceTo(b) / perimeter)));
+            for (size_t j = 0; j < k; ++j) {
+                double t = static_cast<double>(j) / static_cast<double>(k);
+                res.push_back(HCPoint(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)));
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief convex section: box with round bilges, counterclockwise
+     */
+    vector<HCPoint> convexSection(size_t n)
+    {
+        const double r = 2.0;
+        const size_t nArc = 16;
+        vector<HCPoint> outline;
+        outline.push_back(HCPoint(-BREADTH / 2, DEPTH));
+        // down the port side, along the bottom, up the starboard side
+        for (double cy : { -BREADTH / 2 + r, BREADTH / 2 - r }) {
+            double a0 = cy < 0 ? M_PI : 1.5 * M_PI;
+            for (size_t j = 0; j <= nArc; ++j) {
+                double a = a0 + M_PI / 2 * static_cast<double>(j) / static_cast<double>(nArc);
+                outline.push_back(HCPoint(cy + r * cos(a), r + r * sin(a)));
+            }
+        }
+        outline.push_back(HCPoint(BREADTH / 2, DEPTH));
+        return densify(outline, n);
+    }
+
+    /**
+     * @brief re-entrant section: catamaran, two hulls under a tunnel
+     */
+    vector<HCPoint> reentrantSection(size_t n)
+    {
+        const double hull = 4.0;
+        const double tunnel = 5.0;
+        vector<HCPoint> outline = {
+            HCPoint(-BREADTH / 2, 0.0), HCPoint(-BREADTH / 2 + hull, 0.0),
+            HCPoint(-BREADTH / 2 + hull, tunnel), HCPoint(BREADTH / 2 - hull, tunnel),
+            HCPoint(BREADTH / 2 - hull, 0.0), HCPoint(BREADTH / 2, 0.0),
+            HCPoint(BREADTH / 2, DEPTH), HCPoint(-BREADTH / 2, DEPTH) };
+        return densify(outline, n);
+    }
+
+    /**
+     * @brief waterline at a draught, upright or heeled, wet side on the right
+     */
+    pair<HCPoint,HCPoint> waterline(double draught, double heel)
+    {
+        const double half = 1000.0;
+        double t = tan(heel * M_PI / 180);
+        return make_pair(HCPoint(-half, draught - half * t), HCPoint(half, draught + half * t));
+    }
+
+    /**
+     * @brief write a box barge, with its parameters and closed form
+     * hydrostatics
+     */
+    string writeHull(const filesystem::path& dir, size_t nStations, size_t nVertices)
+    {
+        HCHullSpec spec;
+        spec.length = LENGTH;
+        spec.breadth = BREADTH;
+        spec.depth = DEPTH;
+        spec.stations = nStations;
+        spec.vertices = nVertices;
+        HCHullGenerator generator(spec);
+
+        HCParams params = generator.getDefaultParams();
+        params.parse("max_wl=6");
+        params.parse("delta_wl=0.05");
+
+        string file = (dir / "HydroCppBench.hcb").string();
+        generator.write(file, params);
+        generator.writeReference(file, params);
+        return file;
+    }
+
+    /**
+     * @brief read a reference file, CSV with a header line
+     * @return the values column by column, empty if the file doesn't exist
+     */
+    vector<vector<double>> readReference(const string& file, vector<string>& names)
+    {
+        vector<vector<double>> columns;
+        ifstream in(file);
+        string line;
+        if (!getline(in, line))
+            return columns;
+
+        stringstream header(line);
+        string name;
+        names.clear();
+        while (getline(header, name, ','))
+            names.push_back(name);
+        columns.resize(names.size());
+
+        while (getline(in, line)) {
+            stringstream row(line);
+            string value;
+            for (size_t c = 0; c < columns.size() && getline(row, value, ','); ++c)
+                columns[c].push_back(stod(value));
+        }
+        return columns;
+    }
+
+    /**
+     * @brief compare the hydrostatic table of the loader to the closed
+     * form one of its hull, if any (see HCHullGenerator)
+     * @param prefix of the accuracy entries
+     */
+    void checkHydroAccuracy(HCBench& bench, const HCLoader& ld, const string& hull,
+                            const string& prefix)
+    {
+        // Draught then the columns of the hydrostatic curves, in order
+        vector<string> names;
+        auto hydro = readReference(HCHullGenerator::getHydroReferenceName(hull), names);
+        const HCCurves& curves = ld.getHydroCurves();
+        if (hydro.size() == 1 + HC_NB_COLUMNS && !curves.empty()) {
+            for (size_t c = 0; c < HC_NB_COLUMNS; ++c) {
+                vector<double> computed;
+                for (double draught : hydro[0])
+                    computed.push_back(curves.interpolate(c, draught));
+                bench.addAccuracy(prefix + "/" + names[c + 1], computed, hydro[c + 1]);
+            }
+        }
+    }
+
+    /**
+     * @brief compare the tables of the loader to the closed form
+     * hydrostatics of its hull, if any (see HCHullGenerator)
+     */
+    void checkAccuracy(HCBench& bench, const HCLoader& ld, const string& hull)
+    {
+        checkHydroAccuracy(bench, ld, hull, "accuracy/hydro");
+
+        // Angle, displacement, draught, KNsin
+        vector<string> names;
+        auto kn = readReference(HCHullGenerator::getKNReferenceName(hull), names);
+        if (kn.size() == 4 && ld.getKNTable().getAngleCount() > 0) {
+            vector<double> computed;
+            for (size_t i = 0; i < kn[0].size(); ++i)
+                computed.push_back(ld.getKNTable().getKNsin(kn[0][i], kn[1][i]));
+            bench.addAccuracy("accuracy/kn/KNsin", computed, kn[3]);
+        }
+    }
+
+    void printUsage()
+    {
+        HCLogInfo("Usage: HydroCppBench [options]");
+        HCLogInfo("  --filter TEXT       run only the benchmarks whose name contains TEXT");
+        HCLogInfo("  --min-time S        min duration of a repetition in seconds (default: 0.5)");
+        HCLogInfo("  --repetitions N     number of timed repetitions (default: 5)");
+        HCLogInfo("  --hull FILE         hull of the loader benchmarks (workbook, .csv or .hcb),");
+        HCLogInfo("                      default: a generated box barge of 200 stations. The");
+        HCLogInfo("                      tables are checked against the closed form ones, if any");
+        HCLogInfo("  --vertices N        vertices of the generated sections (default: 64)");
+        HCLogInfo("  -t, --threads N     threads of the loader benchmarks (default: 1)");
+        HCLogInfo("  -o, --output FILE   JSON report (default: HydroCppBench.json)");
+    }
+
+    void benchPolygons(HCBench& bench, size_t nVertices)
+    {
+        const pair<const char*, vector<HCPoint>> shapes[] = {
+            { "convex", convexSection(nVertices) },
+            { "reentrant", reentrantSection(nVertices) } };
+
+        for (const auto& [shape, vertices] : shapes) {
+            const double n = static_cast<double>(vertices.size());
+
+            bench.run(string("polygon/compute/") + shape, "vertices", n, [&](uint64_t ops){
+                for (uint64_t i = 0; i < ops; ++i)
+                    HCBench::keep(HCPolygon::computeMoments(vertices.data(), vertices.size()));
+            });
+
+            bench.run(string("polygon/triangulate/") + shape, "vertices", n, [&](uint64_t ops){
+                HCPolygon polygon(vertices);
+                for (uint64_t i = 0; i < ops; ++i)
+                    HCBench::keep(polygon.computeByTriangulation());
+            });
+
+            bench.run(string("polygon/ear_clip/") + shape, "vertices", n, [&](uint64_t ops){
+                vector<array<uint32_t, 3>> triangles;
+                for (uint64_t i = 0; i < ops; ++i) {
+                    HCPolygon::triangulate(vertices.data(), vertices.size(), triangles);
+                    HCBench::keep(triangles.size());
+                }
+            });
+
+            // Same clip in both precisions, the float vertices rounded once
+            vector<HCPointF> floatVertices(vertices.begin(), vertices.end());
+            auto line = waterline(3.0, 0.0);
+            pair<HCPointF,HCPointF> floatLine(HCPointF(line.first), HCPointF(line.second));
+            bench.run(string("clip/double/") + shape, "vertices", n, [&](uint64_t ops){
+                HCSectionCut cut;
+                for (uint64_t i = 0; i < ops; ++i) {
+                    HCBench::keep(HCHalfPlaneClip::cutSection(vertices.data(), vertices.size(),
+                                                            line, 3.0, cut));
+                    HCBench::keep(cut.area);
+                }
+            });
+            bench.run(string("clip/float/") + shape, "vertices", n, [&](uint64_t ops){
+                HCSectionCut cut;
+                for (uint64_t i = 0; i < ops; ++i) {
+                    HCBench::keep(HCHalfPlaneClip::cutSection(floatVertices.data(),
+                                                    floatVertices.size(), floatLine, 3.0, cut));
+                    HCBench::keep(cut.area);
+                }
+            });
+            bench.run(string("clip/horizontal/") + shape, "vertices", n, [&](uint64_t ops){
+                HCSectionCut cut;
+                for (uint64_t i = 0; i < ops; ++i) {
+                    HCBench::keep(HCHalfPlaneClip::cutSection<double, HCHorizontalLine>(
+                                        vertices.data(), vertices.size(), line, 3.0, cut));
+                    HCBench::keep(cut.area);
+                }
+            });
+
+            // Kernel of the shape, none for the re-entrant section
+            HCSectionShape sectionShape(vertices.data(), vertices.size());
+            if (sectionShape.getShape() != HCShape::General) {
+                bench.run(string("clip/shape/") + shape, "vertices", n, [&](uint64_t ops){
+                    HCSectionCut cut;
+                    for (uint64_t i = 0; i < ops; ++i) {
+                        HCBench::keep(sectionShape.cut<HCHorizontalLine>(vertices.data(),
+                                                                        line, 3.0, cut));
+                        HCBench::keep(cut.area);
+                    }
+                });
+            }
+
+            // Waterline through a side vertex, above the tunnel roof: the
+            // triangles of the section instead of the splitter
+            auto side = find_if(vertices.begin(), vertices.end(), [](const HCPoint& P){
+                return P.y > 0.6 * DEPTH && P.y < DEPTH;
+            });
+            if (side != vertices.end()) {
+                auto onVertex = waterline(side->y, 0.0);
+                bench.run(string("clip/triangles/") + shape, "vertices", n, [&](uint64_t ops){
+                    HCSectionCut cut;
+                    for (uint64_t i = 0; i < ops; ++i) {
+                        HCBench::keep(sectionShape.cutTriangles<HCHorizontalLine>(vertices.data(),
+                                                                        onVertex, side->y, cut));
+                        HCBench::keep(cut.area);
+                    }
+                });
+                bench.run(string("splitter/on_vertex/") + shape, "vertices", n, [&](uint64_t ops){
+                    HCPolygonSplitter split;
+                    for (uint64_t i = 0; i < ops; ++i) {
+                        split.reset(vertices.data(), vertices.size(), onVertex);
+                        HCBench::keep(split.getMomentsFromSide(LineSide::Right));
+                        HCBench::keep(split.getEdges().size());
+                    }
+                });
+            }
+
+            for (double heel : { 0.0, HEEL }) {
+                // Below the tunnel roof, the re-entrant section has 2 wet parts
+                auto line = waterline(3.0, heel);
+                string name = string("splitter/") + (heel == 0.0 ? "upright/" : "heeled/") + shape;
+                bench.run(name, "vertices", n, [&](uint64_t ops){
+                    HCPolygonSplitter split;
+                    for (uint64_t i = 0; i < ops; ++i) {
+                        split.reset(vertices.data(), vertices.size(), line);
+                        HCBench::keep(split.getMomentsFromSide(LineSide::Right));
+                        HCBench::keep(split.getEdges().size());
+                    }
+                });
+            }
+        }
+    }
+
+    void benchLoader(HCBench& bench, const string& hull, unsigned threads,
+                    const filesystem::path& dir)
+    {
+        HCLoader ld(hull);
+        ld.setThreadCount(threads);
+        ld.setOutput((dir / "HydroCppBench.xlsx").string());
+
+        // Sizes of the tables, and a draught within the hull
+        ld.computeHydroTable();
+        ld.computeKNdatas();
+        const HCCurves& curves = ld.getHydroCurves();
+        if (curves.empty()) {
+            HCLogError("No hydrostatic data for " + hull + ", loader benchmarks skipped");
+            return;
+        }
+        checkAccuracy(bench, ld, hull);
+        const double draught = curves.getAbscissa(curves.size() / 2);
+        const double rows = static_cast<double>(curves.size());
+        double knRows = 0.0;
+        const HCKNTable& kn = ld.getKNTable();
+        for (size_t a = 0; a < kn.getAngleCount(); ++a)
+            knRows += static_cast<double>(kn.getCurves(a).size());
+
+        for (double heel : { 0.0, HEEL }) {
+            auto line = waterline(draught, heel);
+            string name = string("loader/waterline/") + (heel == 0.0 ? "upright" : "heeled");
+            bench.run(name, "waterlines", 1.0, [&](uint64_t ops){
+                for (uint64_t i = 0; i < ops; ++i)
+                    HCBench::keep(ld.computeHydroFromWaterline(line));
+            });
+        }
+
+        bench.run("loader/hydro_table", "rows", rows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeHydroTable();
+        });
+
+        // Same table, most rows interpolated
+        ld.setAdaptiveTolerance(ADAPTIVE_TOL);
+        bench.run("loader/hydro_table/adaptive", "rows", rows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeHydroTable();
+        });
+        ld.computeHydroTable();
+        checkHydroAccuracy(bench, ld, hull, "accuracy/adaptive/hydro");
+        ld.setAdaptiveTolerance(0.0);
+        ld.computeHydroTable();
+
+        bench.run("loader/kn_datas", "rows", knRows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeKNdatas();
+        });
+
+        // Single precision vertices, compared to the double tables
+        vector<vector<double>> hydroColumns(HC_NB_COLUMNS);
+        for (size_t c = 0; c < HC_NB_COLUMNS; ++c)
+            for (size_t i = 0; i < curves.size(); ++i)
+                hydroColumns[c].push_back(curves.getValue(c, i));
+        vector<double> knValues;
+        for (size_t a = 0; a < kn.getAngleCount(); ++a)
+            for (size_t i = 0; i < kn.getCurves(a).size(); ++i)
+                knValues.push_back(kn.getCurves(a).getValue(HCKNTable::KNSIN, i));
+
+        ld.setScalar(HCScalar::Float);
+        bench.run("loader/hydro_table/float", "rows", rows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeHydroTable();
+        });
+        bench.run("loader/kn_datas/float", "rows", knRows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeKNdatas();
+        });
+        ld.computeHydroTable();
+        ld.computeKNdatas();
+        checkHydroAccuracy(bench, ld, hull, "accuracy/float/hydro");
+
+        // The transverse values of a symmetric hull are about zero, their
+        // errors are relative to the largest KN
+        double transverse = 0.0;
+        for (double v : knValues)
+            transverse = max(transverse, fabs(v));
+        const vector<string> columnNames = { "Volume", "Displacement", "Immersion", "MCT",
+                "LCB", "TCB", "LCF", "KMT", "WaterplaneArea", "RMT", "RML", "VCB", "Lpp" };
+        for (size_t c = 0; c < HC_NB_COLUMNS; ++c) {
+            vector<double> computed;
+            for (size_t i = 0; i < ld.getHydroCurves().size(); ++i)
+                computed.push_back(ld.getHydroCurves().getValue(c, i));
+            bench.addAccuracy("accuracy/float_vs_double/hydro/" + columnNames[c],
+                                computed, hydroColumns[c], c == HC_TCB ? transverse : 0.0);
+        }
+        vector<double> knFloat;
+        const HCKNTable& knF = ld.getKNTable();
+        for (size_t a = 0; a < knF.getAngleCount(); ++a)
+            for (size_t i = 0; i < knF.getCurves(a).size(); ++i)
+                knFloat.push_back(knF.getCurves(a).getValue(HCKNTable::KNSIN, i));
+        bench.addAccuracy("accuracy/float_vs_double/kn/KNsin", knFloat, knValues, transverse);
+        ld.setScalar(HCScalar::Double);
+
+        // Every section cut by the general clip, instead of the kernel of its shape
+        ld.setShapeKernels(false);
+        bench.run("loader/hydro_table/general", "rows", rows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeHydroTable();
+        });
+        bench.run("loader/kn_datas/general", "rows", knRows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.computeKNdatas();
+        });
+        ld.setShapeKernels(true);
+        ld.computeHydroTable();
+        ld.computeKNdatas();
+
+        // Conditions of the middle half of the table: upright ones, the
+        // centre of gravity above the centre of buoyancy, half way to the
+        // metacentre, and ones shifted to trim and heel
+        vector<HCLoadCondition> upright, shifted;
+        vector<double> draughts;
+        for (size_t k = 0; k < EQUILIBRIUM_CONDITIONS; ++k) {
+            size_t i = curves.size() / 4 + k * (curves.size() / 2) / EQUILIBRIUM_CONDITIONS;
+            HCLoadCondition c;
+            c.displacement = curves.getValue(HC_DISPLACEMENT, i);
+            c.LCG = curves.getValue(HC_LCB, i);
+            c.TCG = curves.getValue(HC_TCB, i);
+            c.VCG = (curves.getValue(HC_VCB, i) + curves.getValue(HC_KMT, i)) / 2;
+            upright.push_back(c);
+            draughts.push_back(curves.getAbscissa(i));
+
+            c.LCG += 0.005 * curves.getValue(HC_LPP, i) * (static_cast<double>(k % 5) - 2);
+            c.TCG += 0.1 * (static_cast<double>(k % 7) - 3);
+            shifted.push_back(c);
+        }
+        vector<double> solved;
+        for (const auto& p : ld.solveEquilibrium(upright))
+            solved.push_back(p.converged ? p.draught : HCCurves::NOT_AVAILABLE);
+        bench.addAccuracy("accuracy/equilibrium/draught", solved, draughts);
+
+        bench.run("loader/equilibrium", "conditions", static_cast<double>(shifted.size()),
+                    [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                HCBench::keep(ld.solveEquilibrium(shifted).size());
+        });
+
+        // Writes a file, a few iterations are enough
+        bench.run("loader/write_workbook", "rows", rows + knRows, [&](uint64_t ops){
+            for (uint64_t i = 0; i < ops; ++i)
+                ld.writeToWorkbook();
+        }, 20);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    string filter;
+    double minTime = 0.5;
+    unsigned repetitions = 5;
+    string hull;
+    size_t nVertices = 64;
+    unsigned threads = 1;
+    string output = "HydroCppBench.json";
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            HCLogError("Unknown option or missing value for " + arg);
+            printUsage();
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--filter")
+            filter = value;
+        else if (arg == "--min-time")
+            minTime = stod(value);
+        else if (arg == "--repetitions")
+            repetitions = static_cast<unsigned>(stoul(value));
+        else if (arg == "--hull")
+            hull = value;
+        else if (arg == "--vertices")
+            nVertices = max<size_t>(8, stoul(value));
+        else if (arg == "-t" || arg == "--threads")
+            threads = static_cast<unsigned>(stoul(value));
+        else if (arg == "-o" || arg == "--output")
+            output = value;
+        else {
+            HCLogError("Unknown option " + arg);
+            printUsage();
+            return 1;
+        }
+    }
+
+    const string version = to_string(HydroCpp_VERSION_MAJOR) + "." + to_string(HydroCpp_VERSION_MINOR)
+                            + "." + to_string(HydroCpp_VERSION_PATCH);
+    HCLogInfo("HydroCppBench v" + version);
+
+    error_code ec;
+    filesystem::path dir = filesystem::temp_directory_path(ec) / "HydroCppBench";
+    filesystem::create_directories(dir, ec);
+
+    try {
+        HCBench bench(minTime, repetitions, filter);
+        benchPolygons(bench, nVertices);
+        bool loader = false;
+        for (const char* name : LOADER_BENCHMARKS)
+            loader = loader || bench.isSelected(name);
+        if (loader) {
+            if (hull.empty())
+                hull = writeHull(dir, 200, nVertices);
+            benchLoader(bench, hull, threads, dir);
+        }
+
+        ofstream out(output);
+        bench.writeJson(out, version);
+        if (!out) {
+            HCLogError("Unable to write " + output);
+            return 1;
+        }
+        HCLogInfo("Results saved in " + output);
+    } catch (const std::exception& e) {
+        HCLogError(e.what());
+        return 1;
+    }
+
+    return 0;
+}
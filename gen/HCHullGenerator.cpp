@@ -0,0 +1,399 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+#define _USE_MATH_DEFINES
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+// ===== External Includes ===== //
+#include <OpenXLSX.hpp>
+
+// ===== HydroCpp Includes ===== //
+#include "HCHullGenerator.hpp"
+#include "HCConfig.hpp"
+#include "HCHullFile.hpp"
+#include "HCSheetWriter.hpp"
+
+using namespace HydroCpp;
+using namespace OpenXLSX;
+
+namespace
+{
+    const char*     HULL_SHEET_NAME = "Hullform";
+
+    const double    RAKE_HEIGHT     = 0.6;  // bottom height at the ends, fraction of the depth
+    const double    BILGE_HEIGHT    = 0.4;  // multi-chine bilge, fraction of the depth
+    const double    RECESS_BOTTOM   = 0.45; // recess of the sides, fractions of the depth
+    const double    RECESS_TOP      = 0.75;
+    const double    RECESS_DEPTH    = 0.25; // fraction of the half breadth
+    const double    TUNNEL_WIDTH    = 0.4;  // fraction of the breadth
+    const double    TUNNEL_HEIGHT   = 0.3;  // fraction of the depth
+
+    std::string format(double value)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.17g", value);
+        return buf;
+    }
+
+    /**
+     * @brief point of the segment [a, b], a for t = 0 and b for t = 1
+     */
+    HCPoint lerp(const HCPoint& a, const HCPoint& b, double t)
+    {
+        return HCPoint(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y));
+    }
+}
+
+HCHullGenerator::HCHullGenerator(const HCHullSpec& spec):m_spec(spec)
+{
+    if (!(m_spec.length > 0 && m_spec.breadth > 0 && m_spec.depth > 0))
+        throw std::invalid_argument("The length, breadth and depth shall be positive");
+    if (m_spec.stations < 2)
+        throw std::invalid_argument("The hull shall have 2 stations at least");
+    if (m_spec.vertices < 4)
+        throw std::invalid_argument("The sections shall have 4 vertices at least");
+    if (m_spec.chines < 1)
+        throw std::invalid_argument("The sections shall have 1 chine at least");
+    if (!(m_spec.rake >= 0 && m_spec.rake <= 0.5))
+        throw std::invalid_argument("The raked length shall be between 0 and 0.5");
+
+    const double dx = m_spec.length / static_cast<double>(m_spec.stations);
+    for (size_t i = 0; i < m_spec.stations; ++i) {
+        std::vector<HCPoint> half = getHalfSection((static_cast<double>(i) + 0.5)
+                                                    / static_cast<double>(m_spec.stations));
+        if (m_spec.reentrant)
+            addRecess(half);
+        if (m_spec.tunnel)
+            addTunnel(half);
+        m_sections[static_cast<double>(i) * dx] = getSection(half);
+    }
+}
+
+HCHullGenerator::~HCHullGenerator() = default;
+
+const std::map<double,std::vector<HCPoint>>& HCHullGenerator::getSections() const
+{
+    return m_sections;
+}
+
+HCParams HCHullGenerator::getDefaultParams() const
+{
+    const double maxWl = 0.9 * m_spec.depth;
+    const double maxDispl = D_SW_DEF * m_spec.length * m_spec.breadth * maxWl;
+
+    HCParams params;
+    params.set(MAX_WL_NAME, maxWl);
+    params.set(DELTA_WL_NAME, m_spec.depth / 100);
+    params.set(MAX_ANGLE_NAME, MAX_ANGLE_DEF);
+    params.set(DELTA_ANGLE_NAME, DELTA_ANGLE_DEF);
+    params.set(MAX_DISPL_NAME, maxDispl);
+    params.set(DELTA_DISPL_NAME, maxDispl / 200);
+    params.set(D_SW_NAME, D_SW_DEF);
+    return params;
+}
+
+bool HCHullGenerator::hasReference() const
+{
+    return m_spec.shape == HCHullShape::Box && !m_spec.reentrant && !m_spec.tunnel;
+}
+
+void HCHullGenerator::write(const std::string& filename, const HCParams& params) const
+{
+    switch (HCHullFile::getFormat(filename)) {
+    case HCHullFormat::Workbook:
+        writeWorkbook(filename);
+        break;
+    case HCHullFormat::CSV:
+        writeCSV(filename);
+        break;
+    case HCHullFormat::Binary:
+        HCHullFile::writeBinary(filename, HCHull(m_sections));
+        break;
+    }
+    params.writeFile(HCParams::getSidecarName(filename));
+}
+
+bool HCHullGenerator::writeReference(const std::string& filename, const HCParams& params) const
+{
+    if (!hasReference())
+        return false;
+
+    const double L = m_spec.length;
+    const double B = m_spec.breadth;
+    const double D = m_spec.depth;
+    const double rho = params.get(D_SW_NAME, D_SW_DEF);
+    const double maxWl = params.get(MAX_WL_NAME, MAX_WL_DEF);
+    const double deltaWl = params.get(DELTA_WL_NAME, DELTA_WL_DEF);
+    const double deltaAngle = params.get(DELTA_ANGLE_NAME, DELTA_ANGLE_DEF);
+    const double deltaDispl = params.get(DELTA_DISPL_NAME, DELTA_DISPL_DEF);
+    // Before any file is opened, a null step would write rows forever
+    if (!(deltaWl > 0 && deltaAngle > 0 && deltaDispl > 0 && rho > 0))
+        throw std::invalid_argument("The steps and the density shall be positive");
+
+    // Same draughts as HCLoader::computeHydroTable, below the deck
+    std::string hydroFile = getHydroReferenceName(filename);
+    std::ofstream hydro(hydroFile);
+    hydro << "Draught,Volume,Displacement,Immersion,MCT,LCB,TCB,LCF,KMT,"
+             "WaterplaneArea,RMT,RML,VCB,Lpp\n";
+    for (double T = deltaWl; T <= maxWl && T < D; T += deltaWl) {
+        const double volume = L * B * T;
+        const double displ = rho * volume;
+        const double area = L * B;
+        const double RMT = L * B * B * B / 12 / displ;
+        const double RML = B * L * L * L / 12 / displ;
+        const double values[] = {
+            T, volume, displ, area * rho / 100, displ * RML / (100 * L),
+            L / 2, 0.0, L / 2, T / 2 + RMT, area, RMT, RML, T / 2, L };
+        for (size_t c = 0; c < sizeof(values) / sizeof(values[0]); ++c)
+            hydro << (c == 0 ? "" : ",") << format(values[c]);
+        hydro << "\n";
+    }
+    hydro.close();
+    if (!hydro)
+        throw std::runtime_error("Unable to write " + hydroFile);
+
+    // Same angles and displacements as the KN table, wall sided formula
+    // KN = sin(phi) (KB + BM (1 + tan(phi)^2 / 2)) while it holds
+    const double maxAngle = params.get(MAX_ANGLE_NAME, MAX_ANGLE_DEF);
+    const double lastX = m_sections.empty() ? 0.0 : m_sections.rbegin()->first;
+    const double maxDispl = params.get(MAX_DISPL_NAME, lastX * B * maxWl);
+
+    std::string knFile = getKNReferenceName(filename);
+    std::ofstream kn(knFile);
+    kn << "Angle,Displacement,Draught,KNsin\n";
+    for (double angle = deltaAngle; angle <= maxAngle; angle += deltaAngle) {
+        const double phi = angle * M_PI / 180;
+        const double halfRise = B / 2 * tan(phi);
+        for (double displ = 10 * deltaDispl; displ < maxDispl; displ += deltaDispl) {
+            const double T = displ / (rho * L * B);
+            if (T - halfRise < 0 || T + halfRise > D)
+                continue;
+            const double BM = B * B / (12 * T);
+            const double KN = sin(phi) * (T / 2 + BM * (1 + tan(phi) * tan(phi) / 2));
+            kn << format(angle) << "," << format(displ) << "," << format(T) << ","
+               << format(KN) << "\n";
+        }
+    }
+    kn.close();
+    if (!kn)
+        throw std::runtime_error("Unable to write " + knFile);
+    return true;
+}
+
+std::string HCHullGenerator::getHydroReferenceName(const std::string& hullFile)
+{
+    return std::filesystem::path(hullFile).replace_extension(".hydro.ref").string();
+}
+
+std::string HCHullGenerator::getKNReferenceName(const std::string& hullFile)
+{
+    return std::filesystem::path(hullFile).replace_extension(".kn.ref").string();
+}
+
+bool HCHullGenerator::parseShape(const std::string& name, HCHullShape& shape)
+{
+    if (name == "box")
+        shape = HCHullShape::Box;
+    else if (name == "raked")
+        shape = HCHullShape::Raked;
+    else if (name == "wigley")
+        shape = HCHullShape::Wigley;
+    else if (name == "chine")
+        shape = HCHullShape::MultiChine;
+    else
+        return false;
+    return true;
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+std::vector<HCPoint> HCHullGenerator::getHalfSection(double xi) const
+{
+    const double halfB = m_spec.breadth / 2;
+    const double D = m_spec.depth;
+    std::vector<HCPoint> half;
+
+    switch (m_spec.shape) {
+    case HCHullShape::Box:
+        half = { HCPoint(0.0, 0.0), HCPoint(halfB, 0.0), HCPoint(halfB, D) };
+        break;
+
+    case HCHullShape::Raked: {
+        double keel = 0.0;
+        if (xi < m_spec.rake)
+            keel = RAKE_HEIGHT * D * (1 - xi / m_spec.rake);
+        else if (xi > 1 - m_spec.rake)
+            keel = RAKE_HEIGHT * D * (xi - (1 - m_spec.rake)) / m_spec.rake;
+        half = { HCPoint(0.0, keel), HCPoint(halfB, keel), HCPoint(halfB, D) };
+        break;
+    }
+
+    case HCHullShape::Wigley: {
+        const double s = 2 * xi - 1;
+        const double width = halfB * (1 - s * s);
+        const size_t n = std::max<size_t>(2, m_spec.vertices / 2);
+        for (size_t j = 0; j <= n; ++j) {
+            const double zeta = 1 - static_cast<double>(j) / static_cast<double>(n);
+            half.push_back(HCPoint(width * (1 - zeta * zeta), D * (1 - zeta)));
+        }
+        break;
+    }
+
+    case HCHullShape::MultiChine: {
+        // Chines on a quarter ellipse, from the keel to the bilge
+        const double bilge = BILGE_HEIGHT * D;
+        for (size_t j = 0; j <= m_spec.chines; ++j) {
+            const double theta = M_PI / 2 * static_cast<double>(j) / static_cast<double>(m_spec.chines);
+            half.push_back(HCPoint(halfB * sin(theta), bilge * (1 - cos(theta))));
+        }
+        half.push_back(HCPoint(halfB, D));
+        break;
+    }
+    }
+    return half;
+}
+
+void HCHullGenerator::addRecess(std::vector<HCPoint>& half) const
+{
+    const double z1 = RECESS_BOTTOM * m_spec.depth;
+    const double z2 = RECESS_TOP * m_spec.depth;
+    if (half.front().y >= z1)
+        return; // bottom above the recess
+
+    // The half sections rise from the keel to the deck
+    std::vector<HCPoint> res;
+    for (size_t i = 0; i + 1 < half.size(); ++i) {
+        const HCPoint& a = half[i];
+        const HCPoint& b = half[i + 1];
+        if (a.y < z1)
+            res.push_back(a);
+        if (a.y < z1 && b.y >= z1) {
+            HCPoint p = lerp(a, b, (z1 - a.y) / (b.y - a.y));
+            res.push_back(p);
+            res.push_back(HCPoint((1 - RECESS_DEPTH) * p.x, z1));
+        }
+        if (a.y < z2 && b.y >= z2) {
+            HCPoint p = lerp(a, b, (z2 - a.y) / (b.y - a.y));
+            res.push_back(HCPoint((1 - RECESS_DEPTH) * p.x, z2));
+            res.push_back(p);
+        }
+        if (b.y > z2)
+            res.push_back(b);
+    }
+    half.swap(res);
+}
+
+void HCHullGenerator::addTunnel(std::vector<HCPoint>& half) const
+{
+    const double yt = TUNNEL_WIDTH * m_spec.breadth / 2;
+    const double zt = TUNNEL_HEIGHT * m_spec.depth;
+
+    // Inner side of the demi hull, where the bottom reaches the tunnel width
+    for (size_t i = 0; i + 1 < half.size(); ++i) {
+        const HCPoint& a = half[i];
+        const HCPoint& b = half[i + 1];
+        if (a.x <= yt && b.x > yt) {
+            HCPoint p = lerp(a, b, (yt - a.x) / (b.x - a.x));
+            if (p.y >= zt)
+                return; // the section is above the tunnel roof
+            std::vector<HCPoint> res = { HCPoint(0.0, zt), HCPoint(yt, zt), p };
+            res.insert(res.end(), half.begin() + static_cast<std::ptrdiff_t>(i + 1), half.end());
+            half.swap(res);
+            return;
+        }
+    }
+    // Section narrower than the tunnel, left as it is
+}
+
+std::vector<HCPoint> HCHullGenerator::getSection(const std::vector<HCPoint>& half) const
+{
+    // Starboard from the keel to the deck, then port back to the keel
+    std::vector<HCPoint> outline(half);
+    for (size_t i = half.size(); i-- > 0; ) {
+        if (half[i].x == 0.0)
+            continue; // on the centerline, already in
+        outline.push_back(HCPoint(-half[i].x, half[i].y));
+    }
+
+    // Each edge subdivided so that the ring has about n vertices
+    double perimeter = 0.0;
+    for (size_t i = 0; i < outline.size(); ++i)
+        perimeter += outline[i].distanceTo(outline[(i + 1) % outline.size()]);
+
+    const double n = static_cast<double>(m_spec.vertices);
+    std::vector<HCPoint> section;
+    for (size_t i = 0; i < outline.size(); ++i) {
+        const HCPoint& a = outline[i];
+        const HCPoint& b = outline[(i + 1) % outline.size()];
+        size_t k = std::max<size_t>(1, static_cast<size_t>(std::round(n * a.distanceTo(b) / perimeter)));
+        for (size_t j = 0; j < k; ++j)
+            section.push_back(lerp(a, b, static_cast<double>(j) / static_cast<double>(k)));
+    }
+    return section;
+}
+
+void HCHullGenerator::writeWorkbook(const std::string& filename) const
+{
+    // Columns of the tbl_Hullform table
+    std::vector<std::vector<double>> columns(3);
+    for (const auto& [x, section] : m_sections) {
+        for (const auto& p : section) {
+            columns[0].push_back(x);
+            columns[1].push_back(p.x);
+            columns[2].push_back(p.y);
+        }
+    }
+    const size_t nRows = columns[0].size();
+
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+
+    // The header and the table through OpenXLSX, the rows are streamed
+    XLDocument doc;
+    doc.create(filename);
+    XLWorkbook wb = doc.workbook();
+    auto wks = wb.addWorksheet(HULL_SHEET_NAME);
+    std::vector<XLCellValue> header;
+    header.emplace_back("x");
+    header.emplace_back("y");
+    header.emplace_back("z");
+    auto headerRow = wks.row(1);
+    headerRow.values() = header;
+    XLCellReference br(static_cast<uint32_t>(nRows + 1), 3);
+    auto tbl = wb.addTable(HULL_SHEET_NAME, HULL_TBL_NAME, "A1:" + br.address(false));
+    tbl.tableStyle().setStyle("TableStyleMedium2");
+    doc.save();
+    doc.close();
+
+    HCSheetWriter writer(filename);
+    writer.addSheet(HULL_SHEET_NAME, std::move(columns));
+    writer.write();
+}
+
+void HCHullGenerator::writeCSV(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    out << "x,y,z\n";
+    for (const auto& [x, section] : m_sections) {
+        const std::string sx = format(x);
+        for (const auto& p : section)
+            out << sx << "," << format(p.x) << "," << format(p.y) << "\n";
+    }
+    out.close();
+    if (!out)
+        throw std::runtime_error("Unable to write " + filename);
+}
@@ -0,0 +1,165 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <map>
+#include <string>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCHull.hpp"
+#include "HCParams.hpp"
+#include "HCPoint.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief shapes of the generated hulls
+     */
+    enum class HCHullShape
+    {
+        Box,        // rectangular sections, constant along the length
+        Raked,      // box with the bottom rising at both ends
+        Wigley,     // y = B/2 (1 - (2x/L - 1)^2) (1 - (1 - z/D)^2)
+        MultiChine  // hard chines on a quarter ellipse bilge
+    };
+
+    /**
+     * @brief parameters of a generated hull, lengths in m
+     */
+    struct HCHullSpec
+    {
+        HCHullShape shape       {HCHullShape::Box};
+        double      length      {100.0};
+        double      breadth     {20.0};
+        double      depth       {10.0};
+        size_t      stations    {100};
+        size_t      vertices    {32};   // per section, at least
+        size_t      chines      {3};    // per side, multi-chine
+        double      rake        {0.15}; // raked length at each end, fraction of the length
+        bool        reentrant   {false};// recess in each side
+        bool        tunnel      {false};// tunnel in the bottom, two demi hulls below it
+    };
+
+    /**
+     * @brief Generator of synthetic hulls, to study the scaling of the
+     * computation with the number of sections, of vertices per section
+     * and the waterline steps, and to stress the section cuts.
+     *
+     * The stations are evenly spaced, x = i L / N for i in [0, N), so
+     * that the elements of HydroCpp (from a station to the next one, the
+     * last one having the length of the previous one) cover [0, L]
+     * exactly. Each section is the one of the middle of its element.
+     *
+     * The box barge without feature has closed form hydrostatics, which
+     * are written as references next to the hull (writeReference), in the
+     * units and definitions of the HydroCpp tables: e.g. RMT and RML are
+     * the inertias divided by the displacement.
+     */
+    class HCHullGenerator
+    {
+    public:
+        /**
+         * @brief constructor
+         * @throw std::invalid_argument if the spec is not valid
+         */
+        explicit HCHullGenerator(const HCHullSpec& spec);
+
+        /**
+         * @brief destructor
+         */
+        ~HCHullGenerator();
+
+        /**
+         * @brief sections of the hull, key: x of the station, value:
+         * vertices (y, z) of the section, counterclockwise
+         */
+        const std::map<double,std::vector<HCPoint>>& getSections() const;
+
+        /**
+         * @brief default parameters of the computation for the hull:
+         * draughts up to 90% of the depth by 1% of the depth, and about
+         * 200 rows of KN table
+         */
+        HCParams getDefaultParams() const;
+
+        /**
+         * @brief return true if the hull has closed form hydrostatics
+         */
+        bool hasReference() const;
+
+        /**
+         * @brief write the hull, the format is given by the extension:
+         * workbook (.xlsx, tbl_Hullform table), CSV (.csv) or binary (.hcb),
+         * and the parameters in the sidecar file
+         * @throw std::runtime_error if the file can't be written
+         */
+        void write(const std::string& filename, const HCParams& params) const;
+
+        /**
+         * @brief write the closed form hydrostatic table (<stem>.hydro.ref)
+         * and KN table (<stem>.kn.ref) of the hull, at the draughts and
+         * displacements HydroCpp computes with the parameters. The KN are
+         * given while the deck edge and the bilge stay out of the water
+         * @param filename the hull file, giving the stem
+         * @return false if the hull has no closed form
+         * @throw std::invalid_argument if a step or the density is not
+         * positive, std::runtime_error if a file can't be written
+         */
+        bool writeReference(const std::string& filename, const HCParams& params) const;
+
+        /**
+         * @brief name of the hydrostatic reference of a hull file
+         */
+        static std::string getHydroReferenceName(const std::string& hullFile);
+
+        /**
+         * @brief name of the KN reference of a hull file
+         */
+        static std::string getKNReferenceName(const std::string& hullFile);
+
+        /**
+         * @brief shape from its name: box, raked, wigley, chine
+         * @return false if the name is unknown
+         */
+        static bool parseShape(const std::string& name, HCHullShape& shape);
+
+    private:
+        /**
+         * @brief half section, starboard side, from the keel on the
+         * centerline to the deck edge
+         * @param xi position along the length, 0 at aft, 1 at fore
+         */
+        std::vector<HCPoint> getHalfSection(double xi) const;
+
+        /**
+         * @brief narrow each side between 30% and 60% of the depth
+         */
+        void addRecess(std::vector<HCPoint>& half) const;
+
+        /**
+         * @brief lift the bottom in the middle of the section, between
+         * two demi hulls
+         */
+        void addTunnel(std::vector<HCPoint>& half) const;
+
+        /**
+         * @brief full section from its half, subdivided to the
+         * number of vertices of the spec
+         */
+        std::vector<HCPoint> getSection(const std::vector<HCPoint>& half) const;
+
+        void writeWorkbook(const std::string& filename) const;
+        void writeCSV(const std::string& filename) const;
+
+    private:
+        HCHullSpec                              m_spec;
+        std::map<double,std::vector<HCPoint>>   m_sections;
+    };
+
+}  // namespace std
@@ -0,0 +1,154 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <string>
+#include <vector>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCHullGenerator.hpp"
+#include "HCLog.hpp"
+
+// ===== Config Includes ===== //
+#include "HydroCppConfig.h"
+
+
+using namespace std;
+using namespace HydroCpp;
+
+namespace
+{
+    const size_t    MIN_STATIONS    = 10;
+    const size_t    MAX_STATIONS    = 10000;
+
+    void printUsage()
+    {
+        HCLogInfo("Usage: HydroCppGen [options] files");
+        HCLogInfo("  files            hulls to write, workbook (.xlsx), CSV (.csv) or binary (.hcb),");
+        HCLogInfo("                   each one with its .params sidecar");
+        HCLogInfo("  --shape NAME     box, raked, wigley or chine (default: box)");
+        HCLogInfo("  --length L       length in m (default: 100)");
+        HCLogInfo("  --breadth B      breadth in m (default: 20)");
+        HCLogInfo("  --depth D        depth in m (default: 10)");
+        HCLogInfo("  --stations N     number of stations, 10 to 10000 (default: 100)");
+        HCLogInfo("  --vertices N     vertices per section, at least (default: 32)");
+        HCLogInfo("  --chines N       chines per side of the chine shape (default: 3)");
+        HCLogInfo("  --rake F         raked length at each end of the raked shape, fraction");
+        HCLogInfo("                   of the length (default: 0.15)");
+        HCLogInfo("  --reentrant      recess the sides between 45% and 75% of the depth");
+        HCLogInfo("  --tunnel         tunnel in the bottom, 40% of the breadth, 30% of the depth");
+        HCLogInfo("  -p, --param NAME=VALUE  set a parameter of the sidecar (max_wl, delta_wl,");
+        HCLogInfo("                   phi_max, delta_phi, max_disp, delta_disp, rho_sw)");
+        HCLogInfo("  -h, --help       display this help");
+        HCLogInfo("The closed form hydrostatics of the box without feature are written");
+        HCLogInfo("beside each file, in <name>.hydro.ref and <name>.kn.ref");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    HCHullSpec spec;
+    HCParams params;
+    vector<string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (arg == "--reentrant") {
+            spec.reentrant = true;
+        } else if (arg == "--tunnel") {
+            spec.tunnel = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            if (i + 1 >= argc) {
+                HCLogError("Unknown option or missing value for " + arg);
+                printUsage();
+                return 1;
+            }
+            string value = argv[++i];
+            try {
+                if (arg == "--shape") {
+                    if (!HCHullGenerator::parseShape(value, spec.shape)) {
+                        HCLogError("Unknown shape " + value);
+                        return 1;
+                    }
+                } else if (arg == "--length")
+                    spec.length = stod(value);
+                else if (arg == "--breadth")
+                    spec.breadth = stod(value);
+                else if (arg == "--depth")
+                    spec.depth = stod(value);
+                else if (arg == "--stations")
+                    spec.stations = stoul(value);
+                else if (arg == "--vertices")
+                    spec.vertices = stoul(value);
+                else if (arg == "--chines")
+                    spec.chines = stoul(value);
+                else if (arg == "--rake")
+                    spec.rake = stod(value);
+                else if (arg == "-p" || arg == "--param") {
+                    if (!params.parse(value)) {
+                        HCLogError("Invalid value for " + arg);
+                        return 1;
+                    }
+                } else {
+                    HCLogError("Unknown option " + arg);
+                    printUsage();
+                    return 1;
+                }
+            } catch (const std::exception&) {
+                HCLogError("Invalid value for " + arg);
+                return 1;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        HCLogError("No file to write");
+        printUsage();
+        return 1;
+    }
+    if (spec.stations < MIN_STATIONS || spec.stations > MAX_STATIONS) {
+        HCLogError("The number of stations shall be between " + to_string(MIN_STATIONS)
+                    + " and " + to_string(MAX_STATIONS));
+        return 1;
+    }
+
+    HCLogInfo("HydroCppGen v" + to_string(HydroCpp_VERSION_MAJOR) + "." + to_string(HydroCpp_VERSION_MINOR)
+                + "." + to_string(HydroCpp_VERSION_PATCH));
+
+    try {
+        HCHullGenerator generator(spec);
+        HCParams fileParams = generator.getDefaultParams();
+        fileParams.merge(params);
+
+        size_t nVertices = 0;
+        for (const auto& [x, section] : generator.getSections())
+            nVertices += section.size();
+        HCLogInfo("Hull of " + to_string(spec.stations) + " stations, " + to_string(nVertices)
+                    + " vertices");
+
+        for (const auto& file : files) {
+            generator.write(file, fileParams);
+            HCLogInfo("Hull saved in " + file);
+            if (generator.writeReference(file, fileParams))
+                HCLogInfo("Closed form hydrostatics saved in "
+                            + HCHullGenerator::getHydroReferenceName(file) + " and "
+                            + HCHullGenerator::getKNReferenceName(file));
+        }
+    } catch (const std::exception& e) {
+        HCLogError(e.what());
+        return 1;
+    }
+
+    return 0;
+}
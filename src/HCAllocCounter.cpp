@@ -0,0 +1,96 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCAllocCounter.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    std::atomic<uint64_t>   s_totalAllocs   {0};
+    thread_local uint64_t   t_threadAllocs  = 0;
+}
+
+#ifdef HYDROCPP_COUNT_ALLOCS
+
+namespace
+{
+    inline void* countedAlloc(std::size_t size)
+    {
+        ++t_threadAllocs;
+        s_totalAllocs.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    inline void* countedAlignedAlloc(std::size_t size, std::align_val_t al)
+    {
+        ++t_threadAllocs;
+        s_totalAllocs.fetch_add(1, std::memory_order_relaxed);
+        std::size_t align = static_cast<std::size_t>(al);
+        // aligned_alloc requires a size multiple of the alignment
+        size = (size + align - 1) / align * align;
+        if (void* p = std::aligned_alloc(align, size ? size : align))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t al) { return countedAlignedAlloc(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedAlignedAlloc(size, al); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+bool HCAllocCounter::isEnabled()
+{
+    return true;
+}
+
+#else
+
+bool HCAllocCounter::isEnabled()
+{
+    return false;
+}
+
+#endif
+
+uint64_t HCAllocCounter::getThreadCount()
+{
+    return t_threadAllocs;
+}
+
+uint64_t HCAllocCounter::getTotalCount()
+{
+    return s_totalAllocs.load(std::memory_order_relaxed);
+}
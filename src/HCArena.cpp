@@ -0,0 +1,97 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cstdint>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCArena.hpp"
+
+using namespace HydroCpp;
+
+HCArena::Scope::Scope(HCArena& arena):
+    m_arena(arena),
+    m_mark(arena.mark())
+{ }
+
+HCArena::Scope::~Scope()
+{
+    m_arena.rewind(m_mark);
+}
+
+HCArena::HCArena(size_t chunkSize):
+    m_chunkSize(chunkSize)
+{ }
+
+HCArena::~HCArena() = default;
+
+HCArena& HCArena::local()
+{
+    thread_local HCArena arena;
+    return arena;
+}
+
+HCArena::Mark HCArena::mark() const
+{
+    return Mark { m_current, m_offset };
+}
+
+void HCArena::rewind(const Mark& mark)
+{
+    m_current = mark.chunk;
+    m_offset = mark.offset;
+}
+
+size_t HCArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& c : m_chunks)
+        capacity += c.size;
+    return capacity;
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+void* HCArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // The chunks after the current one are free: use the first large
+    // enough, or insert a new one before them, the order is kept for rewind
+    for (size_t c = m_current; ; ++c) {
+        if (c == m_chunks.size() || (c > m_current && m_chunks[c].size < bytes + alignment)) {
+            size_t size = std::max(m_chunkSize, bytes + alignment);
+            m_chunks.insert(m_chunks.begin() + static_cast<std::ptrdiff_t>(c),
+                            Chunk { std::make_unique<std::byte[]>(size), size });
+        }
+
+        Chunk& chunk = m_chunks[c];
+        size_t offset = c == m_current ? m_offset : 0;
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+        uintptr_t p = (base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (p + bytes <= base + chunk.size) {
+            m_current = c;
+            m_offset = p + bytes - base;
+            return reinterpret_cast<void*>(p);
+        }
+    }
+}
+
+void HCArena::do_deallocate(void*, size_t, size_t)
+{
+    // Monotonic, released by rewind
+}
+
+bool HCArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,297 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+
+// ===== External Includes ===== //
+#include <OpenXLSX.hpp>
+
+// ===== HydroCpp Includes ===== //
+#include "HCBatch.hpp"
+#include "HCLoader.hpp"
+#include "HCLog.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief a file travelling through the pipeline
+     */
+    struct BatchJob
+    {
+        size_t                      index;
+        std::unique_ptr<HCLoader>   loader;
+    };
+
+    /**
+     * @brief blocking FIFO with a capacity limit, so that the loader
+     * cannot get too far ahead of the compute workers
+     */
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue(size_t capacity) : m_capacity(capacity)
+        {}
+
+        void push(BatchJob&& job)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [&]{ return m_jobs.size() < m_capacity; });
+            m_jobs.push_back(std::move(job));
+            m_notEmpty.notify_one();
+        }
+
+        /**
+         * @return false when the queue is closed and drained
+         */
+        bool pop(BatchJob& job)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [&]{ return !m_jobs.empty() || m_closed; });
+            if (m_jobs.empty())
+                return false;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        size_t                  m_capacity;
+        std::deque<BatchJob>    m_jobs;
+        std::mutex              m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        bool                    m_closed    { false };
+    };
+
+    /**
+     * @brief match a file name against a pattern containing '*' and '?'
+     */
+    bool wildcardMatch(const std::string& name, const std::string& pattern)
+    {
+        size_t n = 0, p = 0;
+        size_t starP = std::string::npos, starN = 0;
+        while (n < name.size()) {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+                ++n;
+                ++p;
+            } else if (p < pattern.size() && pattern[p] == '*') {
+                starP = p++;
+                starN = n;
+            } else if (starP != std::string::npos) {
+                p = starP + 1;
+                n = ++starN;
+            } else
+                return false;
+        }
+        while (p < pattern.size() && pattern[p] == '*')
+            ++p;
+        return p == pattern.size();
+    }
+
+    std::string formatMs(double ms)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << ms << " ms";
+        return ss.str();
+    }
+}
+
+HCBatch::HCBatch(const std::vector<std::string>& files, unsigned workers,
+                const std::function<void(HCLoader&)>& setup)
+        : m_files(files), m_workers(workers), m_setup(setup)
+{
+    if (m_workers == 0)
+        m_workers = std::max(1u, std::thread::hardware_concurrency());
+}
+
+HCBatch::~HCBatch() = default;
+
+const std::vector<BatchResult>& HCBatch::getResults() const
+{
+    return m_results;
+}
+
+size_t HCBatch::run()
+{
+    m_results.assign(m_files.size(), BatchResult());
+    for (size_t i = 0; i < m_files.size(); ++i)
+        m_results[i].file = m_files[i];
+
+    unsigned workers = std::min<size_t>(m_workers, std::max<size_t>(m_files.size(), 1));
+    HCLogInfo("Batch processing of " + std::to_string(m_files.size()) + " file(s) with " +
+                std::to_string(workers) + " compute worker(s)");
+
+    auto tstart = Clock::now();
+
+    BoundedQueue toCompute(workers);
+    BoundedQueue toWrite(workers);
+
+    // Stage 1: read the workbooks
+    std::thread loader([&]{
+        for (size_t i = 0; i < m_files.size(); ++i) {
+            BatchResult& res = m_results[i];
+            auto t0 = Clock::now();
+            try {
+                BatchJob job { i, std::make_unique<HCLoader>(m_files[i]) };
+                res.loadMs = elapsedMs(t0);
+                toCompute.push(std::move(job));
+            } catch (const std::exception& e) {
+                res.loadMs = elapsedMs(t0);
+                res.error = std::string("load: ") + e.what();
+            }
+        }
+        toCompute.close();
+    });
+
+    // Stage 2: compute the tables
+    std::vector<std::thread> computePool;
+    for (unsigned w = 0; w < workers; ++w) {
+        computePool.emplace_back([&]{
+            BatchJob job;
+            while (toCompute.pop(job)) {
+                BatchResult& res = m_results[job.index];
+                auto t0 = Clock::now();
+                try {
+                    if (m_setup)
+                        m_setup(*job.loader);
+                    job.loader->computeHydroTable();
+                    job.loader->computeKNdatas();
+                    res.computeMs = elapsedMs(t0);
+                    toWrite.push(std::move(job));
+                } catch (const std::exception& e) {
+                    res.computeMs = elapsedMs(t0);
+                    res.error = std::string("compute: ") + e.what();
+                }
+            }
+        });
+    }
+
+    // Stage 3: save the results
+    std::thread writer([&]{
+        BatchJob job;
+        while (toWrite.pop(job)) {
+            BatchResult& res = m_results[job.index];
+            auto t0 = Clock::now();
+            try {
+                job.loader->writeToWorkbook();
+                res.isValid = true;
+            } catch (const std::exception& e) {
+                res.error = std::string("write: ") + e.what();
+            }
+            res.writeMs = elapsedMs(t0);
+            job.loader.reset();
+        }
+    });
+
+    loader.join();
+    for (auto& t : computePool)
+        t.join();
+    toWrite.close();
+    writer.join();
+
+    report(elapsedMs(tstart));
+
+    return std::count_if(m_results.begin(), m_results.end(),
+                        [](const BatchResult& r){ return !r.isValid; });
+}
+
+void HCBatch::report(double wallMs) const
+{
+    double load = 0.0, compute = 0.0, write = 0.0;
+    size_t failed = 0;
+
+    HCLogInfo("==========" );
+    for (const auto& r : m_results) {
+        load += r.loadMs;
+        compute += r.computeMs;
+        write += r.writeMs;
+        if (r.isValid) {
+            HCLogInfo(r.file + " : load " + formatMs(r.loadMs) +
+                        ", compute " + formatMs(r.computeMs) +
+                        ", write " + formatMs(r.writeMs));
+        } else {
+            ++failed;
+            HCLogError(r.file + " : FAILED (" + r.error + ")");
+        }
+    }
+    HCLogInfo("==========" );
+    HCLogInfo("Files: " + std::to_string(m_results.size()) + " processed, " +
+                std::to_string(failed) + " failed");
+    HCLogInfo("Cumulated stages: load " + formatMs(load) + ", compute " + formatMs(compute) +
+                ", write " + formatMs(write));
+    HCLogInfo("Wall time: " + formatMs(wallMs) + " (" +
+                formatMs(m_results.empty() ? 0.0 : wallMs / m_results.size()) + " per file)");
+}
+
+std::vector<std::string> HCBatch::expandPattern(const std::string& pattern)
+{
+    namespace fs = std::filesystem;
+
+    fs::path p(pattern);
+    std::string name = p.filename().string();
+    if (name.find_first_of("*?") == std::string::npos)
+        return { pattern };
+
+    fs::path dir = p.has_parent_path() ? p.parent_path() : fs::path(".");
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file() && wildcardMatch(entry.path().filename().string(), name))
+            files.push_back(p.has_parent_path() ? entry.path().string()
+                                                : entry.path().filename().string());
+    }
+    if (ec)
+        HCLogError("Unable to list directory " + dir.string() + ": " + ec.message());
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<std::string> HCBatch::readManifest(std::istream& in)
+{
+    std::vector<std::string> files;
+    std::string line;
+    while (std::getline(in, line)) {
+        // trim
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+        auto last = line.find_last_not_of(" \t\r");
+        line = line.substr(first, last - first + 1);
+        if (line[0] == '#')
+            continue;
+        files.push_back(line);
+    }
+    return files;
+}
@@ -0,0 +1,122 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCCurves.hpp"
+
+using namespace HydroCpp;
+
+HCCurves::HCCurves(size_t nColumns, bool toOrigin)
+        : m_columns(nColumns), m_toOrigin(toOrigin)
+{ }
+
+HCCurves::~HCCurves() = default;
+
+void HCCurves::clear()
+{
+    m_x.clear();
+    for (auto& c : m_columns)
+        c.clear();
+}
+
+void HCCurves::reserve(size_t n)
+{
+    m_x.reserve(n);
+    for (auto& c : m_columns)
+        c.reserve(n);
+}
+
+void HCCurves::append(double x, const double* values)
+{
+    m_x.push_back(x);
+    for (size_t c = 0; c < m_columns.size(); ++c)
+        m_columns[c].push_back(values[c]);
+}
+
+size_t HCCurves::size() const
+{
+    return m_x.size();
+}
+
+bool HCCurves::empty() const
+{
+    return m_x.empty();
+}
+
+size_t HCCurves::getColumnCount() const
+{
+    return m_columns.size();
+}
+
+double HCCurves::getAbscissa(size_t i) const
+{
+    return m_x[i];
+}
+
+double HCCurves::getValue(size_t column, size_t i) const
+{
+    return m_columns[column][i];
+}
+
+double HCCurves::interpolate(size_t column, double x) const
+{
+    size_t j = std::lower_bound(m_x.begin(), m_x.end(), x) - m_x.begin();
+    return valueAt(column, x, j);
+}
+
+double HCCurves::interpolate(size_t column, double x, Cursor& cursor) const
+{
+    cursor.index = seek(x, cursor.index);
+    return valueAt(column, x, cursor.index);
+}
+
+void HCCurves::fillColumn(size_t column, const double* xs, size_t n, double* out) const
+{
+    size_t j = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (j < m_x.size() && m_x[j] < xs[i])
+            ++j;
+        out[i] = valueAt(column, xs[i], j);
+    }
+}
+
+size_t HCCurves::seek(double x, size_t from) const
+{
+    size_t j = std::min(from, m_x.size());
+    // Backward if x moved down, then forward
+    while (j > 0 && m_x[j - 1] >= x)
+        --j;
+    while (j < m_x.size() && m_x[j] < x)
+        ++j;
+    return j;
+}
+
+double HCCurves::valueAt(size_t column, double x, size_t j) const
+{
+    // j is the first point with abscissa >= x
+    if (j >= m_x.size())
+        return NOT_AVAILABLE;
+
+    const std::vector<double>& v = m_columns[column];
+    if (j == 0) {
+        if (!m_toOrigin || m_x[0] == 0.0)
+            return (x == m_x[0]) ? v[0] : NOT_AVAILABLE;
+        // interpolation to 0
+        double b = x / m_x[0];
+        return b * v[0];
+    }
+
+    double div = m_x[j] - m_x[j - 1];
+    double a = (m_x[j] - x) / div;
+    double b = (x - m_x[j - 1]) / div;
+    return a * v[j - 1] + b * v[j];
+}
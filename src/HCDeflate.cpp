@@ -0,0 +1,128 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+// ===== External Includes ===== //
+#include <zlib.h>
+
+// ===== HydroCpp Includes ===== //
+#include "HCDeflate.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    // zlib counts the bytes in uInt, larger buffers are fed by chunks
+    constexpr size_t MAX_CHUNK = size_t(1) << 30;
+
+    /**
+     * @brief raw deflate stream, reused by the thread from one segment
+     * to the next: a reset keeps the window and the hash tables
+     */
+    struct Deflater
+    {
+        z_stream    zs {};
+
+        Deflater()
+        {
+            if (deflateInit2(&zs, HCDeflate::LEVEL, Z_DEFLATED, -MAX_WBITS, 8,
+                            Z_DEFAULT_STRATEGY) != Z_OK)
+                throw std::runtime_error("Unable to initialize the deflate stream");
+        }
+
+        ~Deflater()
+        {
+            deflateEnd(&zs);
+        }
+
+        Deflater(const Deflater&) = delete;
+        Deflater& operator=(const Deflater&) = delete;
+    };
+}
+
+uint32_t HCDeflate::crc32(uint32_t crc, const void* data, size_t n)
+{
+    const Bytef* p = static_cast<const Bytef*>(data);
+    while (n > 0) {
+        const size_t len = std::min(n, MAX_CHUNK);
+        crc = static_cast<uint32_t>(::crc32(crc, p, static_cast<uInt>(len)));
+        p += len;
+        n -= len;
+    }
+    return crc;
+}
+
+void HCDeflate::compress(const void* data, size_t n, bool final, std::vector<uint8_t>& out)
+{
+    thread_local Deflater def;
+    z_stream& zs = def.zs;
+    if (deflateReset(&zs) != Z_OK)
+        throw std::runtime_error("Unable to reset the deflate stream");
+
+    // A full flush ends the segment on a byte boundary without any
+    // reference to the previous bytes, only the last one is finished
+    const int lastFlush = final ? Z_FINISH : Z_FULL_FLUSH;
+    zs.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(data));
+    size_t left = n;
+    int ret;
+    do {
+        const size_t len = std::min(left, MAX_CHUNK);
+        zs.avail_in = static_cast<uInt>(len);
+        left -= len;
+        const int flush = left == 0 ? lastFlush : Z_NO_FLUSH;
+
+        const size_t bound = deflateBound(&zs, static_cast<uLong>(len)) + 16;
+        do {
+            const size_t start = out.size();
+            out.resize(start + bound);
+            zs.next_out = out.data() + start;
+            zs.avail_out = static_cast<uInt>(bound);
+            ret = deflate(&zs, flush);
+            out.resize(out.size() - zs.avail_out);
+            if (ret == Z_STREAM_ERROR)
+                throw std::runtime_error("Deflate stream error");
+        } while (zs.avail_out == 0 || zs.avail_in > 0);
+    } while (left > 0);
+
+    if (final && ret != Z_STREAM_END)
+        throw std::runtime_error("Deflate stream not finished");
+}
+
+bool HCDeflate::decompress(const void* data, size_t n, std::vector<uint8_t>& out)
+{
+    z_stream zs {};
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        return false;
+
+    zs.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(data));
+    size_t left = n;
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (zs.avail_in == 0) {
+            if (left == 0)
+                break; // truncated
+            const size_t len = std::min(left, MAX_CHUNK);
+            zs.avail_in = static_cast<uInt>(len);
+            left -= len;
+        }
+        const size_t chunk = std::max<size_t>(65536, std::min<size_t>(4 * n, size_t(1) << 24));
+        const size_t start = out.size();
+        out.resize(start + chunk);
+        zs.next_out = out.data() + start;
+        zs.avail_out = static_cast<uInt>(chunk);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        out.resize(out.size() - zs.avail_out);
+        if (ret == Z_BUF_ERROR && zs.avail_in > 0)
+            ret = Z_OK; // the output was full
+    }
+    inflateEnd(&zs);
+    return ret == Z_STREAM_END;
+}
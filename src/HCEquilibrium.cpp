@@ -0,0 +1,381 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+#define _USE_MATH_DEFINES
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCEquilibrium.hpp"
+#include "HCMetrics.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    const unsigned  MAX_ITERATIONS  = 50;
+    const unsigned  MAX_HALVINGS    = 12;   // of a Newton step not reducing the residuals
+
+    /**
+     * @brief wet part of a section below the line z = c + b y
+     */
+    struct SectionClip
+    {
+        double  area    {0.0};
+        double  Sy      {0.0};  // integral of y dA
+        double  Sz      {0.0};  // integral of z dA
+        double  w0      {0.0};  // integrals of 1, y and y^2 dy along the chords
+        double  w1      {0.0};
+        double  w2      {0.0};
+        bool    dry     {false};// a vertex above the line
+    };
+
+    /**
+     * @brief clip a counterclockwise section by the line, in one pass
+     * (Sutherland-Hodgman). The wet ring is accumulated as it is built,
+     * its edges joining 2 points of the line being the chords. The ring
+     * of a non convex section may go along the line over dry parts, back
+     * and forth, which cancels in the integrals.
+     */
+    void clipSection(const HCPoint* v, size_t n, double c, double b, SectionClip& clip)
+    {
+        double cross2 = 0.0, sy6 = 0.0, sz6 = 0.0;
+        bool started = false, firstOn = false, prevOn = false;
+        double y0 = 0.0, z0 = 0.0, yp = 0.0, zp = 0.0;
+
+        auto edge = [&](double y1, double z1, bool on1, double y2, double z2, bool on2){
+            double cr = y1 * z2 - y2 * z1;
+            cross2 += cr;
+            sy6 += (y1 + y2) * cr;
+            sz6 += (z1 + z2) * cr;
+            if (on1 && on2) { // chords are run from fore to aft, in decreasing y
+                clip.w0 -= y2 - y1;
+                clip.w1 -= (y2 * y2 - y1 * y1) / 2;
+                clip.w2 -= (y2 * y2 * y2 - y1 * y1 * y1) / 3;
+            }
+        };
+        auto emit = [&](double y, double z, bool on){
+            if (!started) {
+                y0 = y; z0 = z; firstOn = on;
+                started = true;
+            } else {
+                edge(yp, zp, prevOn, y, z, on);
+            }
+            yp = y; zp = z; prevOn = on;
+        };
+        // Crossing point, exactly on the line
+        auto cross = [&](const HCPoint& p, double dp, const HCPoint& q, double dq){
+            double y = p.x + dp / (dp - dq) * (q.x - p.x);
+            emit(y, c + b * y, true);
+        };
+
+        double dp = v[n - 1].y - c - b * v[n - 1].x;
+        for (size_t i = 0; i < n; ++i) {
+            const HCPoint& p = v[i == 0 ? n - 1 : i - 1];
+            const HCPoint& q = v[i];
+            double dq = q.y - c - b * q.x;
+            if (dq <= 0.0) {
+                if (dp > 0.0)
+                    cross(p, dp, q, dq);
+                emit(q.x, q.y, dq == 0.0);
+            } else {
+                clip.dry = true;
+                if (dp <= 0.0)
+                    cross(p, dp, q, dq);
+            }
+            dp = dq;
+        }
+        if (started)
+            edge(yp, zp, prevOn, y0, z0, firstOn);
+
+        clip.area = cross2 / 2;
+        clip.Sy = sy6 / 6;
+        clip.Sz = sz6 / 6;
+    }
+
+    /**
+     * @brief solve the 3x3 system J x = r by Gaussian elimination
+     * with partial pivoting
+     * @return false if J is singular
+     */
+    bool solve3(const double J[9], const double r[3], double x[3])
+    {
+        double m[3][4];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j)
+                m[i][j] = J[3 * i + j];
+            m[i][3] = r[i];
+        }
+        double scale = 0.0;
+        for (int i = 0; i < 9; ++i)
+            scale = std::max(scale, std::abs(J[i]));
+
+        for (int k = 0; k < 3; ++k) {
+            int pivot = k;
+            for (int i = k + 1; i < 3; ++i)
+                if (std::abs(m[i][k]) > std::abs(m[pivot][k]))
+                    pivot = i;
+            if (!(std::abs(m[pivot][k]) > 1e-14 * scale))
+                return false;
+            if (pivot != k)
+                for (int j = 0; j < 4; ++j)
+                    std::swap(m[k][j], m[pivot][j]);
+            for (int i = k + 1; i < 3; ++i) {
+                double f = m[i][k] / m[k][k];
+                for (int j = k; j < 4; ++j)
+                    m[i][j] -= f * m[k][j];
+            }
+        }
+        for (int k = 2; k >= 0; --k) {
+            double s = m[k][3];
+            for (int j = k + 1; j < 3; ++j)
+                s -= m[k][j] * x[j];
+            x[k] = s / m[k][k];
+        }
+        return true;
+    }
+}
+
+HCEquilibrium::HCEquilibrium(const HCHull& hull, double d_sw):
+    m_hull(hull),
+    m_d_sw(d_sw)
+{
+    if (m_hull.empty())
+        return;
+
+    m_sections.resize(m_hull.size());
+    double yMin = std::numeric_limits<double>::max();
+    double yMax = std::numeric_limits<double>::lowest();
+    m_zMin = std::numeric_limits<double>::max();
+    m_zMax = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        const HCPoint* v = m_hull.getVertices(i);
+        const size_t n = m_hull.getVertexCount(i);
+        Section& s = m_sections[i];
+        s.yMin = s.zMin = std::numeric_limits<double>::max();
+        s.yMax = s.zMax = std::numeric_limits<double>::lowest();
+        double cross2 = 0.0, sy6 = 0.0, sz6 = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            const HCPoint& p = v[j];
+            const HCPoint& q = v[j + 1 < n ? j + 1 : 0];
+            double cr = p.x * q.y - q.x * p.y;
+            cross2 += cr;
+            sy6 += (p.x + q.x) * cr;
+            sz6 += (p.y + q.y) * cr;
+            s.yMin = std::min(s.yMin, p.x);
+            s.yMax = std::max(s.yMax, p.x);
+            s.zMin = std::min(s.zMin, p.y);
+            s.zMax = std::max(s.zMax, p.y);
+        }
+        s.area = cross2 / 2;
+        s.Sy = sy6 / 6;
+        s.Sz = sz6 / 6;
+        if (n == 0)
+            s.yMin = s.yMax = s.zMin = s.zMax = 0.0;
+
+        yMin = std::min(yMin, s.yMin);
+        yMax = std::max(yMax, s.yMax);
+        m_zMin = std::min(m_zMin, s.zMin);
+        m_zMax = std::max(m_zMax, s.zMax);
+        m_boxArea += m_hull.getElmtLength(i) * (s.yMax - s.yMin);
+    }
+
+    const size_t last = m_hull.size() - 1;
+    const double xAft = m_hull.getStationX(0);
+    const double xFore = m_hull.getStationX(last) + m_hull.getElmtLength(last);
+    m_xRef = (xAft + xFore) / 2;
+    m_length = xFore - xAft;
+    m_breadth = yMax - yMin;
+}
+
+HCEquilibrium::~HCEquilibrium() = default;
+
+void HCEquilibrium::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+
+HCFloatingPosition HCEquilibrium::solve(const HCLoadCondition& condition) const
+{
+    // Upright, at the draught of the bounding boxes
+    HCFloatingPosition start;
+    if (m_boxArea > 0.0)
+        start.draught = m_zMin + condition.displacement / m_d_sw / m_boxArea;
+    start.draught = std::min(std::max(start.draught, m_zMin), m_zMax);
+    return solve(condition, start);
+}
+
+HCFloatingPosition HCEquilibrium::solve(const HCLoadCondition& condition,
+                                        const HCFloatingPosition& start) const
+{
+    HCFloatingPosition res;
+    res.xRef = m_xRef;
+    if (m_sections.empty() || !(condition.displacement > 0.0) || !(m_d_sw > 0.0))
+        return res;
+
+    double p[3] = { start.draught,
+                    tan(start.trim * M_PI / 180),
+                    tan(start.heel * M_PI / 180) };
+    double F[3], J[9];
+    Buoyancy B = evaluate(p[0], p[1], p[2]);
+    double norm = residuals(B, p, condition, F, J);
+
+    while (norm > m_tolerance && res.iterations < MAX_ITERATIONS) {
+        ++res.iterations;
+        double step[3] = { 0.0, 0.0, 0.0 };
+        const double r[3] = { -F[0], -F[1], -F[2] };
+        if (!solve3(J, r, step)) {
+            // Waterplane out of the hull: the volume is driven alone
+            // with the waterplane of the bounding boxes
+            step[0] = r[0] / std::max(J[0], m_boxArea);
+        }
+
+        // Damped, the step is halved until the residuals decrease
+        bool accepted = false;
+        double lambda = 1.0;
+        for (unsigned h = 0; h <= MAX_HALVINGS && !accepted; ++h, lambda /= 2) {
+            double q[3] = { p[0] + lambda * step[0],
+                            p[1] + lambda * step[1],
+                            p[2] + lambda * step[2] };
+            double Fq[3], Jq[9];
+            Buoyancy Bq = evaluate(q[0], q[1], q[2]);
+            double normq = residuals(Bq, q, condition, Fq, Jq);
+            if (normq < norm) {
+                std::copy(q, q + 3, p);
+                std::copy(Fq, Fq + 3, F);
+                std::copy(Jq, Jq + 9, J);
+                B = Bq;
+                norm = normq;
+                accepted = true;
+            }
+        }
+        if (!accepted)
+            break;
+    }
+
+    res.converged = norm <= m_tolerance;
+    res.draught = p[0];
+    res.trim = atan(p[1]) * 180 / M_PI;
+    res.heel = atan(p[2]) * 180 / M_PI;
+    res.draughtAft = p[0] - p[1] * m_length / 2;
+    res.draughtFore = p[0] + p[1] * m_length / 2;
+    res.volume = B.V;
+    res.submerged = B.submerged;
+    if (B.V > 0.0) {
+        res.LCB = B.Mx / B.V;
+        res.TCB = B.My / B.V;
+        res.VCB = B.Mz / B.V;
+
+        // Moment residuals with the trim and the heel at constant volume,
+        // the draught eliminated with the volume residual
+        if (J[0] > 0.0) {
+            res.GML = (J[4] - J[3] * J[1] / J[0]) / B.V;
+            res.GMT = (J[8] - J[6] * J[2] / J[0]) / B.V;
+        }
+    }
+    return res;
+}
+
+std::vector<HCFloatingPosition> HCEquilibrium::solve(
+                                const std::vector<HCLoadCondition>& conditions) const
+{
+    std::vector<HCFloatingPosition> res;
+    res.reserve(conditions.size());
+    for (const auto& condition : conditions) {
+        if (!res.empty() && res.back().converged)
+            res.push_back(solve(condition, res.back()));
+        else
+            res.push_back(solve(condition));
+    }
+    return res;
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+HCEquilibrium::Buoyancy HCEquilibrium::evaluate(double T, double a, double b) const
+{
+    HCMetrics::add(HC_WATERLINES);
+    Buoyancy B;
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        const Section& s = m_sections[i];
+        const double dx = m_hull.getElmtLength(i);
+        const double xm = m_hull.getMidX(i);
+        const double u = xm - m_xRef;
+        const double c = T + a * u;
+
+        // Bounding box entirely above or below the line
+        const double byMin = std::min(b * s.yMin, b * s.yMax);
+        const double byMax = std::max(b * s.yMin, b * s.yMax);
+        if (s.zMin - c - byMax > 0.0)
+            continue;
+
+        SectionClip clip;
+        if (s.zMax - c - byMin < 0.0) {
+            clip.area = s.area;
+            clip.Sy = s.Sy;
+            clip.Sz = s.Sz;
+        } else {
+            clipSection(m_hull.getVertices(i), m_hull.getVertexCount(i), c, b, clip);
+        }
+        if (!clip.dry)
+            B.submerged = true;
+
+        B.V += dx * clip.area;
+        B.Mx += xm * dx * clip.area;
+        B.My += dx * clip.Sy;
+        B.Mz += dx * clip.Sz;
+
+        // Derivatives with T, a and b: the line rises by 1, u and y
+        const double zc0 = c * clip.w0 + b * clip.w1;
+        const double zc1 = c * clip.w1 + b * clip.w2;
+        const double dA[3] = { clip.w0, u * clip.w0, clip.w1 };
+        const double dSy[3] = { clip.w1, u * clip.w1, clip.w2 };
+        const double dSz[3] = { zc0, u * zc0, zc1 };
+        for (int k = 0; k < 3; ++k) {
+            B.dV[k] += dx * dA[k];
+            B.dMx[k] += xm * dx * dA[k];
+            B.dMy[k] += dx * dSy[k];
+            B.dMz[k] += dx * dSz[k];
+        }
+    }
+    return B;
+}
+
+double HCEquilibrium::residuals(const Buoyancy& B, const double p[3],
+                                const HCLoadCondition& condition,
+                                double F[3], double J[9]) const
+{
+    const double Vt = condition.displacement / m_d_sw;
+    const double a = p[1];
+    const double b = p[2];
+
+    // B - G parallel to the normal of the waterplane (-a, -b, 1),
+    // multiplied by the volume
+    const double Mzg = B.Mz - condition.VCG * B.V;
+    F[0] = B.V - Vt;
+    F[1] = B.Mx - condition.LCG * B.V + a * Mzg;
+    F[2] = B.My - condition.TCG * B.V + b * Mzg;
+
+    for (int k = 0; k < 3; ++k) {
+        const double dMzg = B.dMz[k] - condition.VCG * B.dV[k];
+        J[k] = B.dV[k];
+        J[3 + k] = B.dMx[k] - condition.LCG * B.dV[k] + a * dMzg + (k == 1 ? Mzg : 0.0);
+        J[6 + k] = B.dMy[k] - condition.TCG * B.dV[k] + b * dMzg + (k == 2 ? Mzg : 0.0);
+    }
+
+    return std::max({ std::abs(F[0]) / Vt,
+                      std::abs(F[1]) / (Vt * m_length),
+                      std::abs(F[2]) / (Vt * m_breadth) });
+}
@@ -0,0 +1,168 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCHalfPlaneClip.hpp"
+#include "HCMetrics.hpp"
+#include "HCSideKernel.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    /**
+     * @brief shoelace accumulators of a polygon given vertex by vertex
+     */
+    struct MomentStream
+    {
+        double  area    {0.0};
+        double  Mx      {0.0};
+        double  My      {0.0};
+        double  x0      {0.0};
+        double  y0      {0.0};
+        double  xp      {0.0};
+        double  yp      {0.0};
+        bool    started {false};
+
+        inline void add(double x, double y)
+        {
+            if (!started) {
+                x0 = xp = x;
+                y0 = yp = y;
+                started = true;
+                return;
+            }
+            edge(x, y);
+            xp = x;
+            yp = y;
+        }
+
+        inline void edge(double x, double y)
+        {
+            double cross = xp * y - x * yp;
+            area += cross;
+            Mx += (xp + x) * cross;
+            My += (yp + y) * cross;
+        }
+
+        inline void close()
+        {
+            if (started)
+                edge(x0, y0);
+            area /= 2;
+            Mx /= 6;
+            My /= 6;
+        }
+    };
+}
+
+template<typename T, typename Line>
+bool HCHalfPlaneClip::cutSection(const HCPointT<T>* vertices, size_t n,
+                            const std::pair<HCPointT<T>,HCPointT<T>>& line,
+                            double wl, HCSectionCut& cut)
+{
+    cut = HCSectionCut();
+    if (n < 3)
+        return false;
+
+    // Sides of the vertices, on the stack for the usual sections
+    constexpr size_t STACK_VERTICES = 256;
+    int8_t stackSides[STACK_VERTICES];
+    thread_local std::vector<int8_t> heapSides;
+    int8_t* sides = stackSides;
+    if (n > STACK_VERTICES) {
+        heapSides.resize(n);
+        sides = heapSides.data();
+    }
+
+    // Same classification as HCPolygonSplitter, 1: right (wet), -1: left (dry)
+    constexpr bool horizontal = std::is_same_v<Line, HCHorizontalLine>;
+    uint32_t summary;
+    if constexpr (horizontal)
+        summary = HCSideKernel::classifyHorizontal(vertices, n, line, sides);
+    else
+        summary = HCSideKernel::classify(vertices, n, line, sides);
+    HCMetrics::add(HC_VERTICES_CLASSIFIED, n);
+    if (summary & HCSideKernel::HAS_ON)
+        return false; // vertex on the line
+    cut.dryEmpty = !(summary & HCSideKernel::HAS_LEFT);
+    if (!(summary & HCSideKernel::HAS_RIGHT))
+        return true; // dry section
+
+    uint32_t edges[2] = { 0, 0 };
+    size_t nCross = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (sides[i] != sides[i + 1 < n ? i + 1 : 0]) {
+            if (nCross == 2)
+                return false; // several wet loops
+            edges[nCross++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Same intersection as HCPolygonSplitter, or the interpolation
+    // of x on a horizontal line
+    HCPointT<T> cross[2] = { HCPointT<T>(0, 0), HCPointT<T>(0, 0) };
+    HCMetrics::add(HC_INTERSECTIONS, nCross);
+    if (nCross > 0) {
+        size_t parallel;
+        if constexpr (horizontal)
+            parallel = HCSideKernel::intersectHorizontal(vertices, n, edges, nCross, line, cross);
+        else
+            parallel = HCSideKernel::intersect(vertices, n, edges, nCross, line, cross);
+        if (parallel > 0)
+            return false;
+    }
+
+    MomentStream wet;
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (sides[i] > 0)
+            wet.add(vertices[i].x, vertices[i].y);
+        if (c < nCross && edges[c] == i) {
+            wet.add(cross[c].x, cross[c].y);
+            ++c;
+        }
+    }
+    wet.close();
+
+    cut.area = wet.area;
+    if (wet.area > 0) {
+        cut.Mx = wet.Mx;
+        cut.My = wet.My;
+    }
+
+    if (nCross == 2) {
+        const HCPoint c0(cross[0]), c1(cross[1]);
+        double L = c0.distanceTo(c1);
+        HCPoint mid((c0.x + c1.x) / 2, (c0.y + c1.y) / 2);
+        double dt = mid.distanceTo(HCPoint(0.0, wl));
+        cut.chordLength = L;
+        cut.chordInertia = pow(L, 3) / 12 + L * pow(dt, 2);
+    }
+
+    return true;
+}
+
+namespace HydroCpp
+{
+    template bool HCHalfPlaneClip::cutSection<double, HCGeneralLine>(const HCPoint*, size_t,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&);
+    template bool HCHalfPlaneClip::cutSection<float, HCGeneralLine>(const HCPointF*, size_t,
+                            const std::pair<HCPointF,HCPointF>&, double, HCSectionCut&);
+    template bool HCHalfPlaneClip::cutSection<double, HCHorizontalLine>(const HCPoint*, size_t,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&);
+    template bool HCHalfPlaneClip::cutSection<float, HCHorizontalLine>(const HCPointF*, size_t,
+                            const std::pair<HCPointF,HCPointF>&, double, HCSectionCut&);
+}
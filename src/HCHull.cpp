@@ -0,0 +1,75 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <cmath>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCHull.hpp"
+#include "HCPolygon.hpp"
+
+using namespace HydroCpp;
+
+HCHull::HCHull() : m_offsets(1, 0), m_pointData(nullptr),
+                m_offsetData(m_offsets.data()), m_stationData(nullptr), m_size(0)
+{ }
+
+HCHull::HCHull(const std::map<double,std::vector<HCPoint>>& sections)
+        : HCHull()
+{
+    const size_t n = sections.size();
+    size_t nPoints = 0;
+    for (const auto& [x, vertices] : sections)
+        nPoints += vertices.size();
+
+    m_points.reserve(nPoints);
+    m_offsets.reserve(n + 1);
+    m_stationX.reserve(n);
+
+    for (const auto& [x, vertices] : sections) {
+        // Orient the section in the same way as HCPolygon
+        HCPolygon section(vertices);
+        const auto& ccw = section.getVertices();
+        m_points.insert(m_points.end(), ccw.begin(), ccw.end());
+        m_offsets.push_back(static_cast<uint32_t>(m_points.size()));
+        m_stationX.push_back(x);
+    }
+
+    m_pointData = m_points.data();
+    m_offsetData = m_offsets.data();
+    m_stationData = m_stationX.data();
+    m_size = n;
+    computeElements();
+}
+
+HCHull::HCHull(std::shared_ptr<const void> storage, size_t nSections,
+                const double* stationX, const uint32_t* offsets, const HCPoint* points)
+        : m_storage(std::move(storage)), m_pointData(points), m_offsetData(offsets),
+        m_stationData(stationX), m_size(nSections)
+{
+    computeElements();
+}
+
+HCHull::~HCHull() = default;
+
+void HCHull::computeElements()
+{
+    const size_t n = m_size;
+
+    // the length of the last element will be the same as the n-1 one
+    m_elmtLength.resize(n, 0.0);
+    m_midX.resize(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        if (i + 1 < n)
+            m_elmtLength[i] = std::abs(m_stationData[i + 1] - m_stationData[i]);
+        else if (n > 1)
+            m_elmtLength[i] = std::abs(m_stationData[i] - m_stationData[i - 1]);
+        m_midX[i] = m_stationData[i] + m_elmtLength[i] / 2;
+    }
+}
@@ -0,0 +1,319 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCHullFile.hpp"
+
+using namespace HydroCpp;
+
+// The vertices of a binary file are used in place as HCPoint
+static_assert(sizeof(HCPoint) == 2 * sizeof(double) && std::is_standard_layout<HCPoint>::value,
+                "HCPoint shall be laid out as 2 doubles");
+
+namespace
+{
+    const char      MAGIC[8]        = { 'H', 'C', 'H', 'U', 'L', 'L', '\x1a', '\0' };
+    const uint32_t  BYTE_ORDER_MARK = 0x01020304;
+    const size_t    HEADER_SIZE     = 32;
+
+    /**
+     * @brief read only mapping of a whole file
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& filename)
+        {
+#ifdef _WIN32
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                throw std::runtime_error("Unable to open " + filename);
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size)) {
+                CloseHandle(m_file);
+                throw std::runtime_error("Unable to read " + filename);
+            }
+            m_size = static_cast<size_t>(size.QuadPart);
+            if (m_size == 0)
+                return;
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m_mapping)
+                m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!m_data) {
+                if (m_mapping)
+                    CloseHandle(m_mapping);
+                CloseHandle(m_file);
+                throw std::runtime_error("Unable to map " + filename);
+            }
+#else
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("Unable to open " + filename);
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                throw std::runtime_error("Unable to read " + filename);
+            }
+            m_size = static_cast<size_t>(st.st_size);
+            if (m_size > 0) {
+                void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("Unable to map " + filename);
+                }
+                m_data = static_cast<const uint8_t*>(p);
+            }
+            close(fd); // the mapping stays valid
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifdef _WIN32
+            if (m_data)
+                UnmapViewOfFile(m_data);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            CloseHandle(m_file);
+#else
+            if (m_data)
+                munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const uint8_t*  m_data  { nullptr };
+        size_t          m_size  { 0 };
+#ifdef _WIN32
+        HANDLE          m_file      { INVALID_HANDLE_VALUE };
+        HANDLE          m_mapping   { nullptr };
+#endif
+    };
+
+    template <typename T>
+    T readValue(const uint8_t* p)
+    {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream& out, T v)
+    {
+        out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline size_t align8(size_t n)
+    {
+        return (n + 7) & ~size_t(7);
+    }
+}
+
+HCHullFormat HCHullFile::getFormat(const std::string& filename)
+{
+    std::string ext = std::filesystem::path(filename).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+    if (ext == ".csv")
+        return HCHullFormat::CSV;
+    if (ext == ".hcb")
+        return HCHullFormat::Binary;
+    return HCHullFormat::Workbook;
+}
+
+HCHull HCHullFile::readCSV(const std::string& filename)
+{
+    MappedFile file(filename);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* const end = p + file.size();
+
+    std::map<double,std::vector<HCPoint>> hull;
+    size_t lineNo = 0;
+    bool firstLine = true;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol)
+            eol = end;
+        ++lineNo;
+
+        const char* q = p;
+        p = eol + 1;
+        while (q < eol && isBlank(*q))
+            ++q;
+        if (q == eol || *q == '#')
+            continue;
+
+        // x, y, z separated by a comma, a semicolon or blanks
+        double v[3];
+        bool valid = true;
+        for (int k = 0; k < 3 && valid; ++k) {
+            if (k > 0) {
+                while (q < eol && isBlank(*q))
+                    ++q;
+                if (q < eol && (*q == ',' || *q == ';'))
+                    ++q;
+                while (q < eol && isBlank(*q))
+                    ++q;
+            }
+            if (q < eol && *q == '+')
+                ++q;
+            auto res = std::from_chars(q, eol, v[k]);
+            valid = res.ec == std::errc() && std::isfinite(v[k]);
+            q = res.ptr;
+        }
+        while (q < eol && isBlank(*q))
+            ++q;
+        valid = valid && q == eol;
+
+        if (valid)
+            hull[v[0]].push_back(HCPoint(v[1], v[2])); // step required to gather all the x
+        else if (!firstLine)
+            throw std::runtime_error(filename + ":" + std::to_string(lineNo) + ": invalid point");
+        firstLine = false; // the first line may be a header
+    }
+
+    return HCHull(hull);
+}
+
+HCHull HCHullFile::readBinary(const std::string& filename)
+{
+    auto file = std::make_shared<MappedFile>(filename);
+    const uint8_t* d = file->data();
+    const size_t size = file->size();
+
+    if (size < HEADER_SIZE || std::memcmp(d, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error(filename + " is not a HydroCpp hull file");
+    const uint32_t version = readValue<uint32_t>(d + 8);
+    if (version != VERSION)
+        throw std::runtime_error(filename + " : version " + std::to_string(version)
+                                + " is not supported");
+    if (readValue<uint32_t>(d + 12) != BYTE_ORDER_MARK)
+        throw std::runtime_error(filename + " : byte order is not supported");
+
+    const uint64_t nSections = readValue<uint64_t>(d + 16);
+    const uint64_t nPoints = readValue<uint64_t>(d + 24);
+    if (nSections >= UINT32_MAX || nPoints >= UINT32_MAX)
+        throw std::runtime_error(filename + " : corrupted header");
+
+    const size_t stationPos = HEADER_SIZE;
+    const size_t offsetPos = stationPos + nSections * sizeof(double);
+    const size_t pointPos = align8(offsetPos + (nSections + 1) * sizeof(uint32_t));
+    if (pointPos + nPoints * sizeof(HCPoint) != size)
+        throw std::runtime_error(filename + " : size doesn't match the header");
+
+    // The arrays are used in place, the mapping is page aligned
+    const double* stationX = reinterpret_cast<const double*>(d + stationPos);
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(d + offsetPos);
+    const HCPoint* points = reinterpret_cast<const HCPoint*>(d + pointPos);
+
+    if (offsets[0] != 0 || offsets[nSections] != nPoints)
+        throw std::runtime_error(filename + " : corrupted section offsets");
+    for (size_t i = 0; i < nSections; ++i) {
+        if (offsets[i + 1] < offsets[i])
+            throw std::runtime_error(filename + " : corrupted section offsets");
+        if (!std::isfinite(stationX[i]) || (i > 0 && !(stationX[i] > stationX[i - 1])))
+            throw std::runtime_error(filename + " : stations shall be increasing");
+
+        // A mapped section can't be reoriented as HCPolygon does, check it here
+        const HCPoint* v = points + offsets[i];
+        const size_t n = offsets[i + 1] - offsets[i];
+        if (n < 3)
+            throw std::runtime_error(filename + " : section " + std::to_string(i)
+                                    + " has less than 3 vertices");
+        double area = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            const HCPoint& a = v[k];
+            const HCPoint& b = v[(k + 1) % n];
+            if (!std::isfinite(a.x) || !std::isfinite(a.y))
+                throw std::runtime_error(filename + " : section " + std::to_string(i)
+                                        + " has a non finite vertex");
+            area += a.x * b.y - b.x * a.y;
+        }
+        if (!(area > 0.0))
+            throw std::runtime_error(filename + " : section " + std::to_string(i)
+                                    + " shall be counterclockwise with a positive area");
+    }
+
+    return HCHull(std::move(file), static_cast<size_t>(nSections), stationX, offsets, points);
+}
+
+void HCHullFile::writeBinary(const std::string& filename, const HCHull& hull)
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Unable to create " + filename);
+
+    const uint64_t nSections = hull.size();
+    const uint64_t nPoints = hull.getTotalVertexCount();
+
+    out.write(MAGIC, sizeof(MAGIC));
+    writeValue<uint32_t>(out, VERSION);
+    writeValue<uint32_t>(out, BYTE_ORDER_MARK);
+    writeValue<uint64_t>(out, nSections);
+    writeValue<uint64_t>(out, nPoints);
+
+    for (size_t i = 0; i < nSections; ++i)
+        writeValue<double>(out, hull.getStationX(i));
+
+    uint32_t offset = 0;
+    writeValue<uint32_t>(out, offset);
+    for (size_t i = 0; i < nSections; ++i) {
+        offset += static_cast<uint32_t>(hull.getVertexCount(i));
+        writeValue<uint32_t>(out, offset);
+    }
+    const size_t offsetEnd = HEADER_SIZE + nSections * sizeof(double)
+                            + (nSections + 1) * sizeof(uint32_t);
+    const char padding[8] = {};
+    out.write(padding, static_cast<std::streamsize>(align8(offsetEnd) - offsetEnd));
+
+    if (nPoints > 0)
+        out.write(reinterpret_cast<const char*>(hull.getVertices(0)),
+                static_cast<std::streamsize>(nPoints * sizeof(HCPoint)));
+
+    out.close();
+    if (!out)
+        throw std::runtime_error("Error writing " + filename);
+}
@@ -0,0 +1,96 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCKNTable.hpp"
+
+using namespace HydroCpp;
+
+HCKNTable::HCKNTable() = default;
+
+HCKNTable::~HCKNTable() = default;
+
+void HCKNTable::clear()
+{
+    m_angles.clear();
+    m_curves.clear();
+}
+
+size_t HCKNTable::addAngle(double angle)
+{
+    m_angles.push_back(angle);
+    m_curves.emplace_back(NB_COLUMNS, true);
+    return m_angles.size() - 1;
+}
+
+void HCKNTable::append(size_t angleIndex, double displ, double KNsin,
+                    double waterline, double volume)
+{
+    const double values[NB_COLUMNS] = { KNsin, waterline, volume };
+    m_curves[angleIndex].append(displ, values);
+}
+
+size_t HCKNTable::getAngleCount() const
+{
+    return m_angles.size();
+}
+
+double HCKNTable::getAngle(size_t angleIndex) const
+{
+    return m_angles[angleIndex];
+}
+
+const HCCurves& HCKNTable::getCurves(size_t angleIndex) const
+{
+    return m_curves[angleIndex];
+}
+
+double HCKNTable::getKNsinAt(size_t angleIndex, double displ) const
+{
+    return m_curves[angleIndex].interpolate(KNSIN, displ);
+}
+
+double HCKNTable::getKNsin(double angle, double displ) const
+{
+    auto it = std::lower_bound(m_angles.begin(), m_angles.end(), angle);
+    if (it == m_angles.end())
+        return HCCurves::NOT_AVAILABLE;
+
+    size_t j = it - m_angles.begin();
+    if (*it == angle)
+        return getKNsinAt(j, displ);
+    if (j == 0)
+        return HCCurves::NOT_AVAILABLE;
+
+    double k0 = getKNsinAt(j - 1, displ);
+    double k1 = getKNsinAt(j, displ);
+    if (k0 == HCCurves::NOT_AVAILABLE || k1 == HCCurves::NOT_AVAILABLE)
+        return HCCurves::NOT_AVAILABLE;
+
+    double b = (angle - m_angles[j - 1]) / (m_angles[j] - m_angles[j - 1]);
+    return (1 - b) * k0 + b * k1;
+}
+
+std::pair<double,double> HCKNTable::getWlandVol(double displ) const
+{
+    if (m_curves.empty())
+        return std::make_pair(HCCurves::NOT_AVAILABLE, HCCurves::NOT_AVAILABLE);
+
+    return std::make_pair(m_curves[0].interpolate(WATERLINE, displ),
+                          m_curves[0].interpolate(VOLUME, displ));
+}
+
+void HCKNTable::fillColumn(size_t angleIndex, Column column,
+                        const double* displ, size_t n, double* out) const
+{
+    m_curves[angleIndex].fillColumn(column, displ, n, out);
+}
@@ -11,19 +11,127 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
 // ===== External Includes ===== //
 #include <OpenXLSX.hpp>
 // ===== HydroCpp Includes ===== //
 #include "HCLoader.hpp"
+#include "HCArena.hpp"
 #include "HCConfig.hpp"
 #include "HCLog.hpp"
+#include "HCMetrics.hpp"
 #include "HCPolygonSplitter.hpp"
+#include "HCSectionSweep.hpp"
+#include "HCHalfPlaneClip.hpp"
+#include "HCHullFile.hpp"
+#include "HCSheetWriter.hpp"
 
 using namespace HydroCpp;
 using namespace OpenXLSX;
 
+namespace
+{
+    // Values per row of the hydrotable in the cache, 14 and the flags
+    const size_t HYDRO_CACHE_VALUES = 15;
+
+    // Adaptive hydrotable: steps of the uniform grid between the
+    // first computed waterlines
+    const size_t ADAPTIVE_MAX_STEP = 16;
+
+    /**
+     * @brief hydrodata at the waterline wl between a and b, interpolated
+     * from the moments. The volume and its vertical moment are cubic,
+     * their derivatives being the waterplane area and its moment
+     */
+    Hydrodata interpolateHydro(const Hydrodata& a, const Hydrodata& b, double wl, double d_sw)
+    {
+        const double h = b.Waterline - a.Waterline;
+        const double s = (wl - a.Waterline) / h;
+        auto linear = [s](double fa, double fb){ return fa + s * (fb - fa); };
+        auto hermite = [s, h](double fa, double dfa, double fb, double dfb){
+            return (1 + 2 * s) * (1 - s) * (1 - s) * fa + s * (1 - s) * (1 - s) * h * dfa
+                    + s * s * (3 - 2 * s) * fb + s * s * (s - 1) * h * dfb;
+        };
+
+        Hydrodata hydro;
+        hydro.Waterline = wl;
+        hydro.Volume = hermite(a.Volume, a.WaterplaneArea, b.Volume, b.WaterplaneArea);
+        double Mz = hermite(a.VCB * a.Volume, a.WaterplaneArea * a.Waterline,
+                            b.VCB * b.Volume, b.WaterplaneArea * b.Waterline);
+        double Mx = linear(a.LCB * a.Volume, b.LCB * b.Volume);
+        double My = linear(a.TCB * a.Volume, b.TCB * b.Volume);
+        // Inertias at the CoB, constant along wall sided parts
+        double IT = linear(a.RMT * a.Displacement, b.RMT * b.Displacement);
+        double IL = linear(a.RML * a.Displacement, b.RML * b.Displacement);
+        hydro.WaterplaneArea = linear(a.WaterplaneArea, b.WaterplaneArea);
+        hydro.Lpp = linear(a.Lpp, b.Lpp);
+        hydro.LCF = linear(a.LCF, b.LCF);
+        if (!(hydro.Volume > 0.0))
+            return hydro;
+
+        hydro.LCB = Mx / hydro.Volume;
+        hydro.TCB = My / hydro.Volume;
+        hydro.VCB = Mz / hydro.Volume;
+        hydro.Displacement = hydro.Volume  * d_sw;
+        hydro.Immersion = hydro.WaterplaneArea * d_sw / 100; // in t/cm
+        hydro.RMT = IT / hydro.Displacement;
+        hydro.RML = IL / hydro.Displacement;
+        hydro.MCT = hydro.Displacement * hydro.RML / (100 * hydro.Lpp);
+        hydro.KMT = hydro.RMT + hydro.VCB;
+        hydro.isValid = true;
+        return hydro;
+    }
+
+    double relativeError(double value, double reference)
+    {
+        return std::abs(value - reference) / std::max(std::abs(reference), 1e-300);
+    }
+
+    /**
+     * @brief error of the volume between a and b integrated from the
+     * waterplane areas (trapezoid), relative to the volume between a
+     * and b. Zero when the waterplane area is linear, whatever its value
+     * in the middle, which a step of the hull may hit by chance
+     */
+    double integralError(const Hydrodata& a, const Hydrodata& b)
+    {
+        double integral = (b.Waterline - a.Waterline) * (a.WaterplaneArea + b.WaterplaneArea) / 2;
+        return relativeError(b.Volume - a.Volume, integral);
+    }
+}
+
 HCLoader::HCLoader(const std::string& filename):m_filename(filename)
 {
+    // Always timed, the metrics may be enabled afterwards
+    HCMetrics::Phase load(nullptr, HC_PHASE_LOAD);
+
+    HCHullFormat format = HCHullFile::getFormat(m_filename);
+    if (format != HCHullFormat::Workbook) {
+        m_hull = format == HCHullFormat::CSV ? HCHullFile::readCSV(m_filename)
+                                            : HCHullFile::readBinary(m_filename);
+        m_output = std::filesystem::path(m_filename).replace_extension(".xlsx").string();
+        for (size_t i = 0; i < m_hull.size(); ++i)
+            checkMinMax(m_hull.getVertices(i), m_hull.getVertexCount(i));
+        setShapeKernels(true);
+
+        HCParams params;
+        std::string sidecar = HCParams::getSidecarName(m_filename);
+        if (std::filesystem::exists(sidecar))
+            params.readFile(sidecar);
+        else
+            HCLogInfo("No parameter file " + sidecar + ", default values will be used");
+        setParams(params);
+        m_loadTime = load.elapsed();
+        return;
+    }
+
     XLDocument doc;
     doc.open(m_filename);
     XLWorkbook wb = doc.workbook();
@@ -43,37 +151,78 @@ HCLoader::HCLoader(const std::string& filename):m_filename(filename)
     }
 
     // Get hull max values
-    for (const auto& [key, value]: hull) {
-        m_hull[key] = new HCPolygon(value);
-        checkMinMax(value);
-    }
-
-    m_maxWl         = getValueFromRange(wb, MAX_WL_NAME,        MAX_WL_DEF );
-    m_deltaWl       = getValueFromRange(wb, DELTA_WL_NAME,      DELTA_WL_DEF );
-
-    // Length of the ship minus the step
-    double DisplMax = m_hull.rbegin()->first - m_hull.begin()->first;
-    DisplMax *= (m_minMax.xmax - m_minMax.xmin);
-    DisplMax *= m_maxWl;
-
-    m_maxAngle      = getValueFromRange(wb, MAX_ANGLE_NAME,     MAX_ANGLE_DEF );
-    m_deltaAngle    = getValueFromRange(wb, DELTA_ANGLE_NAME,   DELTA_ANGLE_DEF );
-    m_maxDispl      = getValueFromRange(wb, MAX_DISPL_NAME,     /*MAX_DISPL_DEF*/ DisplMax );
-    m_deltaDispl    = getValueFromRange(wb, DELTA_DISPL_NAME,   DELTA_DISPL_DEF );
-    m_d_sw          = getValueFromRange(wb, D_SW_NAME,          D_SW_DEF );
+    for (const auto& [key, value]: hull)
+        checkMinMax(value.data(), value.size());
+    m_hull = HCHull(hull);
+    m_output = m_filename;
+    setShapeKernels(true);
+
+    // The sidecar, if any, gives the parameters without named range
+    HCParams params;
+    std::string sidecar = HCParams::getSidecarName(m_filename);
+    if (std::filesystem::exists(sidecar))
+        params.readFile(sidecar);
+    getValueFromRange(wb, MAX_WL_NAME,        MAX_WL_DEF,         params );
+    getValueFromRange(wb, DELTA_WL_NAME,      DELTA_WL_DEF,       params );
+    getValueFromRange(wb, MAX_ANGLE_NAME,     MAX_ANGLE_DEF,      params );
+    getValueFromRange(wb, DELTA_ANGLE_NAME,   DELTA_ANGLE_DEF,    params );
+    getValueFromRange(wb, MAX_DISPL_NAME,     /*MAX_DISPL_DEF*/
+                        getDefaultMaxDispl(params.get(MAX_WL_NAME, MAX_WL_DEF)), params );
+    getValueFromRange(wb, DELTA_DISPL_NAME,   DELTA_DISPL_DEF,    params );
+    getValueFromRange(wb, D_SW_NAME,          D_SW_DEF,           params );
+    setParams(params);
 
     doc.close();
+    m_loadTime = load.elapsed();
 }
 
-HCLoader:: ~HCLoader()
+HCLoader::HCLoader(HCHull hull, const HCParams& params):m_hull(std::move(hull))
 {
-    m_hull.clear();
+    HCMetrics::Phase load(nullptr, HC_PHASE_LOAD);
+
+    for (size_t i = 0; i < m_hull.size(); ++i)
+        checkMinMax(m_hull.getVertices(i), m_hull.getVertexCount(i));
+    setShapeKernels(true);
+    setParams(params);
+    m_loadTime = load.elapsed();
 }
 
+HCLoader:: ~HCLoader() = default;
+
 void HCLoader::writeToWorkbook()
 {
+    if (m_output.empty())
+        throw std::runtime_error("No output workbook for the results");
+    {
+        HCMetrics::Phase phase(m_metrics.get(), HC_PHASE_WRITE);
+        saveWorkbook();
+    }
+    if (m_metrics)
+        writeMetrics();
+}
+
+void HCLoader::saveWorkbook()
+{
+    // Only the headers and the tables go through the workbook DOM, the
+    // data rows are streamed afterwards into the saved file
+    std::vector<std::vector<double>> hydroColumns = getHydroColumns();
+    std::vector<std::vector<double>> KNColumns = getKNColumns();
+    const size_t nHydro = hydroColumns[0].size();
+    const size_t nKN = KNColumns[0].size();
+
+    // The results go in the output workbook, a copy of the input one if any
+    namespace fs = std::filesystem;
+    const bool inputWorkbook = !m_filename.empty()
+                            && HCHullFile::getFormat(m_filename) == HCHullFormat::Workbook;
+    std::error_code ec; // the output may not exist yet
+    if (inputWorkbook && !fs::equivalent(m_filename, m_output, ec))
+        fs::copy_file(m_filename, m_output, fs::copy_options::overwrite_existing);
+
     XLDocument doc;
-    doc.open(m_filename);
+    if (fs::exists(m_output))
+        doc.open(m_output);
+    else
+        doc.create(m_output);
     XLWorkbook wb = doc.workbook();
     
 
@@ -83,8 +232,8 @@ void HCLoader::writeToWorkbook()
     
     auto wksHydro = wb.addWorksheet(HYDRO_SHEET_NAME);
     wksHydro.setTabColor(OpenXLSX::XLColor("C00000"));
-    writeHydroTable(wksHydro);
-    OpenXLSX::XLCellReference bl(m_hydroTable.size() + 1, 14);
+    writeHydroHeader(wksHydro);
+    OpenXLSX::XLCellReference bl(nHydro + 1, hydroColumns.size());
     std::string ref = "A1:" + bl.address(false);
     auto tblHydro = wb.addTable(HYDRO_SHEET_NAME, HYDRO_TBL_NAME, ref );
     tblHydro.tableStyle().setStyle("TableStyleMedium2");
@@ -96,8 +245,8 @@ void HCLoader::writeToWorkbook()
     
     auto wksKN = wb.addWorksheet(KN_SHEET_NAME);
     wksKN.setTabColor(OpenXLSX::XLColor("C00000"));
-    uint32_t n = writeKNTable(wksKN);
-    OpenXLSX::XLCellReference blk(n + 1, m_KNdatas.size() + 3);
+    writeKNHeader(wksKN);
+    OpenXLSX::XLCellReference blk(nKN + 1, KNColumns.size());
     ref = "A1:" + blk.address(false);
     auto tblKN = wb.addTable(KN_SHEET_NAME, KN_TBL_NAME, ref );
     tblKN.tableStyle().setStyle("TableStyleMedium2");
@@ -112,9 +261,15 @@ void HCLoader::writeToWorkbook()
     // Save and close
     doc.save();
     doc.close();
+
+    // Stream the data rows below the headers
+    HCSheetWriter writer(m_output);
+    writer.addSheet(HYDRO_SHEET_NAME, std::move(hydroColumns));
+    writer.addSheet(KN_SHEET_NAME, std::move(KNColumns));
+    writer.write(m_scheduler.get());
 }
 
-void HCLoader::writeHydroTable(XLWorksheet& wks) const 
+void HCLoader::writeHydroHeader(XLWorksheet& wks) const 
 {
     std::vector<XLCellValue> header;
     header.emplace_back("Draught");
@@ -134,35 +289,35 @@ void HCLoader::writeHydroTable(XLWorksheet& wks) const
 
     auto headerRow = wks.row(1);
     headerRow.values() = header;
+}
 
-    std::vector<XLCellValue> rowValues;
-    for (size_t i = 0; i < m_hydroTable.size(); ++i){
-        auto row = wks.row(i+2);
-        rowValues.clear();
+std::vector<std::vector<double>> HCLoader::getHydroColumns() const
+{
+    const size_t n = m_hydroTable.size();
+    std::vector<std::vector<double>> columns(14, std::vector<double>(n));
 
+    for (size_t i = 0; i < n; ++i){
         const Hydrodata& d = m_hydroTable[i];
 
-        rowValues.emplace_back(d.Waterline);
-        rowValues.emplace_back(d.Volume);
-        rowValues.emplace_back(d.Displacement);
-        rowValues.emplace_back(d.Immersion);
-        rowValues.emplace_back(d.MCT);
-        rowValues.emplace_back(d.LCB);
-        rowValues.emplace_back(d.TCB);
-        rowValues.emplace_back(d.LCF);
-        rowValues.emplace_back(d.KMT);
-        rowValues.emplace_back(d.WaterplaneArea);
-        rowValues.emplace_back(d.RMT);
-        rowValues.emplace_back(d.RML);
-        rowValues.emplace_back(d.VCB);
-        rowValues.emplace_back(d.Lpp);
-
-        row.values() = rowValues;
+        columns[0][i]   = d.Waterline;
+        columns[1][i]   = d.Volume;
+        columns[2][i]   = d.Displacement;
+        columns[3][i]   = d.Immersion;
+        columns[4][i]   = d.MCT;
+        columns[5][i]   = d.LCB;
+        columns[6][i]   = d.TCB;
+        columns[7][i]   = d.LCF;
+        columns[8][i]   = d.KMT;
+        columns[9][i]   = d.WaterplaneArea;
+        columns[10][i]  = d.RMT;
+        columns[11][i]  = d.RML;
+        columns[12][i]  = d.VCB;
+        columns[13][i]  = d.Lpp;
     }
-
+    return columns;
 }
 
-uint32_t HCLoader::writeKNTable(XLWorksheet& wks) const 
+void HCLoader::writeKNHeader(XLWorksheet& wks) const 
 {
     // Setup and write header list
     std::vector<XLCellValue> header;
@@ -178,39 +333,57 @@ uint32_t HCLoader::writeKNTable(XLWorksheet& wks) const
         
     auto headerRow = wks.row(1);
     headerRow.values() = header;
+}
 
-    uint32_t i = 0;
-    std::vector<XLCellValue> rowValues;
-    for (double displ = 10 * m_deltaDispl ; displ < m_maxDispl; displ += m_deltaDispl ){
-        auto row = wks.row(i+2);
-        rowValues.clear();
-
-        auto wV = getWlandVol(displ);
-
-        if(wV.first != -1)
-            rowValues.emplace_back(wV.first);
-        else
-            rowValues.emplace_back("");
-    
-        if(wV.second != -1)
-            rowValues.emplace_back(wV.second);
-        else
-            rowValues.emplace_back("");
-
-        rowValues.emplace_back(displ);
-        
-        for(auto const& angle: m_KNdatas){
-            double KNval = getKNsin(angle.first, displ);
-            if(KNval == std::numeric_limits<double>::min())
-                rowValues.emplace_back("");
-            else
-                rowValues.emplace_back(KNval);
+std::vector<std::vector<double>> HCLoader::getKNColumns() const
+{
+    HCMetrics::Phase phase(m_metrics.get(), HC_PHASE_KN_INTERPOLATION);
+
+    // Draught, volume, displacement, then KN for each angle
+    std::vector<std::vector<double>> columns(3 + m_KNdatas.size());
+
+    if (!m_KNtargets.empty()) {
+        // Direct mode, the datas are computed at the displacement of each row
+        const size_t nRows = m_KNtargets.size();
+        for (auto& c : columns)
+            c.resize(nRows, HCCurves::NOT_AVAILABLE);
+
+        const auto& upright = m_KNdatas.at(ANGLE0);
+        for (size_t i = 0; i < nRows; ++i) {
+            if (upright[i].isValid) {
+                columns[0][i] = upright[i].Waterline;
+                columns[1][i] = upright[i].Volume;
+            }
+        }
+        columns[2] = m_KNtargets;
+
+        size_t a = 3;
+        for (auto const& angle: m_KNdatas) {
+            for (size_t i = 0; i < nRows; ++i)
+                if (angle.second[i].isValid)
+                    columns[a][i] = angle.second[i].KNsin;
+            ++a;
         }
+        return columns;
+    }
 
-        row.values() = rowValues;
-        ++i;
+    // Displacements of the rows, each column is then filled in one pass
+    std::vector<double>& displs = columns[2];
+    for (double displ = 10 * m_deltaDispl ; displ < m_maxDispl; displ += m_deltaDispl )
+        displs.push_back(displ);
+
+    const size_t nRows = displs.size();
+    const size_t nAngles = m_KNTable.getAngleCount();
+    for (auto& c : columns)
+        c.resize(nRows, HCCurves::NOT_AVAILABLE);
+    if (nAngles > 0) {
+        m_KNTable.fillColumn(0, HCKNTable::WATERLINE, displs.data(), nRows, columns[0].data());
+        m_KNTable.fillColumn(0, HCKNTable::VOLUME, displs.data(), nRows, columns[1].data());
     }
-    return i;
+    for (size_t a = 0; a < nAngles; ++a)
+        m_KNTable.fillColumn(a, HCKNTable::KNSIN, displs.data(), nRows, columns[3 + a].data());
+
+    return columns;
 }
 
 
@@ -236,20 +409,105 @@ void HCLoader::writeNotes(OpenXLSX::XLWorksheet& wks) const
     }
 }
 
+void HCLoader::setThreadCount(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (threads == 1)
+        m_scheduler.reset();
+    else if (!m_scheduler || m_scheduler->getThreadCount() != threads)
+        m_scheduler = std::make_unique<HCScheduler>(threads);
+}
+
+unsigned HCLoader::getThreadCount() const
+{
+    return m_scheduler ? m_scheduler->getThreadCount() : 1;
+}
+
+void HCLoader::setMetrics(bool enable)
+{
+    if (!enable) {
+        m_metrics.reset();
+    } else if (!m_metrics) {
+        m_metrics = std::make_unique<HCMetrics>();
+        m_metrics->addPhase(HC_PHASE_LOAD, m_loadTime);
+    }
+}
+
+const HCMetrics* HCLoader::getMetrics() const
+{
+    return m_metrics.get();
+}
+
+std::string HCLoader::getMetricsFile() const
+{
+    return std::filesystem::path(m_output).replace_extension(".metrics.json").string();
+}
+
+void HCLoader::writeMetrics() const
+{
+    const std::string file = getMetricsFile();
+    std::ofstream out(file);
+    m_metrics->writeJson(out, m_filename, getThreadCount());
+    if (!out)
+        HCLogError("Unable to write the metrics " + file);
+    else
+        HCLogInfo("Metrics saved in " + file);
+}
+
 void HCLoader::computeHydroTable()
 {
+    HCMetrics::Phase phase(m_metrics.get(), HC_PHASE_HYDRO_TABLE);
     double wl = m_deltaWl;
     m_hydroTable.clear();
     HCLogInfo("Starting computation of hydrotable from " + std::to_string(wl) +
                 " to " + std::to_string(m_maxWl) + " steps " + std::to_string(m_deltaWl));
+
+    const uint64_t key = m_cache ? getCacheKey(CacheTable::Hydro) : 0;
+    if (loadHydroTable(key)) {
+        buildHydroCurves();
+        return;
+    }
+
+    if (m_adaptiveTol > 0.0) {
+        computeHydroTableAdaptive();
+        storeHydroTable(key);
+        buildHydroCurves();
+        return;
+    }
     
+    if (m_scheduler) {
+        // Same levels as the serial loop below
+        size_t nSteps = 0;
+        for (double l = m_deltaWl; l <= m_maxWl; l += m_deltaWl)
+            ++nSteps;
+
+        auto base = std::make_pair(HCPoint(m_minMax.xmin-1, 0.0),
+                                   HCPoint(m_minMax.xmax+1, 0.0));
+        auto res = computeFamilies({ base }, m_deltaWl, nSteps);
+        for (const auto& item : res[0]) {
+            if (item.submerged)
+                break;
+            if (item.isValid)
+                m_hydroTable.push_back(item);
+        }
+        storeHydroTable(key);
+        buildHydroCurves();
+        return;
+    }
+
     bool finished = false;
+    std::vector<HCSectionSweep> sweeps;
+    if (m_sweepMode)
+        sweeps = buildSweeps(HCPoint(1.0, 0.0));
 
     while ((wl <= m_maxWl)&&(!finished)) {
         // waterline form left to right
         auto waterline = std::make_pair(HCPoint(m_minMax.xmin-1, wl),
                                         HCPoint(m_minMax.xmax+1, wl));
-        Hydrodata newItem = computeHydroFromWaterline(waterline);
+        Hydrodata newItem = computeHydroFromWaterline(waterline,
+                                        m_sweepMode ? &sweeps : nullptr);
         if (newItem.submerged)
             finished = true;
         else
@@ -257,189 +515,807 @@ void HCLoader::computeHydroTable()
                 m_hydroTable.push_back(newItem);
         wl += m_deltaWl;
     }
+    storeHydroTable(key);
+    buildHydroCurves();
     
 }
 
 void HCLoader::computeKNdatas()
 {
+    HCMetrics::Phase phase(m_metrics.get(), HC_PHASE_KN_SWEEP);
     double angle = ANGLE0;
     std::vector<KNdata> KNdatas;
 
     HCLogInfo("Starting computation of KN datas from " + std::to_string(angle) +
                 "° to " + std::to_string(m_maxAngle) + "° steps " + std::to_string(m_deltaAngle)+"°");
+
+    m_KNdatas.clear();
+    m_KNtargets.clear();
+    const uint64_t key = m_cache ? getCacheKey(CacheTable::KN) : 0;
+    if (loadKNdatas(key)) {
+        buildKNTable();
+        return;
+    }
+
+    if (m_directKN) {
+        computeKNdatasDirect();
+        storeKNdatas(key);
+        buildKNTable();
+        return;
+    }
     
-    while(angle <= m_maxAngle){
-        double wl = m_deltaWl; // Use for debug only
-        bool finished = false;
-        double tanPhi = tan(angle * M_PI/180);
-        HCPoint startPt = HCPoint(m_minMax.xmin - 1, -(m_minMax.xmax - m_minMax.xmin + 1) * tanPhi);
-        HCPoint endPt = HCPoint(m_minMax.xmax + 1, tanPhi);
-
-        while (!finished){ // Loop through the waterline, stops when the waterplane is null
-            //waterline from left to right
-            startPt.y += m_deltaWl;
-            endPt.y += m_deltaWl;
-            auto waterline = std::make_pair(startPt, endPt);
-            auto res = computeHydroFromWaterline(waterline);
-            if (res.submerged){
-                finished = true;
-            } else {
+    if (m_scheduler) {
+        // Same angles and base lines as the serial loop below
+        std::vector<double> angles;
+        std::vector<std::pair<HCPoint,HCPoint>> bases;
+        while(angle <= m_maxAngle){
+            double tanPhi = tan(angle * M_PI/180);
+            bases.push_back(std::make_pair(
+                    HCPoint(m_minMax.xmin - 1, -(m_minMax.xmax - m_minMax.xmin + 1) * tanPhi),
+                    HCPoint(m_minMax.xmax + 1, tanPhi)));
+            angles.push_back(angle);
+            if (angle == ANGLE0)
+                angle = m_deltaAngle;
+            else
+                angle += m_deltaAngle;
+        }
+
+        auto res = computeFamilies(bases, m_deltaWl, std::numeric_limits<size_t>::max());
+        for (size_t a = 0; a < angles.size(); ++a) {
+            for (const auto& item : res[a]) {
+                if (item.submerged)
+                    break;
                 KNdata newData;
-                
-                newData.angle = angle;
-                newData.Volume = res.Volume;
-                newData.Displacement = res.Displacement;
-                newData.Waterline = res.Waterline;
-                double My = res.TCB / tan(angle * M_PI / 180) + res.VCB;
-                newData.KNsin = My * sin (angle * M_PI / 180);
+                newData.angle = angles[a];
+                newData.Volume = item.Volume;
+                newData.Displacement = item.Displacement;
+                newData.Waterline = item.Waterline;
+                double My = item.TCB / tan(angles[a] * M_PI / 180) + item.VCB;
+                newData.KNsin = My * sin (angles[a] * M_PI / 180);
                 newData.isValid = true;
                 KNdatas.push_back(newData);
             }
-            wl += m_deltaWl;
-        } // Loop throuh waterlevel
-        if (angle == ANGLE0)
-            angle = m_deltaAngle;
-        else
-            angle += m_deltaAngle;
-    } // Loop through angle
+        }
+    } else {
+        while (angle <= m_maxAngle) {
+            double wl = m_deltaWl; // Use for debug only
+            bool finished = false;
+            double tanPhi = tan(angle * M_PI/180);
+            HCPoint startPt = HCPoint(m_minMax.xmin - 1, -(m_minMax.xmax - m_minMax.xmin + 1) * tanPhi);
+            HCPoint endPt = HCPoint(m_minMax.xmax + 1, tanPhi);
+            std::vector<HCSectionSweep> sweeps;
+            if (m_sweepMode)
+                sweeps = buildSweeps(HCPoint(endPt.x - startPt.x, endPt.y - startPt.y));
+
+            while (!finished){ // Loop through the waterline, stops when the waterplane is null
+                //waterline from left to right
+                startPt.y += m_deltaWl;
+                endPt.y += m_deltaWl;
+                auto waterline = std::make_pair(startPt, endPt);
+                auto res = computeHydroFromWaterline(waterline,
+                                            m_sweepMode ? &sweeps : nullptr);
+                if (res.submerged){
+                    finished = true;
+                } else {
+                    KNdata newData;
+                
+                    newData.angle = angle;
+                    newData.Volume = res.Volume;
+                    newData.Displacement = res.Displacement;
+                    newData.Waterline = res.Waterline;
+                    double My = res.TCB / tan(angle * M_PI / 180) + res.VCB;
+                    newData.KNsin = My * sin (angle * M_PI / 180);
+                    newData.isValid = true;
+                    KNdatas.push_back(newData);
+                }
+                wl += m_deltaWl;
+            } // Loop throuh waterlevel
+            if (angle == ANGLE0)
+                angle = m_deltaAngle;
+            else
+                angle += m_deltaAngle;
+        } // Loop through angle
+    }
 
     //  ====== Reorganise the datas
     for(auto& d: KNdatas){
         m_KNdatas[d.angle].push_back(d);
     }
+    storeKNdatas(key);
+    buildKNTable();
 
 }
 
 
-std::pair<double,double> HCLoader::getWlandVol(double displ) const
+void HCLoader::computeHydroTableAdaptive()
 {
-    if (displ < m_KNdatas.at(ANGLE0)[0].Displacement){
-        // interpolation to 0
-        double b = displ  / m_KNdatas.at(ANGLE0)[0].Displacement;
-        return std::make_pair( b * m_KNdatas.at(ANGLE0)[0].Waterline, 
-                             b * m_KNdatas.at(ANGLE0)[0].Volume);
+    // Same levels as the serial loop of computeHydroTable
+    std::vector<double> levels;
+    for (double l = m_deltaWl; l <= m_maxWl; l += m_deltaWl)
+        levels.push_back(l);
+    if (levels.empty())
+        return;
+    const size_t n = levels.size();
+
+    std::vector<HCSectionSweep> sweeps;
+    if (m_sweepMode)
+        sweeps = buildSweeps(HCPoint(1.0, 0.0));
+
+    // Computed waterlines, key: index of the level
+    std::map<size_t,Hydrodata> rows;
+    auto evaluate = [&](const std::vector<size_t>& indices){
+        std::vector<Hydrodata> res(indices.size());
+        auto compute = [&](size_t b, size_t e){
+            for (size_t k = b; k < e; ++k) {
+                auto waterline = std::make_pair(HCPoint(m_minMax.xmin-1, levels[indices[k]]),
+                                                HCPoint(m_minMax.xmax+1, levels[indices[k]]));
+                res[k] = computeHydroFromWaterline(waterline, m_sweepMode ? &sweeps : nullptr);
+            }
+        };
+        if (m_scheduler)
+            m_scheduler->parallelFor(0, indices.size(), 1, compute);
+        else
+            compute(0, indices.size());
+        for (size_t k = 0; k < indices.size(); ++k)
+            rows[indices[k]] = res[k];
+    };
+    // 0: dry, 1: valid, 2: submerged
+    auto state = [&](size_t i){
+        const Hydrodata& d = rows.at(i);
+        return d.submerged ? 2 : (d.isValid ? 1 : 0);
+    };
+    // First level of a state at least, by bisection between the computed ones
+    auto findFirst = [&](int minState){
+        auto hi = std::find_if(rows.begin(), rows.end(),
+                        [&](const auto& r){ return state(r.first) >= minState; });
+        if (hi == rows.end())
+            return n;
+        if (hi == rows.begin())
+            return hi->first;
+        size_t lo = std::prev(hi)->first;
+        size_t first = hi->first;
+        while (first - lo > 1) {
+            size_t mid = (lo + first) / 2;
+            evaluate({ mid });
+            if (state(mid) >= minState)
+                first = mid;
+            else
+                lo = mid;
+        }
+        return first;
+    };
+
+    std::vector<size_t> coarse;
+    for (size_t i = 0; i < n; i += ADAPTIVE_MAX_STEP)
+        coarse.push_back(i);
+    if (coarse.back() != n - 1)
+        coarse.push_back(n - 1);
+    evaluate(coarse);
+
+    const size_t end = findFirst(2);
+    const size_t begin = findFirst(1);
+    if (begin < end) {
+        if (!rows.count(end - 1))
+            evaluate({ end - 1 });
+
+        // Intervals to be checked at their middle, halved until the
+        // middle is predicted within the tolerance
+        std::vector<std::pair<size_t,size_t>> pending;
+        for (auto it = rows.lower_bound(begin); it != rows.end() && it->first < end - 1; ++it)
+            if (std::next(it)->first - it->first > 1)
+                pending.emplace_back(it->first, std::next(it)->first);
+
+        while (!pending.empty()) {
+            std::vector<size_t> mids;
+            for (const auto& [a, b] : pending)
+                mids.push_back((a + b) / 2);
+            evaluate(mids);
+
+            std::vector<std::pair<size_t,size_t>> next;
+            for (const auto& [a, b] : pending) {
+                const size_t m = (a + b) / 2;
+                const Hydrodata& c = rows[m];
+                const Hydrodata& ra = rows[a];
+                const Hydrodata& rb = rows[b];
+                bool accepted = c.isValid && !c.submerged && ra.isValid && rb.isValid;
+                if (accepted) {
+                    Hydrodata p = interpolateHydro(ra, rb, c.Waterline, m_d_sw);
+                    accepted = relativeError(p.Volume, c.Volume) <= m_adaptiveTol
+                                && relativeError(p.KMT, c.KMT) <= m_adaptiveTol
+                                && integralError(ra, c) <= m_adaptiveTol
+                                && integralError(c, rb) <= m_adaptiveTol;
+                }
+                if (accepted)
+                    continue;
+                if (m - a > 1)
+                    next.emplace_back(a, m);
+                if (b - m > 1)
+                    next.emplace_back(m, b);
+            }
+            pending.swap(next);
+        }
     }
 
-    for (auto it = std::begin(m_KNdatas.at(ANGLE0)); it != std::end(m_KNdatas.at(ANGLE0)); ++it){
-        auto next = std::next(it);
-        if (next != std::end(m_KNdatas.at(ANGLE0))){
-            if (((*it).Displacement < displ ) && (displ <= (*next).Displacement )){
-                double div = ((*next).Displacement - (*it).Displacement);
-                if(div == 0.0){
-                    HCLogError("Error, 2 waterline gave the same Displacement");
-                    return std::make_pair(-1.0,-1.0); // y = -1 impossible
-                }
+    // Rows of the uniform levels, interpolated between the nearest
+    // computed waterlines
+    for (size_t i = begin; i < end; ++i) {
+        auto hi = rows.lower_bound(i);
+        if (hi->first == i) {
+            if (hi->second.isValid)
+                m_hydroTable.push_back(hi->second);
+            continue;
+        }
+        m_hydroTable.push_back(interpolateHydro(std::prev(hi)->second, hi->second,
+                                                levels[i], m_d_sw));
+    }
+
+    HCLogInfo("Hydrotable of " + std::to_string(m_hydroTable.size()) + " rows from " +
+                std::to_string(rows.size()) + " waterline computations");
+}
+
+void HCLoader::computeKNdatasDirect()
+{
+    // Same displacements as the rows of the KN table
+    for (double displ = 10 * m_deltaDispl ; displ < m_maxDispl; displ += m_deltaDispl )
+        m_KNtargets.push_back(displ);
+
+    // Same angles as the stepped computation
+    std::vector<double> angles;
+    double angle = ANGLE0;
+    while(angle <= m_maxAngle){
+        angles.push_back(angle);
+        if (angle == ANGLE0)
+            angle = m_deltaAngle;
+        else
+            angle += m_deltaAngle;
+    }
+
+    // Angles are independent, each one warm starts from its
+    // previous displacement, so the results don't depend on the threads
+    std::vector<std::vector<KNdata>> res(angles.size());
+    std::vector<size_t> evaluations(angles.size(), 0);
+    auto solve = [&](size_t b, size_t e){
+        for (size_t a = b; a < e; ++a)
+            res[a] = solveKNAngle(angles[a], evaluations[a]);
+    };
+    if (m_scheduler)
+        m_scheduler->parallelFor(0, angles.size(), 1, solve);
+    else
+        solve(0, angles.size());
+
+    size_t total = 0;
+    for (size_t a = 0; a < angles.size(); ++a) {
+        total += evaluations[a];
+        m_KNdatas[angles[a]] = std::move(res[a]);
+    }
+
+    HCLogInfo("KN solved at " + std::to_string(m_KNtargets.size()) + " displacements for " +
+                std::to_string(angles.size()) + " angles with " + std::to_string(total) +
+                " waterline computations");
+}
 
-                double a = ((*next).Displacement - displ) / div;
-                double b = (displ -  (*it).Displacement) / div;
-                return std::make_pair( a * (*it).Waterline + b * (*next).Waterline, 
-                                        a * (*it).Volume + b * (*next).Volume);
+std::vector<KNdata> HCLoader::solveKNAngle(double angle, size_t& evaluations) const
+{
+    std::vector<KNdata> res(m_KNtargets.size());
+
+    const double tanPhi = tan(angle * M_PI/180);
+    const double cosPhi = cos(angle * M_PI/180);
+    const auto base = std::make_pair(
+                    HCPoint(m_minMax.xmin - 1, -(m_minMax.xmax - m_minMax.xmin + 1) * tanPhi),
+                    HCPoint(m_minMax.xmax + 1, tanPhi));
+    const double dx = base.second.x - base.first.x;
+
+    std::vector<HCSectionSweep> sweeps;
+    if (m_sweepMode)
+        sweeps = buildSweeps(HCPoint(dx, base.second.y - base.first.y));
+
+    auto evaluate = [&](double shift){
+        ++evaluations;
+        auto waterline = std::make_pair(HCPoint(base.first.x, base.first.y + shift),
+                                        HCPoint(base.second.x, base.second.y + shift));
+        return computeHydroFromWaterline(waterline, m_sweepMode ? &sweeps : nullptr);
+    };
+
+    // A vertex at vertical distance h above the base line is wet for a shift
+    // greater than h: the hull is dry below sDry, and the stepped computation
+    // stops as soon as a section is submerged, at sSubmerged
+    double sDry = std::numeric_limits<double>::max();
+    double sSubmerged = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        const HCPoint* vertices = m_hull.getVertices(i);
+        double hMax = std::numeric_limits<double>::lowest();
+        for (size_t j = 0; j < m_hull.getVertexCount(i); ++j) {
+            double h = distPtToSegment(base, vertices[j]) / dx;
+            sDry = std::min(sDry, h);
+            hMax = std::max(hMax, h);
+        }
+        sSubmerged = std::min(sSubmerged, hMax);
+    }
+    if (m_hull.empty() || !(sSubmerged > sDry))
+        return res;
+
+    Hydrodata upper = evaluate(sSubmerged);
+    const double maxDispl = upper.Volume * m_d_sw;
+    const double width = sSubmerged - sDry;
+
+    double lastShift = sDry;
+    double lastDispl = 0.0;
+    double lastSlope = 0.0;     // d(displacement)/d(shift) at the last solution
+    double prevDispl = 0.0;
+    double prevSlope = 0.0;     // at the solution before
+    for (size_t t = 0; t < m_KNtargets.size(); ++t) {
+        const double target = m_KNtargets[t];
+        if (!(target < maxDispl))
+            break; // and the following, in increasing order
+
+        // Bracket of the root, the displacement increases with the shift
+        double a = lastShift;
+        double b = sSubmerged;
+
+        // Warm start, the shift as function of the displacement is extrapolated
+        // from the last solution, to second order with the one before
+        double s = a + (b - a) * (target - lastDispl) / (maxDispl - lastDispl);
+        if (lastSlope > 0.0) {
+            double h = target - lastDispl;
+            s = lastShift + h / lastSlope;
+            if (prevSlope > 0.0 && lastDispl > prevDispl)
+                s += h * h * (1 / lastSlope - 1 / prevSlope) / (lastDispl - prevDispl) / 2;
+        }
+        if (!(s > a && s < b))
+            s = (a + b) / 2;
+
+        Hydrodata item;
+        double slope = 0.0;
+        for (int iter = 0; iter < 100; ++iter) {
+            item = evaluate(s);
+            double f = item.Volume * m_d_sw - target;
+            slope = item.WaterplaneArea * cosPhi * m_d_sw;
+            if (std::abs(f) <= 1e-9 * target)
+                break;
+            if (f < 0)
+                a = s;
+            else
+                b = s;
+            if (b - a <= 1e-13 * width)
+                break;
+
+            // Newton step, bisection if it leaves the bracket
+            double next = (a + b) / 2;
+            if (slope > 0.0) {
+                double newton = s - f / slope;
+                if (newton > a && newton < b)
+                    next = newton;
             }
+            s = next;
         }
+
+        if (!item.isValid || item.submerged)
+            break;
+
+        KNdata& newData = res[t];
+        newData.angle = angle;
+        newData.Volume = item.Volume;
+        newData.Displacement = item.Displacement;
+        newData.Waterline = item.Waterline;
+        double My = item.TCB / tan(angle * M_PI / 180) + item.VCB;
+        newData.KNsin = My * sin (angle * M_PI / 180);
+        newData.isValid = true;
+
+        prevDispl = lastDispl;
+        prevSlope = lastSlope;
+        lastShift = s;
+        lastDispl = item.Volume * m_d_sw;
+        lastSlope = slope;
     }
 
-    return std::make_pair(-1.0,-1.0); // y = -1 impossible
+    return res;
 }
 
-double HCLoader::getKNsin(double angle, double displ) const
+void HCLoader::setCache(std::shared_ptr<HCResultCache> cache)
 {
-    const auto& vect = m_KNdatas.at(angle);
+    m_cache = std::move(cache);
+    if (!m_cache)
+        return;
+
+    // The hull doesn't change after loading, hashed once
+    HCCacheKey key;
+    uint64_t nSections = m_hull.size();
+    key.add(nSections);
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        uint64_t n = m_hull.getVertexCount(i);
+        key.add(m_hull.getStationX(i)).add(n);
+        key.add(m_hull.getVertices(i), n * sizeof(HCPoint));
+    }
+    m_hullKey = key.value();
+}
 
-    // Angle value don't exists
-    if (vect.empty())
-        return std::numeric_limits<double>::min();
-    
-    if (displ < vect[0].Displacement){
-        // interpolation to 0
-        double b = displ  / vect[0].Displacement;
-        return  b * vect[0].KNsin;
-    }
-
-    // Interpolation
-    for (auto it = std::begin(vect); it != std::end(vect); ++it){
-        auto next = std::next(it);
-        if (next != std::end(vect)){
-            if (((*it).Displacement < displ ) && (displ <= (*next).Displacement )){
-                double div = ((*next).Displacement - (*it).Displacement);
-                if(div == 0.0){
-                    HCLogError("Error, 2 waterline gave the same Displacement");
-                    return std::numeric_limits<double>::min();
-                }
+uint64_t HCLoader::getCacheKey(CacheTable table) const
+{
+    HCCacheKey key;
+    key.add(HCResultCache::VERSION).add(table).add(m_hullKey);
+    key.add(m_deltaWl).add(m_d_sw).add(m_sweepMode).add(m_scalar).add(!m_shapes.empty());
+
+    // Chunked sections sum in another order
+    uint64_t grain = m_scheduler ? m_sectionGrain : 0;
+    key.add(grain);
+
+    if (table == CacheTable::Hydro) {
+        key.add(m_maxWl).add(m_adaptiveTol);
+    } else {
+        key.add(m_maxAngle).add(m_deltaAngle).add(m_directKN);
+        if (m_directKN) // the targets of the table
+            key.add(m_maxDispl).add(m_deltaDispl);
+    }
+    return key.value();
+}
+
+bool HCLoader::loadHydroTable(uint64_t key)
+{
+    std::vector<double> values;
+    if (!m_cache)
+        return false;
+    if (!m_cache->load(key, values) || values.size() % HYDRO_CACHE_VALUES != 0) {
+        HCLogInfo("Cache miss for the hydrotable of " + m_filename);
+        return false;
+    }
 
-                double a = ((*next).Displacement - displ) / div;
-                double b = (displ -  (*it).Displacement) / div;
-                return (a * (*it).KNsin + b * (*next).KNsin);
+    m_hydroTable.resize(values.size() / HYDRO_CACHE_VALUES);
+    const double* v = values.data();
+    for (auto& d : m_hydroTable) {
+        d.RMT = v[0];   d.RML = v[1];   d.Lpp = v[2];   d.LCF = v[3];
+        d.MCT = v[4];   d.LCB = v[5];   d.TCB = v[6];   d.VCB = v[7];
+        d.KMT = v[8];   d.Waterline = v[9];     d.Volume = v[10];
+        d.Displacement = v[11];     d.WaterplaneArea = v[12];   d.Immersion = v[13];
+        d.isValid = (static_cast<int>(v[14]) & 1) != 0;
+        d.submerged = (static_cast<int>(v[14]) & 2) != 0;
+        v += HYDRO_CACHE_VALUES;
+    }
+    HCLogInfo("Cache hit for the hydrotable of " + m_filename);
+    return true;
+}
+
+void HCLoader::storeHydroTable(uint64_t key) const
+{
+    if (!m_cache)
+        return;
+
+    std::vector<double> values;
+    values.reserve(m_hydroTable.size() * HYDRO_CACHE_VALUES);
+    for (const auto& d : m_hydroTable) {
+        values.insert(values.end(), { d.RMT, d.RML, d.Lpp, d.LCF, d.MCT, d.LCB,
+                                    d.TCB, d.VCB, d.KMT, d.Waterline, d.Volume,
+                                    d.Displacement, d.WaterplaneArea, d.Immersion,
+                                    static_cast<double>((d.isValid ? 1 : 0) | (d.submerged ? 2 : 0)) });
+    }
+    m_cache->store(key, values);
+}
+
+bool HCLoader::loadKNdatas(uint64_t key)
+{
+    std::vector<double> values;
+    if (!m_cache)
+        return false;
+
+    // Number of targets, targets, then for each angle: angle, number
+    // of datas, and 5 values and the flag per data
+    bool valid = m_cache->load(key, values);
+    size_t pos = 0;
+    auto next = [&](){ return pos < values.size() ? values[pos++] : (valid = false, 0.0); };
+    if (valid) {
+        size_t nTargets = static_cast<size_t>(next());
+        for (size_t t = 0; t < nTargets && valid; ++t)
+            m_KNtargets.push_back(next());
+        while (valid && pos < values.size()) {
+            double angle = next();
+            size_t n = static_cast<size_t>(next());
+            valid = valid && n <= (values.size() - pos) / 6;
+            auto& datas = m_KNdatas[angle];
+            datas.resize(valid ? n : 0);
+            for (auto& d : datas) {
+                d.angle = next();
+                d.Waterline = next();
+                d.Volume = next();
+                d.Displacement = next();
+                d.KNsin = next();
+                d.isValid = next() != 0.0;
             }
         }
     }
+    if (!valid) {
+        m_KNdatas.clear();
+        m_KNtargets.clear();
+        HCLogInfo("Cache miss for the KN datas of " + m_filename);
+        return false;
+    }
+    HCLogInfo("Cache hit for the KN datas of " + m_filename);
+    return true;
+}
 
-    // Not found
-    return std::numeric_limits<double>::min();
+void HCLoader::storeKNdatas(uint64_t key) const
+{
+    if (!m_cache)
+        return;
+
+    std::vector<double> values;
+    values.push_back(static_cast<double>(m_KNtargets.size()));
+    values.insert(values.end(), m_KNtargets.begin(), m_KNtargets.end());
+    for (const auto& [angle, datas] : m_KNdatas) {
+        values.push_back(angle);
+        values.push_back(static_cast<double>(datas.size()));
+        for (const auto& d : datas)
+            values.insert(values.end(), { d.angle, d.Waterline, d.Volume, d.Displacement,
+                                        d.KNsin, d.isValid ? 1.0 : 0.0 });
+    }
+    m_cache->store(key, values);
 }
 
+void HCLoader::buildKNTable()
+{
+    HCMetrics::Phase phase(m_metrics.get(), HC_PHASE_KN_INTERPOLATION);
+    m_KNTable.clear();
+    for (const auto& [angle, datas] : m_KNdatas) {
+        size_t a = m_KNTable.addAngle(angle);
+        for (const auto& d : datas) {
+            if (d.isValid)
+                m_KNTable.append(a, d.Displacement, d.KNsin, d.Waterline, d.Volume);
+        }
+    }
+}
 
-Hydrodata HCLoader::computeHydroFromWaterline(const std::pair<HCPoint,HCPoint>& waterline )
+void HCLoader::buildHydroCurves()
 {
-    Hydrodata hydro;
-    if (waterline.second.x == waterline.first.x){
-        HCLogError("Error computing table : waterline is vertical");
-        return hydro;
+    m_hydroCurves.clear();
+    m_hydroCurves.reserve(m_hydroTable.size());
+    for (const auto& d : m_hydroTable) {
+        const double values[HC_NB_COLUMNS] = {
+            d.Volume, d.Displacement, d.Immersion, d.MCT, d.LCB, d.TCB, d.LCF,
+            d.KMT, d.WaterplaneArea, d.RMT, d.RML, d.VCB, d.Lpp };
+        m_hydroCurves.append(d.Waterline, values);
     }
-    hydro.Waterline = waterline.first.y - (waterline.second.y - waterline.first.y) / 
-                        (waterline.second.x - waterline.first.x) * waterline.first.x;
-    double elmtLength = 0.0;
-    uint32_t nLCF = 0;
-    for (auto it = m_hull.begin(); it != m_hull.end(); ++it) {
-        
-        // the length of the last element will be the same as the n-1 one
-        auto next = std::next(it);
-        if (next != m_hull.end())
-            elmtLength = std::abs(next->first - it->first);
-
-        HCPolygonSplitter split(it->second, waterline);
-        auto wetSection = split.getPolygonFromSide(LineSide::Right);
-        auto drySection = split.getPolygonFromSide(LineSide::Left);
-        
-        if (drySection.empty())
-            hydro.submerged = true;
+}
 
-        auto wetEdge = split.getEdges();
+const HCKNTable& HCLoader::getKNTable() const
+{
+    return m_KNTable;
+}
 
-        double eltVol = wetSection.getArea() * elmtLength;
-        double xelt = (*it).first + elmtLength / 2;
+const std::vector<Hydrodata>& HCLoader::getHydroTable() const
+{
+    return m_hydroTable;
+}
 
-        hydro.LCB += xelt * eltVol;
-        hydro.TCB += wetSection.getCog().x * eltVol;
-        hydro.VCB += wetSection.getCog().y * eltVol;
+const std::map<double,std::vector<KNdata>>& HCLoader::getKNdatas() const
+{
+    return m_KNdatas;
+}
 
-        hydro.Volume += eltVol;
-        hydro.Lpp += elmtLength;
+const HCCurves& HCLoader::getHydroCurves() const
+{
+    return m_hydroCurves;
+}
 
-        // Compute for each edge of the waterline cut the lentgh and the inertia
-        double interLength = 0.0;
-        for(const auto& s : wetEdge){
-            interLength += s.first.distanceTo(s.second);
-            HCPoint midSectionPt = HCPoint( (s.first.x + s.second.x) / 2,
-                                           (s.first.y + s.second.y) / 2 );
-            // Transport the inertia at x = 0 waterline
-            double dt = midSectionPt.distanceTo(HCPoint( 0.0, hydro.Waterline ));
-            hydro.RMT += elmtLength * pow(interLength, 3) /12 +
-                        (interLength * elmtLength) * pow(dt, 2);
-        }
 
-        hydro.RML += interLength * pow(elmtLength, 3) / 12 + (interLength * elmtLength) * pow(xelt, 2);
-        hydro.WaterplaneArea += interLength * elmtLength;
+std::vector<std::vector<Hydrodata>> HCLoader::computeFamilies(
+                        const std::vector<std::pair<HCPoint,HCPoint>>& bases,
+                        double step, size_t maxSteps) const
+{
+    struct Family
+    {
+        std::vector<std::pair<HCPoint,HCPoint>> lines;
+        std::vector<Hydrodata>                  results;
+        size_t                                  target;
+        bool                                    finished;
+        std::vector<HCSectionSweep>             sweeps;
+    };
+
+    std::vector<Family> families;
+    for (const auto& base : bases) {
+        size_t target = std::min(maxSteps, estimateSubmergedStep(base, step) + 1);
+        families.push_back({ { base }, {}, target, target == 0, {} });
+    }
 
-        if (wetSection.getArea() != 0){
-            if (nLCF == 0){
-                hydro.LCF += (*it).first;
-                nLCF += 1;
+    if (m_sweepMode) {
+        m_scheduler->parallelFor(0, families.size(), 1, [&](size_t b, size_t e){
+            for (size_t f = b; f < e; ++f) {
+                const auto& base = families[f].lines[0];
+                families[f].sweeps = buildSweeps(HCPoint(base.second.x - base.first.x,
+                                                        base.second.y - base.first.y));
             }
-            hydro.LCF += (*it).first + elmtLength;
-            nLCF +=1;
+        });
+    }
+
+    // Compute by waves, each family up to its target. If the hull is not
+    // submerged at the target (estimate too short), extend the target
+    bool finished = false;
+    while (!finished) {
+        std::vector<std::pair<size_t,size_t>> jobs; // family, step index
+        for (size_t f = 0; f < families.size(); ++f) {
+            Family& fam = families[f];
+            if (fam.finished)
+                continue;
+            // lines are accumulated as in the serial loops
+            while (fam.lines.size() <= fam.target) {
+                auto next = fam.lines.back();
+                next.first.y += step;
+                next.second.y += step;
+                fam.lines.push_back(next);
+            }
+            size_t first = fam.results.size();
+            fam.results.resize(fam.target);
+            for (size_t i = first; i < fam.target; ++i)
+                jobs.emplace_back(f, i);
         }
 
-    } // Section Loop
+        m_scheduler->parallelFor(0, jobs.size(), 1, [&](size_t b, size_t e){
+            for (size_t j = b; j < e; ++j) {
+                Family& fam = families[jobs[j].first];
+                size_t i = jobs[j].second;
+                fam.results[i] = computeHydroFromWaterline(fam.lines[i + 1],
+                                            m_sweepMode ? &fam.sweeps : nullptr);
+            }
+        });
+
+        finished = true;
+        for (auto& fam : families) {
+            if (fam.finished)
+                continue;
+            auto it = std::find_if(fam.results.begin(), fam.results.end(),
+                                    [](const Hydrodata& d){ return d.submerged; });
+            if (it != fam.results.end()) {
+                fam.results.erase(std::next(it), fam.results.end());
+                fam.finished = true;
+            } else if (fam.target >= maxSteps) {
+                fam.finished = true;
+            } else {
+                fam.target = std::min(maxSteps, fam.target + std::max<size_t>(4, fam.target / 4));
+                finished = false;
+            }
+        }
+    }
+
+    std::vector<std::vector<Hydrodata>> res;
+    for (auto& fam : families)
+        res.push_back(std::move(fam.results));
+    return res;
+}
+
+size_t HCLoader::estimateSubmergedStep(const std::pair<HCPoint,HCPoint>& base,
+                                    double step) const
+{
+    // Shifting the line by step reduce the distance of any point
+    // by step * (xend - xstart). A section is submerged when no
+    // vertex remains on the left side
+    double scale = (base.second.x - base.first.x) * step;
+    if (scale <= 0.0)
+        return 1;
+
+    double kMin = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        const HCPoint* vertices = m_hull.getVertices(i);
+        double kSection = std::numeric_limits<double>::lowest();
+        for (size_t j = 0; j < m_hull.getVertexCount(i); ++j)
+            kSection = std::max(kSection, (distPtToSegment(base, vertices[j]) - 1e-8) / scale);
+        kMin = std::min(kMin, kSection);
+    }
+
+    if (kMin < 1.0)
+        return 1;
+    if (kMin > 1e9)
+        return 1000000000;
+    return static_cast<size_t>(std::ceil(kMin));
+}
+
+void HCLoader::setSectionGrain(size_t grain)
+{
+    m_sectionGrain = grain;
+}
+
+void HCLoader::setSweepMode(bool sweep)
+{
+    m_sweepMode = sweep;
+}
+
+void HCLoader::setScalar(HCScalar scalar)
+{
+    m_scalar = scalar;
+    m_floatPoints.clear();
+    if (m_scalar != HCScalar::Float)
+        return;
+
+    m_floatPoints.reserve(m_hull.getTotalVertexCount());
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        const HCPoint* vertices = m_hull.getVertices(i);
+        for (size_t j = 0; j < m_hull.getVertexCount(i); ++j)
+            m_floatPoints.emplace_back(vertices[j]);
+    }
+}
+
+void HCLoader::setShapeKernels(bool enable)
+{
+    if (enable == !m_shapes.empty())
+        return; // classified at load
+    m_shapes.clear();
+    if (!enable)
+        return;
+
+    size_t count[3] = { 0, 0, 0 };
+    m_shapes.reserve(m_hull.size());
+    for (size_t i = 0; i < m_hull.size(); ++i) {
+        m_shapes.emplace_back(m_hull.getVertices(i), m_hull.getVertexCount(i));
+        ++count[static_cast<size_t>(m_shapes.back().getShape())];
+    }
+    HCLogInfo("Sections: " + std::to_string(count[static_cast<size_t>(HCShape::Rectangle)])
+                + " rectangle, " + std::to_string(count[static_cast<size_t>(HCShape::Convex)])
+                + " convex, " + std::to_string(count[static_cast<size_t>(HCShape::General)])
+                + " general");
+}
+
+void HCLoader::setDirectKN(bool direct)
+{
+    m_directKN = direct;
+}
+
+void HCLoader::setAdaptiveTolerance(double tolerance)
+{
+    m_adaptiveTol = std::max(0.0, tolerance);
+}
+
+std::vector<HCSectionSweep> HCLoader::buildSweeps(const HCPoint& direction) const
+{
+    std::vector<HCSectionSweep> sweeps;
+    sweeps.reserve(m_hull.size());
+    for (size_t i = 0; i < m_hull.size(); ++i)
+        sweeps.emplace_back(m_hull.getVertices(i), m_hull.getVertexCount(i), direction);
+    return sweeps;
+}
+
+Hydrodata HCLoader::computeHydroFromWaterline(const std::pair<HCPoint,HCPoint>& waterline,
+                                        const std::vector<HCSectionSweep>* sweeps) const
+{
+    HCMetrics::add(HC_WATERLINES);
+    Hydrodata hydro;
+    if (waterline.second.x == waterline.first.x){
+        HCLogError("Error computing table : waterline is vertical");
+        return hydro;
+    }
+    hydro.Waterline = waterline.first.y - (waterline.second.y - waterline.first.y) / 
+                        (waterline.second.x - waterline.first.x) * waterline.first.x;
+
+    // The temporaries of this waterline are released on return, the
+    // section cuts reuse their per thread buffers
+    HCArena::Scope scope;
+
+    SectionSums sums;
+    const size_t nSections = m_hull.size();
+    if (m_scheduler && m_sectionGrain > 0 && nSections > m_sectionGrain) {
+        // Each chunk of sections is accumulated independently, then merged in order
+        const size_t nChunks = (nSections + m_sectionGrain - 1) / m_sectionGrain;
+        std::pmr::vector<SectionSums> partials(nChunks, &HCArena::local());
+        auto accumulate = [&](size_t b, size_t e){
+            for (size_t c = b; c < e; ++c)
+                accumulateSections(c * m_sectionGrain,
+                                    std::min(nSections, (c + 1) * m_sectionGrain),
+                                    waterline, hydro.Waterline, sweeps, partials[c]);
+        };
+        // By reference, the std::function doesn't allocate
+        m_scheduler->parallelFor(0, nChunks, 1, std::ref(accumulate));
+        for (const auto& p : partials)
+            mergeSums(sums, p);
+    } else {
+        accumulateSections(0, nSections, waterline, hydro.Waterline, sweeps, sums);
+    }
+
+    uint32_t nLCF = sums.nLCF;
+    hydro.LCB = sums.hydro.LCB;
+    hydro.TCB = sums.hydro.TCB;
+    hydro.VCB = sums.hydro.VCB;
+    hydro.LCF = sums.hydro.LCF;
+    hydro.RMT = sums.hydro.RMT;
+    hydro.RML = sums.hydro.RML;
+    hydro.Volume = sums.hydro.Volume;
+    hydro.Lpp = sums.hydro.Lpp;
+    hydro.WaterplaneArea = sums.hydro.WaterplaneArea;
+    hydro.submerged = sums.hydro.submerged;
 
     // If null don't save the data
     if ((nLCF == 0 )|| (hydro.Volume == 0.0))
@@ -462,28 +1338,289 @@ Hydrodata HCLoader::computeHydroFromWaterline(const std::pair<HCPoint,HCPoint>&
 
 }
 
-double HCLoader::getValueFromRange(const OpenXLSX::XLWorkbook& wb,
+Hydrodata HCLoader::computeHydro(double draught, double heel) const
+{
+    const double t = tan(heel * M_PI / 180);
+    return computeHydroFromWaterline(std::make_pair(
+                    HCPoint(m_minMax.xmin - 1, draught + (m_minMax.xmin - 1) * t),
+                    HCPoint(m_minMax.xmax + 1, draught + (m_minMax.xmax + 1) * t)));
+}
+
+HCFloatingPosition HCLoader::solveEquilibrium(const HCLoadCondition& condition)
+{
+    if (!m_equilibrium)
+        m_equilibrium = std::make_unique<HCEquilibrium>(m_hull, m_d_sw);
+    return m_equilibrium->solve(condition);
+}
+
+std::vector<HCFloatingPosition> HCLoader::solveEquilibrium(
+                                const std::vector<HCLoadCondition>& conditions)
+{
+    if (!m_equilibrium)
+        m_equilibrium = std::make_unique<HCEquilibrium>(m_hull, m_d_sw);
+    return m_equilibrium->solve(conditions);
+}
+
+void HCLoader::accumulateSections(size_t first, size_t last,
+                                const std::pair<HCPoint,HCPoint>& waterline,
+                                double wl, const std::vector<HCSectionSweep>* sweeps,
+                                SectionSums& sums) const
+{
+    if (sweeps && !sweeps->empty()) {
+        // Sweeps parameters: waterline offset, inertia reference and
+        // the tolerance of HCPolygonSplitter to consider a point on the line
+        const HCSectionSweep& sw = sweeps->front();
+        const double c = sw.offset(waterline.first);
+        const double u0 = sw.abscissa(HCPoint(0.0, wl));
+        const double tolerance = 1e-8 / waterline.first.distanceTo(waterline.second);
+        accumulateCuts(first, last, sums, [&](size_t i){
+            return (*sweeps)[i].cut(c, u0, tolerance);
+        });
+        return;
+    }
+
+    // The kernels are chosen once per waterline: the upright ones,
+    // the whole hydrostatic table, compare the y of the vertices only
+    const bool horizontal = waterline.first.y == waterline.second.y
+                            && waterline.first.x < waterline.second.x;
+    if (!m_floatPoints.empty()) {
+        const std::pair<HCPointF,HCPointF> line(HCPointF(waterline.first),
+                                                HCPointF(waterline.second));
+        if (horizontal)
+            accumulateCuts(first, last, sums, [&](size_t i){
+                return clipSection<HCHorizontalLine>(i, m_floatPoints.data(), line, waterline, wl);
+            });
+        else
+            accumulateCuts(first, last, sums, [&](size_t i){
+                return clipSection<HCGeneralLine>(i, m_floatPoints.data(), line, waterline, wl);
+            });
+    } else {
+        const HCPoint* points = m_hull.getVertices(0);
+        if (horizontal)
+            accumulateCuts(first, last, sums, [&](size_t i){
+                return clipSection<HCHorizontalLine>(i, points, waterline, waterline, wl);
+            });
+        else
+            accumulateCuts(first, last, sums, [&](size_t i){
+                return clipSection<HCGeneralLine>(i, points, waterline, waterline, wl);
+            });
+    }
+}
+
+template<typename CutFn>
+void HCLoader::accumulateCuts(size_t first, size_t last, SectionSums& sums, CutFn cutFn) const
+{
+    Hydrodata& hydro = sums.hydro;
+
+    for (size_t i = first; i < last; ++i) {
+        const double x = m_hull.getStationX(i);
+        const double elmtLength = m_hull.getElmtLength(i);
+        const double xelt = m_hull.getMidX(i);
+
+        const HCSectionCut cut = cutFn(i);
+        
+        if (cut.dryEmpty)
+            hydro.submerged = true;
+
+        double eltVol = cut.area * elmtLength;
+
+        hydro.LCB += xelt * eltVol;
+        hydro.TCB += cut.Mx * elmtLength;
+        hydro.VCB += cut.My * elmtLength;
+
+        hydro.Volume += eltVol;
+        hydro.Lpp += elmtLength;
+
+        double interLength = cut.chordLength;
+        hydro.RMT += elmtLength * cut.chordInertia;
+        hydro.RML += interLength * pow(elmtLength, 3) / 12 + (interLength * elmtLength) * pow(xelt, 2);
+        hydro.WaterplaneArea += interLength * elmtLength;
+
+        if (cut.area != 0){
+            if (sums.nLCF == 0){
+                hydro.LCF += x;
+                sums.nLCF += 1;
+                sums.firstWetX = x;
+            }
+            hydro.LCF += x + elmtLength;
+            sums.nLCF +=1;
+        }
+
+    } // Section Loop
+}
+
+template<typename Line, typename T>
+HCSectionCut HCLoader::clipSection(size_t i, const HCPointT<T>* points,
+                                const std::pair<HCPointT<T>,HCPointT<T>>& line,
+                                const std::pair<HCPoint,HCPoint>& waterline, double wl) const
+{
+    HCSectionCut cut;
+    if constexpr (std::is_same_v<T, double>) {
+        if (!m_shapes.empty() && m_shapes[i].cut<Line>(m_hull.getVertices(i), waterline, wl, cut))
+            return cut;
+    }
+    const size_t n = m_hull.getVertexCount(i);
+    if (HCHalfPlaneClip::cutSection<T, Line>(points + m_hull.getVertexOffset(i), n, line, wl, cut))
+        return cut;
+    // Vertex on the line: the triangles of the section, in double
+    if (!m_shapes.empty() && m_shapes[i].cutTriangles<Line>(m_hull.getVertices(i), waterline, wl, cut))
+        return cut;
+    return splitSection(m_hull.getVertices(i), n, waterline, wl);
+}
+
+HCSectionCut HCLoader::splitSection(const HCPoint* vertices, size_t n,
+                                const std::pair<HCPoint,HCPoint>& waterline,
+                                double wl)
+{
+    HCSectionCut cut;
+
+    // Vertex on the line, several wet parts...
+    // One splitter per thread, its storage is reused from call to call
+    thread_local HCPolygonSplitter split;
+    split.reset(vertices, n, waterline);
+    HCMoments wet = split.getMomentsFromSide(LineSide::Right);
+
+    cut.dryEmpty = !split.hasSide(LineSide::Left);
+    cut.area = wet.area;
+    if (wet.area > 0) {
+        cut.Mx = wet.Mx;
+        cut.My = wet.My;
+    }
+
+    // Compute for each edge of the waterline cut the lentgh and the inertia
+    double interLength = 0.0;
+    for(const auto& s : split.getEdges()){
+        interLength += s.first.distanceTo(s.second);
+        HCPoint midSectionPt = HCPoint( (s.first.x + s.second.x) / 2,
+                                       (s.first.y + s.second.y) / 2 );
+        // Transport the inertia at x = 0 waterline
+        double dt = midSectionPt.distanceTo(HCPoint( 0.0, wl ));
+        cut.chordInertia += pow(interLength, 3) / 12 + interLength * pow(dt, 2);
+    }
+    cut.chordLength = interLength;
+
+    return cut;
+}
+
+void HCLoader::mergeSums(SectionSums& sums, const SectionSums& other)
+{
+    Hydrodata& h = sums.hydro;
+    const Hydrodata& o = other.hydro;
+
+    h.LCB += o.LCB;
+    h.TCB += o.TCB;
+    h.VCB += o.VCB;
+    h.RMT += o.RMT;
+    h.RML += o.RML;
+    h.Volume += o.Volume;
+    h.Lpp += o.Lpp;
+    h.WaterplaneArea += o.WaterplaneArea;
+    h.submerged = h.submerged || o.submerged;
+
+    if (other.nLCF == 0)
+        return;
+    if (sums.nLCF == 0) {
+        h.LCF = o.LCF;
+        sums.nLCF = other.nLCF;
+        sums.firstWetX = other.firstWetX;
+    } else {
+        // Only the first wet section of the hull is counted twice
+        h.LCF += o.LCF - other.firstWetX;
+        sums.nLCF += other.nLCF - 1;
+    }
+}
+
+void HCLoader::getValueFromRange(const OpenXLSX::XLWorkbook& wb,
                                     const std::string& rngName, 
-                                    double defaultVal)
+                                    double defaultVal,
+                                    HCParams& params)
 {
-    double val;
+    double value;
     try
     {
-        val = wb.namedRange(rngName).firstCell().value().getAsDouble();
+        value = wb.namedRange(rngName).firstCell().value().getAsDouble();
     }
     catch(const std::exception& e)
     {
+        if (params.has(rngName))
+            return; // from the sidecar
         HCLogError("Named range \"" + rngName + "\" does not exist, default value {" 
                                 + std::to_string(defaultVal) + "} will be used");
-        val = defaultVal;
+        return;
     }
-    
-    return val;
+    if (!params.set(rngName, value))
+        throw std::runtime_error("Named range \"" + rngName + "\" : invalid value "
+                                + std::to_string(value) + ", shall be positive");
+}
+
+double HCLoader::getDefaultMaxDispl(double maxWl) const
+{
+    // Length of the ship minus the step
+    double DisplMax = m_hull.empty() ? 0.0 :
+                    m_hull.getStationX(m_hull.size() - 1) - m_hull.getStationX(0);
+    DisplMax *= (m_minMax.xmax - m_minMax.xmin);
+    DisplMax *= maxWl;
+    return DisplMax;
+}
+
+void HCLoader::setParams(const HCParams& params)
+{
+    HCParams merged = m_params;
+    merged.merge(params);
+
+    // The set values are checked by HCParams, not the defaults: the
+    // max displacement of a hull without length would be null
+    const double maxWl = merged.get(MAX_WL_NAME, MAX_WL_DEF);
+    const std::pair<const char*, double> values[] = {
+        { MAX_WL_NAME,      maxWl },
+        { DELTA_WL_NAME,    merged.get(DELTA_WL_NAME,      DELTA_WL_DEF) },
+        { MAX_ANGLE_NAME,   merged.get(MAX_ANGLE_NAME,     MAX_ANGLE_DEF) },
+        { DELTA_ANGLE_NAME, merged.get(DELTA_ANGLE_NAME,   DELTA_ANGLE_DEF) },
+        { MAX_DISPL_NAME,   merged.get(MAX_DISPL_NAME,     getDefaultMaxDispl(maxWl)) },
+        { DELTA_DISPL_NAME, merged.get(DELTA_DISPL_NAME,   DELTA_DISPL_DEF) },
+        { D_SW_NAME,        merged.get(D_SW_NAME,          D_SW_DEF) } };
+    for (const auto& [name, value] : values)
+        if (!std::isfinite(value) || value <= 0)
+            throw std::runtime_error(std::string("Invalid parameter ") + name + " "
+                                    + std::to_string(value) + ", shall be positive");
+    m_params = std::move(merged);
+
+    m_maxWl         = values[0].second;
+    m_deltaWl       = values[1].second;
+    m_maxAngle      = values[2].second;
+    m_deltaAngle    = values[3].second;
+    m_maxDispl      = values[4].second;
+    m_deltaDispl    = values[5].second;
+    m_d_sw          = values[6].second;
+
+    // The solver keeps the density
+    m_equilibrium.reset();
+}
+
+void HCLoader::setOutput(const std::string& filename)
+{
+    m_output = filename;
+}
+
+const std::string& HCLoader::getFilename() const
+{
+    return m_filename;
+}
+
+const std::string& HCLoader::getOutput() const
+{
+    return m_output;
+}
+
+void HCLoader::exportHull(const std::string& filename) const
+{
+    HCHullFile::writeBinary(filename, m_hull);
 }
 
-void HCLoader::checkMinMax(const std::vector<HCPoint>& section )
+void HCLoader::checkMinMax(const HCPoint* section, size_t n)
 {
-    for (const auto& pt : section){
+    for (size_t i = 0; i < n; ++i){
+        const HCPoint& pt = section[i];
         if ( m_minMax.xmin > pt.x)
             m_minMax.xmin = pt.x;
         if ( m_minMax.xmax < pt.x)
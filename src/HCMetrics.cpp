@@ -0,0 +1,203 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <cstdio>
+#include <ctime>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCMetrics.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    const char* const COUNTER_NAMES[HC_NB_METRIC_COUNTERS] = {
+        "waterlines", "splitter_runs", "vertices_classified",
+        "intersections", "on_line_vertices", "triangles" };
+
+    const char* const PHASE_NAMES[HC_NB_PHASES] = {
+        "load", "hydro_table", "kn_sweep", "kn_interpolation", "write" };
+
+    std::string toJson(double value)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.9g", value);
+        return buf;
+    }
+
+    std::string toJson(const std::string& s)
+    {
+        std::string res = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                res += '\\';
+            res += c;
+        }
+        return res + "\"";
+    }
+
+    uint64_t toNs(double ms)
+    {
+        return ms > 0.0 ? static_cast<uint64_t>(ms * 1e6 + 0.5) : 0;
+    }
+}
+
+HCMetrics::Binding::Binding(HCMetrics* metrics):
+    m_previous(t_metrics),
+    m_switched(metrics != t_metrics)
+{
+    if (!m_switched)
+        return;
+    if (m_previous)
+        m_previous->flush();
+    t_metrics = metrics;
+}
+
+HCMetrics::Binding::~Binding()
+{
+    if (!m_switched)
+        return;
+    if (t_metrics)
+        t_metrics->flush();
+    t_metrics = m_previous;
+}
+
+HCMetrics::Phase::Phase(HCMetrics* metrics, HCPhase phase):
+    m_metrics(metrics),
+    m_phase(phase),
+    m_binding(metrics ? metrics : HCMetrics::current()),
+    m_wallStart(std::chrono::steady_clock::now()),
+    m_cpuStart(getCpuTime())
+{ }
+
+HCMetrics::Phase::~Phase()
+{
+    if (m_metrics)
+        m_metrics->addPhase(m_phase, elapsed());
+}
+
+HCMetrics::PhaseTime HCMetrics::Phase::elapsed() const
+{
+    PhaseTime time;
+    time.wallMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - m_wallStart).count();
+    time.cpuMs = getCpuTime() - m_cpuStart;
+    time.calls = 1;
+    return time;
+}
+
+HCMetrics::HCMetrics()
+{
+    for (auto& c : m_counters)
+        c = 0;
+    for (int p = 0; p < HC_NB_PHASES; ++p) {
+        m_wallNs[p] = 0;
+        m_cpuNs[p] = 0;
+        m_calls[p] = 0;
+    }
+}
+
+HCMetrics::~HCMetrics() = default;
+
+double HCMetrics::getCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.0;
+    auto toMs = [](const FILETIME& t){
+        return static_cast<double>((uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime) / 1e4;
+    };
+    return toMs(kernel) + toMs(user);
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+        return 0.0;
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+#endif
+}
+
+void HCMetrics::addPhase(HCPhase phase, const PhaseTime& time)
+{
+    m_wallNs[phase].fetch_add(toNs(time.wallMs), std::memory_order_relaxed);
+    m_cpuNs[phase].fetch_add(toNs(time.cpuMs), std::memory_order_relaxed);
+    m_calls[phase].fetch_add(time.calls, std::memory_order_relaxed);
+}
+
+uint64_t HCMetrics::get(HCMetricCounter counter) const
+{
+    return m_counters[counter].load(std::memory_order_relaxed);
+}
+
+HCMetrics::PhaseTime HCMetrics::getPhase(HCPhase phase) const
+{
+    PhaseTime time;
+    time.wallMs = static_cast<double>(m_wallNs[phase].load(std::memory_order_relaxed)) / 1e6;
+    time.cpuMs = static_cast<double>(m_cpuNs[phase].load(std::memory_order_relaxed)) / 1e6;
+    time.calls = m_calls[phase].load(std::memory_order_relaxed);
+    return time;
+}
+
+const char* HCMetrics::getName(HCMetricCounter counter)
+{
+    return COUNTER_NAMES[counter];
+}
+
+const char* HCMetrics::getName(HCPhase phase)
+{
+    return PHASE_NAMES[phase];
+}
+
+void HCMetrics::writeJson(std::ostream& out, const std::string& input, unsigned threads) const
+{
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"input\": " << toJson(input) << ",\n";
+    out << "  \"date\": " << toJson(std::string(date)) << ",\n";
+    out << "  \"threads\": " << threads << ",\n";
+    out << "  \"phases\": {";
+    for (int p = 0; p < HC_NB_PHASES; ++p) {
+        PhaseTime time = getPhase(static_cast<HCPhase>(p));
+        out << (p == 0 ? "\n" : ",\n") << "    " << toJson(std::string(PHASE_NAMES[p]))
+            << ": { \"wall_ms\": " << toJson(time.wallMs)
+            << ", \"cpu_ms\": " << toJson(time.cpuMs)
+            << ", \"calls\": " << time.calls << " }";
+    }
+    out << "\n  },\n";
+    out << "  \"counters\": {";
+    for (int c = 0; c < HC_NB_METRIC_COUNTERS; ++c)
+        out << (c == 0 ? "\n" : ",\n") << "    " << toJson(std::string(COUNTER_NAMES[c]))
+            << ": " << get(static_cast<HCMetricCounter>(c));
+    out << "\n  }\n}\n";
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+void HCMetrics::flush()
+{
+    for (int c = 0; c < HC_NB_METRIC_COUNTERS; ++c) {
+        if (t_counts[c] != 0)
+            m_counters[c].fetch_add(t_counts[c], std::memory_order_relaxed);
+        t_counts[c] = 0;
+    }
+}
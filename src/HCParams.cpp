@@ -0,0 +1,159 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCParams.hpp"
+#include "HCConfig.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    /**
+     * @brief names of the parameters, named range and ASCII alias
+     */
+    const char* const PARAM_NAMES[][2] = {
+        { MAX_WL_NAME,      "max_wl" },
+        { DELTA_WL_NAME,    "delta_wl" },
+        { MAX_ANGLE_NAME,   "phi_max" },
+        { DELTA_ANGLE_NAME, "delta_phi" },
+        { MAX_DISPL_NAME,   "max_disp" },
+        { DELTA_DISPL_NAME, "delta_disp" },
+        { D_SW_NAME,        "rho_sw" }
+    };
+
+    std::string trim(const std::string& s)
+    {
+        auto first = s.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return std::string();
+        auto last = s.find_last_not_of(" \t\r");
+        return s.substr(first, last - first + 1);
+    }
+
+    bool toDouble(const std::string& s, double& value)
+    {
+        try {
+            size_t pos = 0;
+            value = std::stod(s, &pos);
+            return pos == s.size() && std::isfinite(value);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+HCParams::HCParams() = default;
+
+HCParams::~HCParams() = default;
+
+bool HCParams::set(const std::string& name, double value)
+{
+    std::string key = canonicalName(name);
+    if (key.empty() || !std::isfinite(value) || value <= 0)
+        return false;
+    m_values[key] = value;
+    return true;
+}
+
+bool HCParams::parse(const std::string& assignment)
+{
+    auto pos = assignment.find('=');
+    if (pos == std::string::npos)
+        return false;
+    double value;
+    if (!toDouble(trim(assignment.substr(pos + 1)), value))
+        return false;
+    return set(trim(assignment.substr(0, pos)), value);
+}
+
+void HCParams::readFile(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in)
+        throw std::runtime_error("Unable to open " + filename);
+
+    std::string line;
+    size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        // "name = value" or "name value"
+        auto pos = line.find('=');
+        if (pos == std::string::npos)
+            pos = line.find_first_of(" \t");
+        double value;
+        if (pos == std::string::npos
+                || !toDouble(trim(line.substr(pos + 1)), value)
+                || !set(trim(line.substr(0, pos)), value))
+            throw std::runtime_error(filename + ":" + std::to_string(lineNo)
+                                    + ": invalid parameter \"" + line + "\"");
+    }
+}
+
+void HCParams::writeFile(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    for (const auto& names : PARAM_NAMES) {
+        auto it = m_values.find(names[0]);
+        if (it == m_values.end())
+            continue;
+        char value[32];
+        snprintf(value, sizeof(value), "%.17g", it->second);
+        out << names[1] << " = " << value << "\n";
+    }
+    out.close();
+    if (!out)
+        throw std::runtime_error("Unable to write " + filename);
+}
+
+void HCParams::merge(const HCParams& other)
+{
+    for (const auto& [name, value] : other.m_values)
+        m_values[name] = value;
+}
+
+bool HCParams::has(const std::string& name) const
+{
+    return m_values.count(name) != 0;
+}
+
+double HCParams::get(const std::string& name, double defaultValue) const
+{
+    auto it = m_values.find(name);
+    return it == m_values.end() ? defaultValue : it->second;
+}
+
+bool HCParams::empty() const
+{
+    return m_values.empty();
+}
+
+std::string HCParams::canonicalName(const std::string& name)
+{
+    for (const auto& names : PARAM_NAMES)
+        if (name == names[0] || name == names[1])
+            return names[0];
+    return std::string();
+}
+
+std::string HCParams::getSidecarName(const std::string& hullFile)
+{
+    return std::filesystem::path(hullFile).replace_extension(".params").string();
+}
@@ -18,30 +18,42 @@ using namespace HydroCpp;
 
 
 
-HCPoint::HCPoint(double x, double y):x(x),y(y)
+template<typename T>
+HCPointT<T>::HCPointT(T x, T y):x(x),y(y)
 { }
 
 
-HCPoint::~HCPoint() = default;
+template<typename T>
+HCPointT<T>::~HCPointT() = default;
         
 
-HCPoint::HCPoint(const HCPoint& other):x(other.x), y(other.y)
+template<typename T>
+HCPointT<T>::HCPointT(const HCPointT& other):x(other.x), y(other.y)
 { }
 
-HCPoint::HCPoint(HCPoint&& other) = default;
+template<typename T>
+template<typename U>
+HCPointT<T>::HCPointT(const HCPointT<U>& other):x(static_cast<T>(other.x)),
+                                                y(static_cast<T>(other.y))
+{ }
+
+template<typename T>
+HCPointT<T>::HCPointT(HCPointT&& other) = default;
 
 
-HCPoint& HCPoint::operator=(const HCPoint& other)
+template<typename T>
+HCPointT<T>& HCPointT<T>::operator=(const HCPointT& other)
 {
     if (&other != this) {
-            auto temp = HCPoint(other);
+            auto temp = HCPointT(other);
             std::swap(*this, temp);
         }
         return *this;
 }
 
 
-HCPoint& HCPoint::operator=(HCPoint&& other) 
+template<typename T>
+HCPointT<T>& HCPointT<T>::operator=(HCPointT&& other) 
 {
     if (&other != this) {
         x = std::move(other.x);
@@ -51,7 +63,8 @@ HCPoint& HCPoint::operator=(HCPoint&& other)
 }
 
 
-HCPoint& HCPoint::operator+(const HCPoint& rhs)
+template<typename T>
+HCPointT<T>& HCPointT<T>::operator+(const HCPointT& rhs)
 {
     x += rhs.x;
     y += rhs.y;
@@ -59,31 +72,36 @@ HCPoint& HCPoint::operator+(const HCPoint& rhs)
 }
 
 
-HCPoint& HCPoint::operator-(const HCPoint& rhs)
+template<typename T>
+HCPointT<T>& HCPointT<T>::operator-(const HCPointT& rhs)
 {
     x -= rhs.x;
     y -= rhs.y;
     return *this;
 }
 
-bool HCPoint::operator==(const HCPoint& other) const
+template<typename T>
+bool HCPointT<T>::operator==(const HCPointT& other) const
 {
     if((x == other.x)&&(y == other.y))
         return true;
     return false;
 }
 
-bool HCPoint::operator!=(const HCPoint& other) const
+template<typename T>
+bool HCPointT<T>::operator!=(const HCPointT& other) const
 {
     return !(*this == other);
 }
 
-double HCPoint::operator*(const HCPoint& rhs) const
+template<typename T>
+T HCPointT<T>::operator*(const HCPointT& rhs) const
 {
     return x * rhs.x + y * rhs.y;
 }
 
-HCPoint& HCPoint::operator*(const double m)
+template<typename T>
+HCPointT<T>& HCPointT<T>::operator*(const T m)
 {
     x *= m;
     y *= m;
@@ -92,14 +110,24 @@ HCPoint& HCPoint::operator*(const double m)
 }
 
 
-double HCPoint::distanceToOrigin() const
+template<typename T>
+T HCPointT<T>::distanceToOrigin() const
 {
-    HCPoint origin = HCPoint(0.0, 0.0);
+    HCPointT origin = HCPointT(0, 0);
     return distanceTo(origin);
 }
 
 
-double HCPoint::distanceTo(const HCPoint& rhs) const
+template<typename T>
+T HCPointT<T>::distanceTo(const HCPointT& rhs) const
 {
     return (sqrt(pow(x-rhs.x , 2) + pow(y-rhs.y , 2)));
-}
\ No newline at end of file
+}
+
+namespace HydroCpp
+{
+    template class HCPointT<double>;
+    template class HCPointT<float>;
+    template HCPointT<double>::HCPointT(const HCPointT<float>& other);
+    template HCPointT<float>::HCPointT(const HCPointT<double>& other);
+}
@@ -9,6 +9,8 @@
 #include <cstdint>
 #include <math.h>
 #include <algorithm>
+#include <functional>
+#include <queue>
 
 //TODEL
 #include <iostream>
@@ -16,11 +18,16 @@
 
 // ===== HydroCpp Includes ===== //
 #include "HCPolygon.hpp"
+#include "HCMetrics.hpp"
 
 using namespace HydroCpp;
 
 HCPolygon::HCPolygon(const std::vector<HCPoint>& vertexVect)
-                   : m_vertices(vertexVect), m_isComputed(false), 
+                   : HCPolygon(vertexVect.data(), vertexVect.size())
+{ }
+
+HCPolygon::HCPolygon(const HCPoint* vertices, size_t n)
+                   : m_vertices(vertices, vertices + n), m_isComputed(false), 
                      m_area(0.0), m_cog(HCPoint(0.0,0.0))
 { 
     // Orient the polygon in a safe manner
@@ -36,31 +43,19 @@ HCPolygon::HCPolygon(const HCPolygon& other)
             : m_vertices(other.m_vertices),
             m_isComputed(other.m_isComputed),
             m_area(other.m_area),
-            m_cog(other.m_cog)
+            m_cog(other.m_cog),
+            m_moments(other.m_moments)
 { }
 
 HCPolygon::HCPolygon(HCPolygon&& other) = default;
 
 
-HCPolygon& HCPolygon::operator=(const HCPolygon& other)
-{
-    if (&other != this) {
-            auto temp = HCPolygon(other);
-            std::swap(*this, temp);
-        }
-        return *this;
-}
-
+// The computed area, cog and moments go with the vertices
+HCPolygon& HCPolygon::operator=(const HCPolygon& other) = default;
 
-HCPolygon& HCPolygon::operator=(HCPolygon&& other) 
-{
-    if (&other != this) {
-        m_vertices = std::move(other.m_vertices);
-    }
-    return *this;
-}
+HCPolygon& HCPolygon::operator=(HCPolygon&& other) = default;
 
-const std::vector<HCPoint>& HCPolygon::getVertices() const
+const HCPolygon::Vertices& HCPolygon::getVertices() const
 {
     return m_vertices;
 }
@@ -81,18 +76,34 @@ const HCPoint& HCPolygon::getCog()
     return m_cog;
 }
 
-/////////////////////////////////////////////
-//
-// Private
-//
-//////////////////////////////////////////////
+const HCMoments& HCPolygon::getMoments()
+{
+    if(!m_isComputed)
+        compute();
+    
+    return m_moments;
+}
 
-void HCPolygon::compute()
+double HCPolygon::getIxx()
+{
+    return getMoments().Ixx;
+}
+
+double HCPolygon::getIyy()
+{
+    return getMoments().Iyy;
+}
+
+double HCPolygon::getIxy()
+{
+    return getMoments().Ixy;
+}
+
+HCMoments HCPolygon::computeByTriangulation()
 {
     triangulatePolygon();
-    m_area = 0.0;
-    double Mx = 0.0; 
-    double My = 0.0;
+    HCMetrics::add(HC_TRIANGLES, m_trianglesList.size());
+    HCMoments m;
     for (auto& tr : m_trianglesList){
         double xcog_tr = (tr.P0.x +  tr.P1.x +  tr.P2.x) / 3.0;
         double ycog_tr = (tr.P0.y +  tr.P1.y +  tr.P2.y) / 3.0;
@@ -100,15 +111,163 @@ void HCPolygon::compute()
         double area_tr = 0.5 *(tr.P0.x * (tr.P1.y - tr.P2.y) +
                               tr.P1.x * (tr.P2.y - tr.P0.y) +
                               tr.P2.x * (tr.P0.y - tr.P1.y));
-        Mx += xcog_tr *area_tr;
-        My += ycog_tr *area_tr;
+        m.Mx += xcog_tr *area_tr;
+        m.My += ycog_tr *area_tr;
         
-        m_area += area_tr;
+        m.area += area_tr;
     }
-    //m_area = abs(m_area);
+    return m;
+}
+
+HCMoments HCPolygon::computeMoments(const HCPoint* vertices, size_t n)
+{
+    HCMoments m;
+    if (n < 3)
+        return m;
+
+    for (size_t i = 0; i < n; ++i){
+        const HCPoint& P0 = vertices[i];
+        const HCPoint& P1 = vertices[i + 1 < n ? i + 1 : 0];
+
+        double cross = P0.x * P1.y - P1.x * P0.y;
+        m.area += cross;
+        m.Mx += (P0.x + P1.x) * cross;
+        m.My += (P0.y + P1.y) * cross;
+        m.Ixx += (P0.y * P0.y + P0.y * P1.y + P1.y * P1.y) * cross;
+        m.Iyy += (P0.x * P0.x + P0.x * P1.x + P1.x * P1.x) * cross;
+        m.Ixy += (P0.x * P1.y + 2 * P0.x * P0.y + 2 * P1.x * P1.y + P1.x * P0.y) * cross;
+    }
+    m.area /= 2;
+    m.Mx /= 6;
+    m.My /= 6;
+    m.Ixx /= 12;
+    m.Iyy /= 12;
+    m.Ixy /= 24;
+
+    return m;
+}
+
+void HCPolygon::triangulate(const HCPoint* vertices, size_t n,
+                            std::vector<std::array<uint32_t, 3>>& triangles)
+{
+    triangles.clear();
+    if (n < 3)
+        return;
+    triangles.reserve(n - 2);
+
+    // The ears turn as the ring
+    double area = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P = vertices[i];
+        const HCPoint& Q = vertices[i + 1 < n ? i + 1 : 0];
+        area += P.x * Q.y - Q.x * P.y;
+    }
+    const double sign = area < 0 ? -1.0 : 1.0;
+    auto turn = [&](uint32_t a, uint32_t b, uint32_t c){
+        const HCPoint& A = vertices[a];
+        const HCPoint& B = vertices[b];
+        const HCPoint& C = vertices[c];
+        return sign * ((B.x - A.x) * (C.y - A.y) - (B.y - A.y) * (C.x - A.x));
+    };
+
+    // Index ring, the flat vertices are kept with the reflex ones: they
+    // are no ear tip, and may lie on a diagonal
+    std::vector<uint32_t> prev(n), next(n);
+    std::vector<uint8_t> reflex(n);
+    std::vector<uint32_t> reflexList;
+    for (uint32_t i = 0; i < n; ++i) {
+        prev[i] = i == 0 ? static_cast<uint32_t>(n - 1) : i - 1;
+        next[i] = i + 1 == n ? 0 : i + 1;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        reflex[i] = turn(prev[i], i, next[i]) <= 0;
+        if (reflex[i])
+            reflexList.push_back(i);
+    }
+
+    // A convex vertex is an ear tip if no reflex vertex lies in its
+    // triangle, borders included. Removing ears never makes a convex
+    // vertex reflex, so only the reflex ones are checked, O(r) per ear
+    auto isEar = [&](uint32_t b){
+        if (reflex[b])
+            return false;
+        const uint32_t a = prev[b];
+        const uint32_t c = next[b];
+        for (uint32_t j : reflexList) {
+            if (!reflex[j] || j == a || j == c)
+                continue;
+            if (turn(a, b, j) >= 0 && turn(b, c, j) >= 0 && turn(c, a, j) >= 0)
+                return false;
+        }
+        return true;
+    };
+
+    // The ears of the shortest diagonal first: the triangles stay close
+    // to the vertices they join, instead of a fan from a single one,
+    // and a waterline crosses less of them
+    auto diagonal = [&](uint32_t b){
+        const HCPoint& A = vertices[prev[b]];
+        const HCPoint& C = vertices[next[b]];
+        return (C.x - A.x) * (C.x - A.x) + (C.y - A.y) * (C.y - A.y);
+    };
+    using Candidate = std::pair<double, uint32_t>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> ears;
+    std::vector<double> key(n, -1.0);   // key of the valid entry, -1 if none
+    auto update = [&](uint32_t b){
+        key[b] = isEar(b) ? diagonal(b) : -1.0;
+        if (key[b] >= 0)
+            ears.push({key[b], b});
+    };
+    for (uint32_t i = 0; i < n; ++i)
+        update(i);
+
+    size_t remaining = n;
+    uint32_t last = 0;
+    while (remaining > 3) {
+        uint32_t b;
+        if (!ears.empty()) {
+            const Candidate top = ears.top();
+            ears.pop();
+            b = top.second;
+            if (key[b] != top.first)
+                continue; // outdated
+        } else {
+            b = last; // a ring without ear is not simple, cut anyway
+        }
+        const uint32_t a = prev[b];
+        const uint32_t c = next[b];
+        triangles.push_back({a, b, c});
+        next[a] = c;
+        prev[c] = a;
+        reflex[b] = false;
+        key[b] = -1.0;
+        --remaining;
+        last = a;
+        // Only the neighbours have a new triangle, and may have become ears
+        if (reflex[a])
+            reflex[a] = turn(prev[a], a, c) <= 0;
+        if (reflex[c])
+            reflex[c] = turn(a, c, next[c]) <= 0;
+        update(a);
+        update(c);
+    }
+    triangles.push_back({prev[last], last, next[last]});
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+void HCPolygon::compute()
+{
+    m_moments = computeMoments(m_vertices.data(), m_vertices.size());
+    m_area = m_moments.area;
+
     if (m_area > 0){
-        m_cog.x = Mx / m_area;
-        m_cog.y = My / m_area;
+        m_cog.x = m_moments.Mx / m_area;
+        m_cog.y = m_moments.My / m_area;
     } else {
         m_cog.x = 0.0;
         m_cog.y = 0.0;
@@ -220,35 +379,21 @@ void HCPolygon::triangulatePolygon()
 {
     m_trianglesList.clear();
 
-    triangulatePolygonRecursive(m_vertices);
+    triangulatePolygonRecursive(std::vector<HCPoint>(m_vertices.begin(), m_vertices.end()));
 }
 
 bool HCPolygon::isCounterclockwise() const
 {
-    // Find the lowest point the most left side to check angle
-    std::vector<int> shortList; // shortlist of the most left vertices
-    shortList.push_back(0);
-    double xc = m_vertices.at(0).x;
+    if (m_vertices.empty())
+        return true;
 
-    uint16_t index = 0; // Find the list of the most left
+    // Find the lowest point the most left side to check angle
+    uint16_t index = 0;
     for (uint16_t i=1; i < m_vertices.size(); ++i){
-        if (m_vertices.at(i).x == xc)
-            shortList.push_back(i);
-        else if (m_vertices.at(i).x < xc) {
-            xc = m_vertices.at(i).x;
-            shortList.clear();
-            shortList.push_back(i);
+        const HCPoint& M = m_vertices[i];
+        const HCPoint& C = m_vertices[index];
+        if ((M.x < C.x) || ((M.x == C.x) && (M.y < C.y)))
             index = i;
-        }
-    } 
-
-    index = shortList.at(0); // find the lower of the most left
-    double yc = m_vertices.at(index).y;
-    for(uint16_t i : shortList){
-        if (m_vertices.at(i).y < yc){
-            yc = m_vertices.at(i).y;
-            index = i;
-        }
     }
 
     HCPoint A = m_vertices.at(next(index,-1));
@@ -15,86 +15,54 @@
 
 // ===== HydroCpp Includes ===== //
 #include "HCPolygonSplitter.hpp"
+#include "HCMetrics.hpp"
+#include "HCSideKernel.hpp"
 
 using namespace HydroCpp;
 
-HCPolygonSplitter::HCPolygonSplitter(const std::vector<HCPoint>& vertices, 
-                                    const std::pair<HCPoint,HCPoint>& line) 
-        : m_vertices(), m_line(line), m_isComputed(false)
+namespace
 {
-    m_intersections.clear();
-    for(uint16_t i=0; i < vertices.size(); ++i) {
-        HCPoint startPt = vertices.at(i);
-        HCPoint endPt = vertices.at(i<vertices.size() - 1 ? i+1 : 0);
-
-        auto startSide = getSide(startPt); 
-        auto endSide = getSide(endPt);
-
-        m_vertices.push_back(Vertex(startPt, startSide));
-        if (startSide == LineSide::On)
-        {   // vertex on line
-            m_intersections.push_back(&m_vertices.back());
-        }
-        else if (startSide != endSide && endSide != LineSide::On)
-        {  // segment crossing the line
-            auto interPt = intersection (line, startPt, endPt);
-            m_vertices.push_back(Vertex(interPt, LineSide::On));
-            m_intersections.push_back(&m_vertices.back());
-        }
-
-    }
-    
-    // connect doubly linked list, except
-    // first->prev and last->next
-    for (auto it = m_vertices.begin(); it!=std::prev(m_vertices.end()); it++)
+    inline LineSide toLineSide(int8_t side)
     {
-        auto nextIt = std::next(it);
-        it->next = &(*nextIt);
-        nextIt->prev = &(*it);
+        if (side > 0)
+            return LineSide::Right;
+        if (side < 0)
+            return LineSide::Left;
+        return LineSide::On;
     }
+}
 
-    // connect first->prev and last->next
-    m_vertices.back().next = & m_vertices.front();
-    m_vertices.front().prev = & m_vertices.back();
-       
+HCPolygonSplitter::HCPolygonSplitter()
+        : m_line(HCPoint(0.0, 0.0), HCPoint(0.0, 0.0)), m_isComputed(false)
+{ }
+
+HCPolygonSplitter::HCPolygonSplitter(const std::vector<HCPoint>& vertices, 
+                                    const std::pair<HCPoint,HCPoint>& line) 
+        : HCPolygonSplitter()
+{
+    reset(vertices, line);
 }
 
 HCPolygonSplitter::HCPolygonSplitter(const HCPolygon* polygon, 
                                     const std::pair<HCPoint,HCPoint>& line) :
-    HCPolygonSplitter(polygon->getVertices(), line)
-{ }
+    HCPolygonSplitter()
+{
+    reset(polygon->getVertices().data(), polygon->getVertices().size(), line);
+}
 
 
 HCPolygonSplitter::~HCPolygonSplitter() = default;
         
 
-HCPolygonSplitter::HCPolygonSplitter(const HCPolygonSplitter& other)
-                : m_vertices(other.m_vertices), 
-                m_intersections(other.m_intersections),
-                m_line(other.m_line),
-                m_isComputed(other.m_isComputed)
-{ }
+HCPolygonSplitter::HCPolygonSplitter(const HCPolygonSplitter& other) = default;
 
 HCPolygonSplitter::HCPolygonSplitter(HCPolygonSplitter&& other) = default;
 
 
-HCPolygonSplitter& HCPolygonSplitter::operator=(const HCPolygonSplitter& other)
-{
-    if (&other != this) {
-            auto temp = HCPolygonSplitter(other);
-            std::swap(*this, temp);
-        }
-        return *this;
-}
+HCPolygonSplitter& HCPolygonSplitter::operator=(const HCPolygonSplitter& other) = default;
 
 
-HCPolygonSplitter& HCPolygonSplitter::operator=(HCPolygonSplitter&& other) 
-{
-    if (&other != this) {
-        m_vertices = std::move(other.m_vertices);
-    }
-    return *this;
-}
+HCPolygonSplitter& HCPolygonSplitter::operator=(HCPolygonSplitter&& other) = default;
 
 /////////////////////////////////////////////
 //
@@ -102,6 +70,26 @@ HCPolygonSplitter& HCPolygonSplitter::operator=(HCPolygonSplitter&& other)
 //
 //////////////////////////////////////////////
 
+void HCPolygonSplitter::reset(const HCPoint* vertices, size_t n,
+                            const std::pair<HCPoint,HCPoint>& line)
+{
+    m_source.assign(vertices, vertices + n);
+    reset(line);
+}
+
+void HCPolygonSplitter::reset(const std::vector<HCPoint>& vertices,
+                            const std::pair<HCPoint,HCPoint>& line)
+{
+    reset(vertices.data(), vertices.size(), line);
+}
+
+void HCPolygonSplitter::reset(const std::pair<HCPoint,HCPoint>& line)
+{
+    m_line = line;
+    m_isComputed = false;
+    build();
+}
+
 HCPolygons& HCPolygonSplitter::getPolygonFromSide(LineSide side)
 {
     if (!m_isComputed)
@@ -110,15 +98,51 @@ HCPolygons& HCPolygonSplitter::getPolygonFromSide(LineSide side)
     m_polys.clear();
 
     // Check if each poly is on the right side
-    for (auto& p : m_collected){
-        if(p.side == side)
-            m_polys.getPolygons().push_back(HCPolygon(p.vertices));
+    for (const auto& p : m_collected){
+        if(p.side == side) {
+            m_polys.getPolygons().emplace_back(m_loopPoints.data() + p.first, p.count);
+        }
     }
     
     return m_polys;
 
 }
 
+HCMoments HCPolygonSplitter::getMomentsFromSide(LineSide side)
+{
+    if (!m_isComputed)
+        computeIntersections();
+
+    HCMoments res;
+    for (const auto& p : m_collected){
+        if(p.side != side)
+            continue;
+        HCMoments m = HCPolygon::computeMoments(&m_loopPoints[p.first], p.count);
+        // same as HCPolygon, which turns the loops counterclockwise
+        double sign = m.area < 0 ? -1.0 : 1.0;
+        res.area += sign * m.area;
+        res.Mx += sign * m.Mx;
+        res.My += sign * m.My;
+        res.Ixx += sign * m.Ixx;
+        res.Iyy += sign * m.Iyy;
+        res.Ixy += sign * m.Ixy;
+    }
+
+    return res;
+}
+
+bool HCPolygonSplitter::hasSide(LineSide side)
+{
+    if (!m_isComputed)
+        computeIntersections();
+
+    for (const auto& p : m_collected){
+        if(p.side == side)
+            return true;
+    }
+    return false;
+}
+
 const std::vector<std::pair<HCPoint,HCPoint>>& HCPolygonSplitter::getEdges()
 {
     if (!m_isComputed)
@@ -127,6 +151,70 @@ const std::vector<std::pair<HCPoint,HCPoint>>& HCPolygonSplitter::getEdges()
     return m_edges;
 }
 
+void HCPolygonSplitter::build()
+{
+    m_vertices.clear();
+    m_intersections.clear();
+    m_edges.clear();
+    m_loopPoints.clear();
+    m_collected.clear();
+
+    const size_t n = m_source.size();
+    if (n == 0)
+        return;
+
+    // Sides of the vertices and crossing points in bulk
+    m_sides.resize(n);
+    HCSideKernel::classify(m_source.data(), n, m_line, m_sides.data());
+
+    m_crossEdges.clear();
+    for(size_t i=0; i < n; ++i) {
+        int8_t startSide = m_sides[i];
+        int8_t endSide = m_sides[i < n - 1 ? i+1 : 0];
+        if (startSide != 0 && startSide != endSide && endSide != 0)
+            m_crossEdges.push_back(static_cast<uint32_t>(i));
+    }
+    m_crossPoints.resize(m_crossEdges.size(), HCPoint(0.0, 0.0));
+    m_crossInRange.resize(m_crossEdges.size());
+    HCSideKernel::intersect(m_source.data(), n, m_crossEdges.data(), m_crossEdges.size(),
+                            m_line, m_crossPoints.data(), m_crossInRange.data());
+
+    size_t c = 0;
+    size_t onLine = 0;
+    for(size_t i=0; i < n; ++i) {
+        auto startSide = toLineSide(m_sides[i]);
+
+        m_vertices.push_back(Vertex(m_source[i], startSide));
+        if (startSide == LineSide::On)
+        {   // vertex on line
+            m_intersections.push_back(uint32_t(m_vertices.size() - 1));
+            ++onLine;
+        }
+        else if (c < m_crossEdges.size() && m_crossEdges[c] == i)
+        {  // segment crossing the line, no intersection outside of the segment
+            HCPoint interPt = m_crossInRange[c] ? m_crossPoints[c] : HCPoint(0.0, 0.0);
+            m_vertices.push_back(Vertex(interPt, LineSide::On));
+            m_intersections.push_back(uint32_t(m_vertices.size() - 1));
+            ++c;
+        }
+
+    }
+
+    HCMetrics::add(HC_SPLITTER_RUNS);
+    HCMetrics::add(HC_VERTICES_CLASSIFIED, n);
+    HCMetrics::add(HC_INTERSECTIONS, m_crossEdges.size());
+    HCMetrics::add(HC_ON_LINE_VERTICES, onLine);
+
+    // connect doubly linked list, including
+    // first->prev and last->next
+    const uint32_t count = uint32_t(m_vertices.size());
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        m_vertices[i].next = (i + 1 < count) ? i + 1 : 0;
+        m_vertices[i].prev = (i > 0) ? i - 1 : count - 1;
+    }
+}
+
  void HCPolygonSplitter::computeIntersections()
  {
     sortIntersections();
@@ -140,57 +228,63 @@ void HCPolygonSplitter::sortIntersections()
 {
     // sort edges by start position relative to
     // the start position of the split line
-    std::sort(m_intersections.begin(), m_intersections.end(), [&](Vertex* e0, Vertex* e1)
+    std::sort(m_intersections.begin(), m_intersections.end(), [&](uint32_t e0, uint32_t e1)
     {
-        return distanceFromStart(e0->pt) < distanceFromStart(e1->pt);
+        return distanceFromStart(m_vertices[e0].pt) < distanceFromStart(m_vertices[e1].pt);
     });
 
     // compute distance between each edge's start
     // position and the first edge's start position
-    for (size_t i=1; i < m_intersections.size(); i++)
-        m_intersections[i]->distToStart = distanceFromStart(m_intersections[i]->pt);
+    for (size_t i=1; i < m_intersections.size(); i++) {
+        Vertex& v = m_vertices[m_intersections[i]];
+        v.distToStart = distanceFromStart(v.pt);
+    }
 }
 
 void HCPolygonSplitter::splitPolygon()
 {
-    
-    Vertex* useSrc = nullptr;
+    auto& V = m_vertices;
+    uint32_t useSrc = Vertex::npos;
 
     for (size_t i=0; i<m_intersections.size(); i++)
     {
         // find source
-        Vertex* srcPt = useSrc;
-        useSrc = nullptr;
+        uint32_t srcPt = useSrc;
+        useSrc = Vertex::npos;
 
-        for (; !srcPt && i<m_intersections.size(); )
+        for (; srcPt == Vertex::npos && i<m_intersections.size(); )
         {
-            Vertex* curPt =m_intersections[i];
-            const auto curSide = curPt->side;
-            const auto prevSide = curPt->prev->side;
-            const auto nextSide = curPt->next->side;
+            const Vertex& curPt = V[m_intersections[i]];
+            const Vertex& prevPt = V[curPt.prev];
+            const Vertex& nextPt = V[curPt.next];
+            const auto curSide = curPt.side;
+            const auto prevSide = prevPt.side;
+            const auto nextSide = nextPt.side;
             assert(curSide == LineSide::On);
+            (void)curSide;
 
             if ((prevSide == LineSide::Left && nextSide == LineSide::Right) ||
-                (prevSide == LineSide::Left && nextSide == LineSide::On && curPt->next->distToStart < curPt->distToStart) ||
-                (prevSide == LineSide::On && nextSide == LineSide::Right && curPt->prev->distToStart < curPt->distToStart))
+                (prevSide == LineSide::Left && nextSide == LineSide::On && nextPt.distToStart < curPt.distToStart) ||
+                (prevSide == LineSide::On && nextSide == LineSide::Right && prevPt.distToStart < curPt.distToStart))
             {
-                srcPt = curPt;
-                srcPt->isSrc = true;
+                srcPt = m_intersections[i];
+                V[srcPt].isSrc = true;
             }
             else
                 i++;
         }
         // We get a src here
         // find destination
-        Vertex* dstPt = nullptr;
+        uint32_t dstPt = Vertex::npos;
 
-        for (; !dstPt && i<m_intersections.size(); )
+        for (; dstPt == Vertex::npos && i<m_intersections.size(); )
         {
-            Vertex* curPt = m_intersections[i];
-            const auto curSide = curPt->side;
-            const auto prevSide = curPt->prev->side;
-            const auto nextSide = curPt->next->side;
+            const Vertex& curPt = V[m_intersections[i]];
+            const auto curSide = curPt.side;
+            const auto prevSide = V[curPt.prev].side;
+            const auto nextSide = V[curPt.next].side;
             assert(curSide == LineSide::On);
+            (void)curSide;
 
             if ((prevSide == LineSide::Right && nextSide == LineSide::Left)  ||
                 (prevSide == LineSide::On && nextSide == LineSide::Left)     ||
@@ -198,31 +292,31 @@ void HCPolygonSplitter::splitPolygon()
                 (prevSide == LineSide::Right && nextSide == LineSide::Right) ||
                 (prevSide == LineSide::Left && nextSide == LineSide::Left))
             {
-                dstPt = curPt;
-                dstPt->isDest = true;
+                dstPt = m_intersections[i];
+                V[dstPt].isDest = true;
             }
             else
                 i++;
         }
 
         // bridge source and destination
-        if (srcPt && dstPt)
+        if (srcPt != Vertex::npos && dstPt != Vertex::npos)
         {
             createBridge(srcPt, dstPt);
-            m_edges.push_back(std::make_pair(srcPt->pt, dstPt->pt));
+            m_edges.push_back(std::make_pair(V[srcPt].pt, V[dstPt].pt));
             //VerifyCycles();
 
             // is it a configuration in which a vertex
             // needs to be reused as source vertex?
-            if (srcPt->prev->prev->side == LineSide::Left)
+            if (V[V[V[srcPt].prev].prev].side == LineSide::Left)
             {
-                useSrc = srcPt->prev;
-                useSrc->isSrc = true;
+                useSrc = V[srcPt].prev;
+                V[useSrc].isSrc = true;
             }
-            else if (dstPt->next->side == LineSide::Right)
+            else if (V[V[dstPt].next].side == LineSide::Right)
             {
                 useSrc = dstPt;
-                useSrc->isSrc = true;
+                V[useSrc].isSrc = true;
             }
         }
 
@@ -232,46 +326,54 @@ void HCPolygonSplitter::splitPolygon()
 void HCPolygonSplitter::collectPolys()
 {
     m_collected.clear();
-    for (auto &e : m_vertices)
+    m_loopPoints.clear();
+    for (uint32_t e = 0; e < m_vertices.size(); ++e)
     {
-        if (!e.visited)
+        if (!m_vertices[e].visited)
         {
-            SplitPoly sPoly;
-            auto *curPt = &e;
+            SplitLoop loop;
+            loop.first = uint32_t(m_loopPoints.size());
+            uint32_t curPt = e;
 
             do
             {
-                curPt->visited = true;
-                sPoly.vertices.push_back(curPt->pt);
-                if (curPt->side != LineSide::On)
-                    sPoly.side = curPt->side;
-                curPt = curPt->next;
+                Vertex& v = m_vertices[curPt];
+                v.visited = true;
+                m_loopPoints.push_back(v.pt);
+                if (v.side != LineSide::On)
+                    loop.side = v.side;
+                curPt = v.next;
             }
-            while (curPt != &e);
+            while (curPt != e);
 
-            m_collected.push_back(sPoly);
+            loop.count = uint32_t(m_loopPoints.size()) - loop.first;
+            m_collected.push_back(loop);
         }
     }
 
 }
 
-void HCPolygonSplitter::createBridge(Vertex* srcPt, Vertex* dstPt)
+void HCPolygonSplitter::createBridge(uint32_t srcPt, uint32_t dstPt)
 {
-    m_vertices.push_back(*srcPt);
-    Vertex* a =  &m_vertices.back();
-
-    m_vertices.push_back(*dstPt);
-    Vertex* b =  &m_vertices.back();
-
-    a->next = dstPt;
-    a->prev = srcPt->prev;
-    b->next = srcPt;
-    b->prev = dstPt->prev;
-
-    srcPt->prev->next = a;
-    srcPt->prev = b;
-    dstPt->prev->next = b;
-    dstPt->prev = a;
+    // copies first, the pool may grow
+    Vertex src = m_vertices[srcPt];
+    Vertex dst = m_vertices[dstPt];
+
+    const uint32_t a = uint32_t(m_vertices.size());
+    m_vertices.push_back(src);
+    const uint32_t b = uint32_t(m_vertices.size());
+    m_vertices.push_back(dst);
+
+    auto& V = m_vertices;
+    V[a].next = dstPt;
+    V[a].prev = V[srcPt].prev;
+    V[b].next = srcPt;
+    V[b].prev = V[dstPt].prev;
+
+    V[V[srcPt].prev].next = a;
+    V[srcPt].prev = b;
+    V[V[dstPt].prev].next = b;
+    V[dstPt].prev = a;
 }
 
 
@@ -280,40 +382,3 @@ double HCPolygonSplitter::distanceFromStart(const HCPoint& M) const
     return (M.x-m_line.first.x)*(m_line.second.x-m_line.first.x)
             + (M.y-m_line.first.y)*(m_line.second.y-m_line.first.y);
 }
-
-
-LineSide HCPolygonSplitter::getSide( const HCPoint& M) const
-{
-    double dist = distPtToSegment(m_line, M);
-
-    if (std::abs(dist) < 1e-8)
-        return LineSide::On;
-
-    if (dist < 0)
-        return LineSide::Right;
-    
-    return LineSide::Left;
-}
-
-HCPoint HCPolygonSplitter::intersection(const std::pair<HCPoint,HCPoint>& line, 
-                    const HCPoint& A, const HCPoint& B) const
-{
-    const HCPoint& C = line.first;
-    const HCPoint& D = line.second;
-
-    HCPoint vAB = B; vAB = vAB - A; // vector AB
-    HCPoint vDC = D; vDC = vDC - C; // vector DC
-    double m, k;
-
-    double div = vAB.x * vDC.y - vAB.y * vDC.x;
-    if (div !=0.0){
-        m = (vAB.x * A.y - vAB.x * C.y - vAB.y * A.x + vAB.y * C.x ) / div;
-        k = (vDC.x * A.y - vDC.x * C.y - vDC.y * A.x + vDC.y * C.x ) / div;
-        if ((0.0<=m) && (m<1) && (0<=k) && (k<1)){
-            return ( vAB * k + A );
-        }
-    }
-
-    // No intersection
-    return HCPoint(0.0,0.0);
-}
\ No newline at end of file
@@ -0,0 +1,204 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCResultCache.hpp"
+#include "HCDeflate.hpp"
+#include "HCLog.hpp"
+
+using namespace HydroCpp;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char      MAGIC[8]        = { 'H', 'C', 'C', 'A', 'C', 'H', 'E', '\0' };
+    const size_t    HEADER_SIZE     = 32;
+    const char*     EXTENSION       = ".hcr";
+
+    /**
+     * @brief header of an entry file
+     */
+    struct EntryHeader
+    {
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    crc;
+        uint64_t    key;
+        uint64_t    count;
+    };
+    static_assert(sizeof(EntryHeader) == HEADER_SIZE, "EntryHeader shall be packed");
+
+    /**
+     * @brief unique name of a temporary file, between the threads and
+     * the processes writing in the same directory
+     */
+    std::string getTemporaryName(const std::string& path)
+    {
+        static std::atomic<uint64_t> counter { 0 };
+        uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id())
+                    ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+                    ^ (counter++ << 48);
+        char suffix[24];
+        snprintf(suffix, sizeof(suffix), ".%016llx", static_cast<unsigned long long>(id));
+        return path + suffix;
+    }
+}
+
+HCCacheKey& HCCacheKey::add(const void* data, size_t n)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h = m_hash;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    m_hash = h;
+    return *this;
+}
+
+HCResultCache::HCResultCache(const std::string& directory, uint64_t maxSize):
+    m_directory(directory),
+    m_maxSize(maxSize)
+{
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (!fs::is_directory(m_directory, ec))
+        throw std::runtime_error("Unable to create the cache directory " + m_directory);
+}
+
+HCResultCache::~HCResultCache() = default;
+
+bool HCResultCache::load(uint64_t key, std::vector<double>& values) const
+{
+    const std::string path = getPath(key);
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    EntryHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+            || header.version != VERSION || header.key != key)
+        return false;
+
+    std::error_code ec;
+    if (fs::file_size(path, ec) != HEADER_SIZE + header.count * sizeof(double) || ec)
+        return false;
+
+    std::vector<double> res(header.count);
+    if (!in.read(reinterpret_cast<char*>(res.data()),
+                static_cast<std::streamsize>(res.size() * sizeof(double)))
+            || HCDeflate::crc32(0, res.data(), res.size() * sizeof(double)) != header.crc)
+        return false;
+
+    // Most recently used
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    values = std::move(res);
+    return true;
+}
+
+void HCResultCache::store(uint64_t key, const std::vector<double>& values)
+{
+    const std::string path = getPath(key);
+    const std::string tmp = getTemporaryName(path);
+
+    EntryHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.crc = HCDeflate::crc32(0, values.data(), values.size() * sizeof(double));
+    header.key = key;
+    header.count = values.size();
+
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(double)));
+    out.close();
+
+    std::error_code ec;
+    if (!out) {
+        fs::remove(tmp, ec);
+        HCLogError("Unable to write the cache entry " + path);
+        return;
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        HCLogError("Unable to write the cache entry " + path);
+        return;
+    }
+
+    evict();
+}
+
+void HCResultCache::evict()
+{
+    std::lock_guard<std::mutex> lock(m_evictMutex);
+
+    struct Entry
+    {
+        fs::path            path;
+        fs::file_time_type  time;
+        uint64_t            size;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != EXTENSION)
+            continue;
+        std::error_code entryEc;
+        Entry entry { it->path(), it->last_write_time(entryEc), it->file_size(entryEc) };
+        if (entryEc)
+            continue; // removed by another run
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    if (total <= m_maxSize)
+        return;
+
+    // Oldest first
+    std::sort(entries.begin(), entries.end(),
+                [](const Entry& a, const Entry& b){ return a.time < b.time; });
+    size_t removed = 0;
+    for (const auto& entry : entries) {
+        if (total <= m_maxSize)
+            break;
+        if (fs::remove(entry.path, ec))
+            ++removed;
+        total -= entry.size;
+    }
+    HCLogInfo("Cache: " + std::to_string(removed) + " entries evicted from " + m_directory);
+}
+
+const std::string& HCResultCache::getDirectory() const
+{
+    return m_directory;
+}
+
+std::string HCResultCache::getPath(uint64_t key) const
+{
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (fs::path(m_directory) / (std::string(name) + EXTENSION)).string();
+}
@@ -0,0 +1,193 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCScheduler.hpp"
+#include "HCMetrics.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    // Identify the worker deque of the current thread
+    thread_local const HCScheduler* t_owner = nullptr;
+    thread_local unsigned           t_index = 0;
+}
+
+HCScheduler::HCScheduler(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // The calling thread is the last one
+    for (unsigned i = 0; i + 1 < threads; ++i)
+        m_workers.push_back(std::make_unique<Worker>());
+
+    for (unsigned i = 0; i < m_workers.size(); ++i)
+        m_threads.emplace_back(&HCScheduler::workerLoop, this, i);
+}
+
+HCScheduler::~HCScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+
+    for (auto& t : m_threads)
+        t.join();
+}
+
+unsigned HCScheduler::getThreadCount() const
+{
+    return static_cast<unsigned>(m_workers.size()) + 1;
+}
+
+void HCScheduler::parallelFor(size_t begin, size_t end, size_t grain,
+                            const std::function<void(size_t, size_t)>& fn)
+{
+    if (end <= begin)
+        return;
+
+    // Nothing to share
+    if (m_workers.empty()) {
+        fn(begin, end);
+        return;
+    }
+
+    size_t n = end - begin;
+    if (grain == 0)
+        grain = std::max<size_t>(1, n / (4 * getThreadCount()));
+    size_t nTasks = (n + grain - 1) / grain;
+
+    TaskGroup group;
+    group.pending = nTasks;
+
+    // A worker keeps its sub tasks (the others will steal them),
+    // an external thread deals them round robin
+    const bool isWorker = (t_owner == this);
+    const unsigned self = isWorker ? t_index : static_cast<unsigned>(m_workers.size());
+
+    HCMetrics* metrics = HCMetrics::current();
+    for (size_t t = 0; t < nTasks; ++t) {
+        Task task { &fn, begin + t * grain, std::min(end, begin + (t + 1) * grain), &group, metrics };
+        Worker& w = isWorker ? *m_workers[self] : *m_workers[t % m_workers.size()];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.tasks.push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queued += nTasks;
+    }
+    m_wakeUp.notify_all();
+
+    // Help until the whole group is done
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (findTask(self, task))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+
+    if (group.error)
+        std::rethrow_exception(group.error);
+}
+
+/////////////////////////////////////////////
+//
+// Private
+//
+//////////////////////////////////////////////
+
+void HCScheduler::TaskDeque::push_back(const Task& task)
+{
+    if (m_size == m_ring.size()) {
+        // Unwrap in a ring twice as large
+        std::vector<Task> ring(std::max<size_t>(16, 2 * m_ring.size()));
+        for (size_t i = 0; i < m_size; ++i)
+            ring[i] = m_ring[(m_head + i) & (m_ring.size() - 1)];
+        m_ring.swap(ring);
+        m_head = 0;
+    }
+    m_ring[(m_head + m_size) & (m_ring.size() - 1)] = task;
+    ++m_size;
+}
+
+void HCScheduler::workerLoop(unsigned index)
+{
+    t_owner = this;
+    t_index = index;
+
+    while (!m_stop) {
+        Task task;
+        if (findTask(index, task)) {
+            execute(task);
+        } else {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [&]{ return m_stop || m_queued > 0; });
+        }
+    }
+}
+
+bool HCScheduler::findTask(unsigned index, Task& task)
+{
+    const unsigned n = static_cast<unsigned>(m_workers.size());
+
+    // Own deque, newest first
+    if (index < n) {
+        Worker& w = *m_workers[index];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.tasks.empty()) {
+            task = w.tasks.back();
+            w.tasks.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another deque
+    unsigned start = m_nextVictim.fetch_add(1, std::memory_order_relaxed);
+    for (unsigned i = 0; i < n; ++i) {
+        unsigned victim = (start + i) % n;
+        if (victim == index)
+            continue;
+        Worker& w = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.tasks.empty()) {
+            task = w.tasks.front();
+            w.tasks.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HCScheduler::execute(const Task& task)
+{
+    {
+        // Counts flushed before the group is signaled
+        HCMetrics::Binding binding(task.metrics);
+        try {
+            (*task.fn)(task.begin, task.end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(task.group->errorMutex);
+            if (!task.group->error)
+                task.group->error = std::current_exception();
+        }
+    }
+    task.group->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
\ No newline at end of file
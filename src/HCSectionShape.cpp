@@ -0,0 +1,604 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCMetrics.hpp"
+#include "HCPolygon.hpp"
+#include "HCSectionShape.hpp"
+#include "HCSideKernel.hpp"
+
+// This file shall be compiled with -ffp-contract=off (see CMakeLists.txt),
+// as HCSideKernel, so that the vertices are classified the same way.
+
+using namespace HydroCpp;
+
+namespace
+{
+    constexpr double ON_LINE_TOLERANCE = 1e-8;  // as HCSideKernel
+    constexpr double TURN_TOLERANCE = 1e-12;    // collinear edges, relative
+
+    /**
+     * @brief signed distance to the line, as in the kernels of HCSideKernel
+     */
+    template<typename Line>
+    struct Distance
+    {
+        static constexpr bool horizontal = std::is_same_v<Line, HCHorizontalLine>;
+
+        double cx, cy;      // start point C
+        double dcx, dcy;    // vector CD
+        double tol;
+
+        explicit Distance(const std::pair<HCPoint,HCPoint>& line)
+            : cx(line.first.x), cy(line.first.y),
+              dcx(line.second.x - line.first.x), dcy(line.second.y - line.first.y),
+              tol(horizontal ? ON_LINE_TOLERANCE / std::abs(dcx) : ON_LINE_TOLERANCE)
+        {}
+
+        /**
+         * @return the distance, negative on the right (wet), exactly 0
+         * on the line
+         */
+        inline double distance(const HCPoint& p) const
+        {
+            double dist;
+            if constexpr (horizontal)
+                dist = p.y - cy;
+            else
+                dist = dcx * (p.y - cy) - dcy * (p.x - cx);
+            return std::abs(dist) < tol ? 0.0 : dist;
+        }
+
+        /**
+         * @return 1 right (wet), -1 left (dry), 0 on the line
+         */
+        inline int side(const HCPoint& p) const
+        {
+            const double dist = distance(p);
+            if (dist == 0.0)
+                return 0;
+            return dist < 0 ? 1 : -1;
+        }
+    };
+
+    /**
+     * @brief shoelace terms of the edge PQ, area, x and y moments
+     */
+    inline void addEdge(double& area, double& Mx, double& My, const HCPoint& P, const HCPoint& Q)
+    {
+        double cross = P.x * Q.y - Q.x * P.y;
+        area += cross;
+        Mx += (P.x + Q.x) * cross;
+        My += (P.y + Q.y) * cross;
+    }
+}
+
+HCSectionShape::HCSectionShape(const HCPoint* vertices, size_t n)
+        : m_shape(classify(vertices, n)), m_n(n)
+{
+    m_sums.resize(n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        Sums s = m_sums[i];
+        addEdge(s.area, s.Mx, s.My, vertices[i], vertices[i + 1 < n ? i + 1 : 0]);
+        m_sums[i + 1] = s;
+    }
+
+    // Triangulated once, for the waterlines the kernels leave. The
+    // vertices on a straight edge add no area, without them the sides
+    // and the decks aren't cut in slivers crossed by every waterline
+    std::vector<uint32_t> corners;
+    std::vector<HCPoint> ring;
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P = vertices[i > 0 ? i - 1 : n - 1];
+        const HCPoint& Q = vertices[i];
+        const HCPoint& R = vertices[i + 1 < n ? i + 1 : 0];
+        const double ux = Q.x - P.x, uy = Q.y - P.y;
+        const double vx = R.x - Q.x, vy = R.y - Q.y;
+        const double cross = ux * vy - uy * vx;
+        const double limit = TURN_TOLERANCE * std::hypot(ux, uy) * std::hypot(vx, vy);
+        if (std::abs(cross) > limit || ux * vx + uy * vy < 0) {
+            corners.push_back(static_cast<uint32_t>(i));
+            ring.push_back(Q);
+        }
+    }
+    HCPolygon::triangulate(ring.data(), ring.size(), m_triangles);
+    const size_t m = ring.size();
+    m_outline.resize(m_triangles.size());
+    for (size_t k = 0; k < m_triangles.size(); ++k) {
+        std::array<uint32_t, 3>& t = m_triangles[k];
+        for (size_t j = 0; j < 3; ++j) {
+            const size_t gap = (t[j < 2 ? j + 1 : 0] + m - t[j]) % m;
+            if (gap == 1 || gap == m - 1)
+                m_outline[k] |= static_cast<uint8_t>(1u << j);
+        }
+        t = { corners[t[0]], corners[t[1]], corners[t[2]] };
+    }
+    m_triangleSums.resize(m_triangles.size());
+    for (size_t k = 0; k < m_triangles.size(); ++k) {
+        Sums& s = m_triangleSums[k];
+        for (size_t j = 0; j < 3; ++j)
+            addEdge(s.area, s.Mx, s.My, vertices[m_triangles[k][j]],
+                    vertices[m_triangles[k][j < 2 ? j + 1 : 0]]);
+    }
+
+    if (m_shape == HCShape::General)
+        return;
+
+    m_xMin = m_xMax = vertices[0].x;
+    m_yMin = m_yMax = vertices[0].y;
+    for (size_t i = 1; i < n; ++i) {
+        const HCPoint& P = vertices[i];
+        m_xMin = std::min(m_xMin, P.x);
+        m_xMax = std::max(m_xMax, P.x);
+        if (P.y < m_yMin) {
+            m_yMin = P.y;
+            m_lowest = i;
+        }
+        if (P.y > m_yMax) {
+            m_yMax = P.y;
+            m_highest = i;
+        }
+    }
+
+    // Edge angles from the lowest one, the collinear edges may differ
+    // by rounding
+    std::vector<double> angles(n);
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P = vertices[i];
+        const HCPoint& Q = vertices[i + 1 < n ? i + 1 : 0];
+        angles[i] = std::atan2(Q.y - P.y, Q.x - P.x);
+    }
+    m_firstEdge = static_cast<size_t>(std::min_element(angles.begin(), angles.end())
+                                        - angles.begin());
+    m_angles.resize(n);
+    for (size_t k = 0; k < n; ++k)
+        m_angles[k] = angles[(m_firstEdge + k) % n];
+    for (size_t k = 1; k < n; ++k)
+        m_angles[k] = std::max(m_angles[k], m_angles[k - 1]);
+}
+
+HCSectionShape::~HCSectionShape() = default;
+
+HCShape HCSectionShape::getShape() const
+{
+    return m_shape;
+}
+
+HCShape HCSectionShape::classify(const HCPoint* vertices, size_t n)
+{
+    if (n < 3)
+        return HCShape::General;
+
+    // Convex: left turns only, collinear edges allowed but no spike, and
+    // the edge angles sorted from the lowest one, i.e. turning once
+    double area = 0.0;
+    size_t first = 0;
+    std::vector<double> angles(n);
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P = vertices[i];
+        const HCPoint& Q = vertices[i + 1 < n ? i + 1 : 0];
+        const HCPoint& R = vertices[i + 2 < n ? i + 2 : i + 2 - n];
+        const double ux = Q.x - P.x, uy = Q.y - P.y;
+        const double vx = R.x - Q.x, vy = R.y - Q.y;
+        if ((ux == 0.0 && uy == 0.0) || (vx == 0.0 && vy == 0.0))
+            return HCShape::General;
+        const double cross = ux * vy - uy * vx;
+        const double limit = TURN_TOLERANCE * std::hypot(ux, uy) * std::hypot(vx, vy);
+        if (cross < -limit || (cross <= limit && ux * vx + uy * vy < 0))
+            return HCShape::General;
+        area += P.x * Q.y - Q.x * P.y;
+        angles[i] = std::atan2(uy, ux);
+        if (angles[i] < angles[first])
+            first = i;
+    }
+    if (area <= 0.0)
+        return HCShape::General;
+    for (size_t k = 1; k < n; ++k) {
+        if (angles[(first + k) % n] < angles[(first + k - 1) % n] - TURN_TOLERANCE)
+            return HCShape::General;
+    }
+
+    // Rectangle: every vertex on the bounding box, its 4 corners included
+    double xMin = vertices[0].x, xMax = xMin, yMin = vertices[0].y, yMax = yMin;
+    for (size_t i = 1; i < n; ++i) {
+        xMin = std::min(xMin, vertices[i].x);
+        xMax = std::max(xMax, vertices[i].x);
+        yMin = std::min(yMin, vertices[i].y);
+        yMax = std::max(yMax, vertices[i].y);
+    }
+    unsigned corners = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P = vertices[i];
+        const bool onX = P.x == xMin || P.x == xMax;
+        const bool onY = P.y == yMin || P.y == yMax;
+        if (!onX && !onY)
+            return HCShape::Convex;
+        if (onX && onY)
+            corners |= 1u << ((P.x == xMax ? 1 : 0) + (P.y == yMax ? 2 : 0));
+    }
+    return corners == 0xF ? HCShape::Rectangle : HCShape::Convex;
+}
+
+template<typename Line>
+bool HCSectionShape::cut(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                        double wl, HCSectionCut& cut) const
+{
+    switch (m_shape) {
+    case HCShape::Rectangle:
+        // Integrated below the waterline
+        if (line.first.x < line.second.x)
+            return cutRectangle<Line>(line, wl, cut);
+        return cutConvex<Line>(vertices, line, wl, cut);
+    case HCShape::Convex:
+        return cutConvex<Line>(vertices, line, wl, cut);
+    default:
+        return false;
+    }
+}
+
+size_t HCSectionShape::extremeVertex(double angle) const
+{
+    // The first edge turning past the angle starts at the vertex
+    const double twoPi = 2 * M_PI;
+    if (angle < m_angles.front())
+        angle += twoPi;
+    else if (angle >= m_angles.front() + twoPi)
+        angle -= twoPi;
+    size_t k = static_cast<size_t>(std::lower_bound(m_angles.begin(), m_angles.end(), angle)
+                                    - m_angles.begin());
+    if (k == m_n)
+        k = 0;
+    return (m_firstEdge + k) % m_n;
+}
+
+template<typename Line>
+bool HCSectionShape::cutRectangle(const std::pair<HCPoint,HCPoint>& line, double wl,
+                                HCSectionCut& cut) const
+{
+    cut = HCSectionCut();
+    const Distance<Line> D(line);
+
+    const HCPoint corners[4] = { HCPoint(m_xMin, m_yMin), HCPoint(m_xMax, m_yMin),
+                                 HCPoint(m_xMax, m_yMax), HCPoint(m_xMin, m_yMax) };
+    bool hasLeft = false, hasRight = false;
+    for (const HCPoint& P : corners) {
+        int side = D.side(P);
+        if (side == 0)
+            return false; // corner on the line
+        hasLeft = hasLeft || side < 0;
+        hasRight = hasRight || side > 0;
+    }
+    HCMetrics::add(HC_VERTICES_CLASSIFIED, 4);
+    cut.dryEmpty = !hasLeft;
+    if (!hasRight)
+        return true; // dry section
+
+    // Height of the wet part above the bottom, linear between the
+    // abscissae where the waterline crosses the bottom and the top, at
+    // which it is set exactly: a rounded zero would weigh on the whole
+    // breadth of the next piece
+    const double slope = Distance<Line>::horizontal ? 0.0 : D.dcy / D.dcx;
+    auto height = [&](double x){
+        return std::clamp(D.cy + slope * (x - D.cx), m_yMin, m_yMax) - m_yMin;
+    };
+    std::pair<double,double> xs[4] = { { m_xMin, height(m_xMin) }, { m_xMax, height(m_xMax) } };
+    size_t nx = 2;
+    double xBottom = m_xMin, xTop = m_xMax;
+    if (slope != 0.0) {
+        xBottom = D.cx + (m_yMin - D.cy) / slope;
+        xTop = D.cx + (m_yMax - D.cy) / slope;
+        if (xBottom > m_xMin && xBottom < m_xMax)
+            xs[nx++] = { xBottom, 0.0 };
+        if (xTop > m_xMin && xTop < m_xMax)
+            xs[nx++] = { xTop, m_yMax - m_yMin };
+        std::sort(xs, xs + nx);
+    }
+
+    double area = 0.0, Mx = 0.0, My = 0.0;
+    for (size_t k = 0; k + 1 < nx; ++k) {
+        const auto [a, ga] = xs[k];
+        const auto [b, gb] = xs[k + 1];
+        const double h = b - a;
+        area += h * (ga + gb) / 2;
+        Mx += h * (a * (2 * ga + gb) + b * (ga + 2 * gb)) / 6;
+        My += h * (ga * ga + ga * gb + gb * gb) / 6 + m_yMin * h * (ga + gb) / 2;
+    }
+    cut.area = area;
+    if (area > 0) {
+        cut.Mx = Mx;
+        cut.My = My;
+    }
+    if (!hasLeft)
+        return true; // wet section, no chord
+
+    // Chord between the sides, or the bottom and the top where it crosses them
+    const double xa = std::max(m_xMin, std::min(xBottom, xTop));
+    const double xb = std::min(m_xMax, std::max(xBottom, xTop));
+    const HCPoint c0(xa, D.cy + slope * (xa - D.cx)), c1(xb, D.cy + slope * (xb - D.cx));
+    double L = c0.distanceTo(c1);
+    HCPoint mid((c0.x + c1.x) / 2, (c0.y + c1.y) / 2);
+    double dt = mid.distanceTo(HCPoint(0.0, wl));
+    cut.chordLength = L;
+    cut.chordInertia = pow(L, 3) / 12 + L * pow(dt, 2);
+    HCMetrics::add(HC_INTERSECTIONS, 2);
+
+    return true;
+}
+
+template<typename Line>
+bool HCSectionShape::cutConvex(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                            double wl, HCSectionCut& cut) const
+{
+    constexpr bool horizontal = Distance<Line>::horizontal;
+    cut = HCSectionCut();
+    const Distance<Line> D(line);
+    const size_t n = m_n;
+
+    // Lowest and highest vertices for the line
+    size_t lo = m_lowest, hi = m_highest;
+    if constexpr (!horizontal) {
+        const double angle = std::atan2(D.dcy, D.dcx);
+        lo = extremeVertex(angle);
+        hi = extremeVertex(angle + M_PI);
+    }
+    const int sideLo = D.side(vertices[lo]);
+    const int sideHi = D.side(vertices[hi]);
+    size_t classified = 2;
+    if (sideLo == 0 || sideHi == 0) {
+        HCMetrics::add(HC_VERTICES_CLASSIFIED, classified);
+        return false; // vertex on the line
+    }
+    if (sideLo < 0) {
+        HCMetrics::add(HC_VERTICES_CLASSIFIED, classified);
+        return true; // dry section
+    }
+    if (sideHi > 0) {
+        // Wet section
+        HCMetrics::add(HC_VERTICES_CLASSIFIED, classified);
+        cut.dryEmpty = true;
+        cut.area = m_sums[n].area / 2;
+        if (cut.area > 0) {
+            cut.Mx = m_sums[n].Mx / 6;
+            cut.My = m_sums[n].My / 6;
+        }
+        return true;
+    }
+
+    // Going down from the highest vertex, the first one not on the left
+    // is the first wet one
+    size_t a = 1, b = (lo + n - hi) % n;
+    while (a < b) {
+        size_t m = a + (b - a) / 2;
+        ++classified;
+        if (D.side(vertices[(hi + m) % n]) < 0)
+            a = m + 1;
+        else
+            b = m;
+    }
+    const size_t wetFirst = (hi + a) % n;
+    const size_t edgeIn = (hi + a - 1) % n;
+
+    // Going up from the lowest vertex, the first one not on the right
+    // follows the last wet one
+    size_t c = 1, d = (hi + n - lo) % n;
+    while (c < d) {
+        size_t m = c + (d - c) / 2;
+        ++classified;
+        if (D.side(vertices[(lo + m) % n]) > 0)
+            c = m + 1;
+        else
+            d = m;
+    }
+    const size_t wetLast = (lo + c - 1) % n;
+    const size_t edgeOut = wetLast;
+    classified += 2;
+    HCMetrics::add(HC_VERTICES_CLASSIFIED, classified);
+    if (D.side(vertices[wetFirst]) == 0 || D.side(vertices[(lo + c) % n]) == 0)
+        return false; // vertex on the line
+
+    // Same intersections as HCHalfPlaneClip, edges in the ring order
+    const bool inFirst = edgeIn < edgeOut;
+    const uint32_t edges[2] = { static_cast<uint32_t>(std::min(edgeIn, edgeOut)),
+                                static_cast<uint32_t>(std::max(edgeIn, edgeOut)) };
+    HCPoint cross[2] = { HCPoint(0, 0), HCPoint(0, 0) };
+    HCMetrics::add(HC_INTERSECTIONS, 2);
+    size_t parallel;
+    if constexpr (horizontal)
+        parallel = HCSideKernel::intersectHorizontal(vertices, n, edges, 2, line, cross);
+    else
+        parallel = HCSideKernel::intersect(vertices, n, edges, 2, line, cross);
+    if (parallel > 0)
+        return false;
+    const HCPoint& cIn = cross[inFirst ? 0 : 1];
+    const HCPoint& cOut = cross[inFirst ? 1 : 0];
+
+    // Wet edges from the prefix sums, closed by the crossings
+    Sums s;
+    const Sums& sFirst = m_sums[wetFirst];
+    const Sums& sLast = m_sums[wetLast];
+    if (wetFirst <= wetLast) {
+        s.area = sLast.area - sFirst.area;
+        s.Mx = sLast.Mx - sFirst.Mx;
+        s.My = sLast.My - sFirst.My;
+    } else {
+        s.area = m_sums[n].area - sFirst.area + sLast.area;
+        s.Mx = m_sums[n].Mx - sFirst.Mx + sLast.Mx;
+        s.My = m_sums[n].My - sFirst.My + sLast.My;
+    }
+    addEdge(s.area, s.Mx, s.My, cIn, vertices[wetFirst]);
+    addEdge(s.area, s.Mx, s.My, vertices[wetLast], cOut);
+    addEdge(s.area, s.Mx, s.My, cOut, cIn);
+
+    cut.area = s.area / 2;
+    if (cut.area > 0) {
+        cut.Mx = s.Mx / 6;
+        cut.My = s.My / 6;
+    }
+
+    double L = cross[0].distanceTo(cross[1]);
+    HCPoint mid((cross[0].x + cross[1].x) / 2, (cross[0].y + cross[1].y) / 2);
+    double dt = mid.distanceTo(HCPoint(0.0, wl));
+    cut.chordLength = L;
+    cut.chordInertia = pow(L, 3) / 12 + L * pow(dt, 2);
+
+    return true;
+}
+
+template<typename Line>
+bool HCSectionShape::cutTriangles(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                                double wl, HCSectionCut& cut) const
+{
+    cut = HCSectionCut();
+    const Distance<Line> D(line);
+    const size_t n = m_n;
+    if (m_triangles.empty())
+        return false;
+
+    // One distance per vertex, shared by its triangles, and the points
+    // of the line on the edges: vertices on it, or crossings
+    thread_local std::vector<double> buffer;
+    buffer.resize(n);
+    double* dist = buffer.data();
+    bool hasLeft = false, hasRight = false;
+    size_t points = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double d = D.distance(vertices[i]);
+        dist[i] = d;
+        hasLeft = hasLeft || d > 0;
+        hasRight = hasRight || d < 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const double d0 = dist[i];
+        const double d1 = dist[i + 1 < n ? i + 1 : 0];
+        points += d0 == 0 || (d0 < 0 && d1 > 0) || (d0 > 0 && d1 < 0);
+    }
+    HCMetrics::add(HC_VERTICES_CLASSIFIED, n);
+    if (points > 2)
+        return false; // several chords, or a chord split at a vertex
+    cut.dryEmpty = !hasLeft;
+    if (!hasRight)
+        return true; // dry section
+    if (!hasLeft) {
+        cut.area = m_sums[n].area / 2;
+        if (cut.area > 0) {
+            cut.Mx = m_sums[n].Mx / 6;
+            cut.My = m_sums[n].My / 6;
+        }
+        return true; // wet section
+    }
+
+    // Crossing of an edge, from its lower index so that both triangles
+    // of a diagonal get the same point. In plain doubles, as the other
+    // points of the loop below
+    auto crossing = [&](uint32_t a, uint32_t b, double& x, double& y){
+        if (a > b)
+            std::swap(a, b);
+        const HCPoint& A = vertices[a];
+        const HCPoint& B = vertices[b];
+        const double t = dist[a] / (dist[a] - dist[b]);
+        x = A.x + t * (B.x - A.x);
+        y = Distance<Line>::horizontal ? D.cy : A.y + t * (B.y - A.y);
+    };
+
+    // Chords by their abscissae along the line, from its point of x = 0
+    // the reference of the inertia: no square root per triangle
+    const double norm = std::hypot(D.dcx, D.dcy);
+    const double ex = D.dcx / norm, ey = D.dcy / norm;
+    auto abscissa = [&](double x, double y){
+        return x * ex + (y - wl) * ey;
+    };
+    auto addChord = [&](double u0, double u1){
+        const double L = std::abs(u1 - u0);
+        const double mid = (u0 + u1) / 2;
+        cut.chordLength += L;
+        cut.chordInertia += L * L * L / 12 + L * mid * mid;
+    };
+
+    Sums s;
+    size_t crossings = 0;
+    for (size_t k = 0; k < m_triangles.size(); ++k) {
+        const std::array<uint32_t, 3>& t = m_triangles[k];
+        const double d[3] = { dist[t[0]], dist[t[1]], dist[t[2]] };
+
+        if (d[0] <= 0 && d[1] <= 0 && d[2] <= 0) {
+            const Sums& ts = m_triangleSums[k];
+            s.area += ts.area;
+            s.Mx += ts.Mx;
+            s.My += ts.My;
+            // A diagonal on the line is a chord, between this triangle
+            // and a dry one, but not an edge of the section, as for
+            // HCPolygonSplitter
+            for (size_t j = 0; j < 3; ++j) {
+                const size_t j1 = j < 2 ? j + 1 : 0;
+                const size_t j2 = j1 < 2 ? j1 + 1 : 0;
+                if (d[j] == 0 && d[j1] == 0 && d[j2] < 0 && !(m_outline[k] & (1u << j)))
+                    addChord(abscissa(vertices[t[j]].x, vertices[t[j]].y),
+                            abscissa(vertices[t[j1]].x, vertices[t[j1]].y));
+            }
+            continue;
+        }
+        if (d[0] >= 0 && d[1] >= 0 && d[2] >= 0)
+            continue; // dry triangle
+
+        // Cut triangle: its wet part, and the chord through it between
+        // the vertex on the line and the crossings
+        double wx[4], wy[4];
+        double on[2] = { 0.0, 0.0 };
+        size_t nWet = 0, nOn = 0;
+        for (size_t j = 0; j < 3; ++j) {
+            const size_t j1 = j < 2 ? j + 1 : 0;
+            const HCPoint& P = vertices[t[j]];
+            if (d[j] <= 0) {
+                wx[nWet] = P.x;
+                wy[nWet++] = P.y;
+            }
+            if (d[j] == 0) {
+                on[nOn++] = abscissa(P.x, P.y);
+            } else if ((d[j] < 0 && d[j1] > 0) || (d[j] > 0 && d[j1] < 0)) {
+                crossing(t[j], t[j1], wx[nWet], wy[nWet]);
+                on[nOn++] = abscissa(wx[nWet], wy[nWet]);
+                ++nWet;
+                ++crossings;
+            }
+        }
+        for (size_t j = 0; j < nWet; ++j) {
+            const size_t j1 = j + 1 < nWet ? j + 1 : 0;
+            const double cross = wx[j] * wy[j1] - wx[j1] * wy[j];
+            s.area += cross;
+            s.Mx += (wx[j] + wx[j1]) * cross;
+            s.My += (wy[j] + wy[j1]) * cross;
+        }
+        addChord(on[0], on[1]);
+    }
+    HCMetrics::add(HC_INTERSECTIONS, crossings);
+
+    cut.area = s.area / 2;
+    if (cut.area > 0) {
+        cut.Mx = s.Mx / 6;
+        cut.My = s.My / 6;
+    }
+    return true;
+}
+
+namespace HydroCpp
+{
+    template bool HCSectionShape::cut<HCGeneralLine>(const HCPoint*,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&) const;
+    template bool HCSectionShape::cut<HCHorizontalLine>(const HCPoint*,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&) const;
+    template bool HCSectionShape::cutTriangles<HCGeneralLine>(const HCPoint*,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&) const;
+    template bool HCSectionShape::cutTriangles<HCHorizontalLine>(const HCPoint*,
+                            const std::pair<HCPoint,HCPoint>&, double, HCSectionCut&) const;
+}
@@ -0,0 +1,172 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cmath>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCSectionSweep.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    /**
+     * @brief edge of the section in the (u, v) frame, from its lowest
+     * end (ulo, vlo) to its highest v
+     */
+    struct SweepEdge
+    {
+        double  ulo;
+        double  vlo;
+        double  vhi;
+        double  k;      // du/dv
+        double  sign;   // +1 if the edge goes upward in the ring order
+    };
+}
+
+HCSectionSweep::HCSectionSweep(const HCPoint* vertices, size_t n, const HCPoint& direction)
+        : m_dir(direction), m_normal(0.0, 0.0)
+{
+    double norm = m_dir.distanceToOrigin();
+    if (norm > 0.0) {
+        m_dir.x /= norm;
+        m_dir.y /= norm;
+    }
+    m_normal = HCPoint(-m_dir.y, m_dir.x);
+
+    if (n < 3)
+        return;
+
+    // Edges in the (u, v) frame, horizontal ones don't contribute
+    std::vector<SweepEdge> edges;
+    std::vector<double> events;
+    edges.reserve(n);
+    events.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const HCPoint& P0 = vertices[i];
+        const HCPoint& P1 = vertices[i + 1 < n ? i + 1 : 0];
+        double u0 = abscissa(P0), v0 = offset(P0);
+        double u1 = abscissa(P1), v1 = offset(P1);
+        events.push_back(v0);
+        if (v0 == v1)
+            continue;
+        double k = (u1 - u0) / (v1 - v0);
+        if (v0 < v1)
+            edges.push_back({ u0, v0, v1, k, 1.0 });
+        else
+            edges.push_back({ u1, v1, v0, k, -1.0 });
+    }
+
+    std::sort(events.begin(), events.end());
+    events.erase(std::unique(events.begin(), events.end()), events.end());
+    std::sort(edges.begin(), edges.end(), [](const SweepEdge& a, const SweepEdge& b){
+        return a.vlo < b.vlo;
+    });
+
+    // Sweep upward, carrying the integrals from one breakpoint to the next
+    m_pieces.reserve(events.size());
+    std::vector<const SweepEdge*> active;
+    size_t nextEdge = 0;
+    Piece state;
+    for (size_t j = 0; j < events.size(); ++j) {
+        const double t = events[j];
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                    [t](const SweepEdge* e){ return e->vhi <= t; }), active.end());
+        while (nextEdge < edges.size() && edges[nextEdge].vlo <= t)
+            active.push_back(&edges[nextEdge++]);
+
+        Piece p;
+        p.t = t;
+        p.A = state.A;
+        p.Mu = state.Mu;
+        p.Mv = state.Mv;
+        for (const SweepEdge* e : active) {
+            double u = e->ulo + e->k * (t - e->vlo);
+            double k = e->k;
+            double s = e->sign;
+            p.su += s * u;
+            p.sk += s * k;
+            p.suu += s * u * u;
+            p.suk += s * u * k;
+            p.skk += s * k * k;
+            p.suuu += s * u * u * u;
+            p.suuk += s * u * u * k;
+            p.sukk += s * u * k * k;
+            p.skkk += s * k * k * k;
+        }
+        m_pieces.push_back(p);
+
+        if (j + 1 < events.size()) {
+            double h = events[j + 1] - t;
+            state.A = p.A + p.su * h + p.sk * h * h / 2;
+            state.Mu = p.Mu + (p.suu * h + p.suk * h * h + p.skk * h * h * h / 3) / 2;
+            state.Mv = p.Mv + t * (p.su * h + p.sk * h * h / 2)
+                        + p.su * h * h / 2 + p.sk * h * h * h / 3;
+        }
+    }
+}
+
+HCSectionSweep::~HCSectionSweep() = default;
+
+double HCSectionSweep::offset(const HCPoint& M) const
+{
+    return M.x * m_normal.x + M.y * m_normal.y;
+}
+
+double HCSectionSweep::abscissa(const HCPoint& M) const
+{
+    return M.x * m_dir.x + M.y * m_dir.y;
+}
+
+double HCSectionSweep::getMinOffset() const
+{
+    return m_pieces.empty() ? 0.0 : m_pieces.front().t;
+}
+
+double HCSectionSweep::getMaxOffset() const
+{
+    return m_pieces.empty() ? 0.0 : m_pieces.back().t;
+}
+
+HCSectionCut HCSectionSweep::cut(double c, double u0, double tolerance) const
+{
+    HCSectionCut res;
+    if (m_pieces.empty() || c <= m_pieces.front().t)
+        return res;
+
+    res.dryEmpty = (m_pieces.back().t - c) < tolerance;
+
+    // Piece containing c
+    auto it = std::upper_bound(m_pieces.begin(), m_pieces.end(), c,
+                    [](double v, const Piece& p){ return v < p.t; });
+    const Piece& p = *std::prev(it);
+    const double h = c - p.t;
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+
+    double A = p.A + p.su * h + p.sk * h2 / 2;
+    double Mu = p.Mu + (p.suu * h + p.suk * h2 + p.skk * h3 / 3) / 2;
+    double Mv = p.Mv + p.t * (p.su * h + p.sk * h2 / 2) + p.su * h2 / 2 + p.sk * h3 / 3;
+
+    // Chords along the waterline: length, first and second moments in u
+    double L = p.su + p.sk * h;
+    double S1 = (p.suu + 2 * p.suk * h + p.skk * h2) / 2;
+    double S2 = (p.suuu + 3 * p.suuk * h + 3 * p.sukk * h2 + p.skkk * h3) / 3;
+
+    res.area = A;
+    res.Mx = Mu * m_dir.x + Mv * m_normal.x;
+    res.My = Mu * m_dir.y + Mv * m_normal.y;
+    res.chordLength = L;
+    res.chordInertia = S2 - 2 * u0 * S1 + u0 * u0 * L;
+
+    return res;
+}
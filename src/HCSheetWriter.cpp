@@ -0,0 +1,525 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+#include "HCSheetWriter.hpp"
+#include "HCCurves.hpp"
+#include "HCDeflate.hpp"
+
+using namespace HydroCpp;
+
+namespace
+{
+    constexpr uint32_t LOCAL_SIGNATURE      = 0x04034b50;
+    constexpr uint32_t CENTRAL_SIGNATURE    = 0x02014b50;
+    constexpr uint32_t END_SIGNATURE        = 0x06054b50;
+    constexpr size_t   LOCAL_HEADER_SIZE    = 30;
+    constexpr size_t   CENTRAL_HEADER_SIZE  = 46;
+    constexpr size_t   END_SIZE             = 22;
+    constexpr uint16_t METHOD_STORED        = 0;
+    constexpr uint16_t METHOD_DEFLATED      = 8;
+    constexpr uint16_t FLAG_DESCRIPTOR      = 0x0008;
+
+    inline uint16_t read16(const uint8_t* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    inline uint32_t read32(const uint8_t* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+            | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline void put16(std::string& s, uint16_t v)
+    {
+        s += static_cast<char>(v & 0xFF);
+        s += static_cast<char>(v >> 8);
+    }
+
+    inline void put32(std::string& s, uint32_t v)
+    {
+        put16(s, static_cast<uint16_t>(v & 0xFFFF));
+        put16(s, static_cast<uint16_t>(v >> 16));
+    }
+
+    inline uint32_t checked32(uint64_t v)
+    {
+        if (v >= 0xFFFFFFFFull)
+            throw std::runtime_error("Workbook too large (zip64 is not supported)");
+        return static_cast<uint32_t>(v);
+    }
+
+    /**
+     * @brief value of an attribute in the tag [begin, end) of an XML text
+     */
+    std::string attribute(const std::string& xml, size_t begin, size_t end,
+                        const std::string& name)
+    {
+        const std::string key = name + "=\"";
+        size_t pos = begin;
+        while ((pos = xml.find(key, pos)) != std::string::npos && pos < end) {
+            if (pos > begin && std::isspace(static_cast<unsigned char>(xml[pos - 1]))) {
+                size_t first = pos + key.size();
+                size_t last = xml.find('"', first);
+                if (last == std::string::npos || last > end)
+                    break;
+                return xml.substr(first, last - first);
+            }
+            pos += key.size();
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief spreadsheet name of a 0 based column: A, B, ... Z, AA, ...
+     */
+    std::string columnName(size_t c)
+    {
+        std::string name;
+        ++c;
+        while (c > 0) {
+            name.insert(name.begin(), static_cast<char>('A' + (c - 1) % 26));
+            c = (c - 1) / 26;
+        }
+        return name;
+    }
+
+    /**
+     * @brief position of the data of an entry, after its local header
+     */
+    uint64_t dataOffset(std::ifstream& in, uint32_t offset, const std::string& filename)
+    {
+        uint8_t h[LOCAL_HEADER_SIZE];
+        in.seekg(offset);
+        in.read(reinterpret_cast<char*>(h), LOCAL_HEADER_SIZE);
+        if (!in || read32(h) != LOCAL_SIGNATURE)
+            throw std::runtime_error(filename + " : corrupted local header");
+        return uint64_t(offset) + LOCAL_HEADER_SIZE + read16(h + 26) + read16(h + 28);
+    }
+
+    std::string localHeader(uint16_t versionNeeded, uint16_t flags, uint16_t method,
+                        uint16_t time, uint16_t date, uint32_t crc,
+                        uint32_t compressedSize, uint32_t size, const std::string& name)
+    {
+        std::string h;
+        h.reserve(LOCAL_HEADER_SIZE + name.size());
+        put32(h, LOCAL_SIGNATURE);
+        put16(h, versionNeeded);
+        put16(h, flags);
+        put16(h, method);
+        put16(h, time);
+        put16(h, date);
+        put32(h, crc);
+        put32(h, compressedSize);
+        put32(h, size);
+        put16(h, static_cast<uint16_t>(name.size()));
+        put16(h, 0);    // no extra field
+        h += name;
+        return h;
+    }
+}
+
+HCSheetWriter::HCSheetWriter(const std::string& filename):m_filename(filename)
+{
+}
+
+HCSheetWriter::~HCSheetWriter() = default;
+
+void HCSheetWriter::addSheet(const std::string& sheetName,
+                    std::vector<std::vector<double>> columns, uint32_t firstRow)
+{
+    Sheet s;
+    s.name = sheetName;
+    s.columns = std::move(columns);
+    s.firstRow = firstRow;
+    m_sheets.push_back(std::move(s));
+}
+
+void HCSheetWriter::write(HCScheduler* scheduler)
+{
+    std::ifstream in(m_filename, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Unable to open " + m_filename);
+
+    readDirectory(in);
+    resolveSheets(in);
+
+    const std::string tmpName = m_filename + ".tmp";
+    try {
+        std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Unable to create " + tmpName);
+
+        std::vector<Entry> written;
+        written.reserve(m_entries.size());
+        for (const Entry& e : m_entries) {
+            auto it = std::find_if(m_sheets.begin(), m_sheets.end(),
+                            [&e](const Sheet& s){ return s.path == e.name; });
+            if (it != m_sheets.end())
+                written.push_back(writeSheet(in, out, e, *it, scheduler));
+            else
+                written.push_back(copyEntry(in, out, e));
+        }
+
+        // Central directory
+        const uint64_t cdOffset = static_cast<uint64_t>(out.tellp());
+        std::string cd;
+        for (const Entry& e : written) {
+            cd.clear();
+            put32(cd, CENTRAL_SIGNATURE);
+            put16(cd, e.versionMadeBy);
+            put16(cd, e.versionNeeded);
+            put16(cd, e.flags);
+            put16(cd, e.method);
+            put16(cd, e.time);
+            put16(cd, e.date);
+            put32(cd, e.crc);
+            put32(cd, e.compressedSize);
+            put32(cd, e.size);
+            put16(cd, static_cast<uint16_t>(e.name.size()));
+            put16(cd, 0);   // no extra field
+            put16(cd, static_cast<uint16_t>(e.comment.size()));
+            put16(cd, 0);   // disk number
+            put16(cd, e.internalAttr);
+            put32(cd, e.externalAttr);
+            put32(cd, e.offset);
+            cd += e.name;
+            cd += e.comment;
+            out.write(cd.data(), static_cast<std::streamsize>(cd.size()));
+        }
+        const uint64_t cdEnd = static_cast<uint64_t>(out.tellp());
+
+        std::string end;
+        put32(end, END_SIGNATURE);
+        put16(end, 0);  // disk number
+        put16(end, 0);  // disk of the central directory
+        put16(end, static_cast<uint16_t>(written.size()));
+        put16(end, static_cast<uint16_t>(written.size()));
+        put32(end, checked32(cdEnd - cdOffset));
+        put32(end, checked32(cdOffset));
+        put16(end, 0);  // no comment
+        out.write(end.data(), static_cast<std::streamsize>(end.size()));
+
+        out.close();
+        if (!out)
+            throw std::runtime_error("Error writing " + tmpName);
+        in.close();
+        std::filesystem::rename(tmpName, m_filename);
+    } catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(tmpName, ec);
+        throw;
+    }
+}
+
+void HCSheetWriter::readDirectory(std::ifstream& in)
+{
+    in.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    if (fileSize < END_SIZE)
+        throw std::runtime_error(m_filename + " is not a zip archive");
+
+    // End of central directory record, followed by a comment of 64k at most
+    const uint64_t tailSize = std::min<uint64_t>(fileSize, END_SIZE + 0xFFFF);
+    std::vector<uint8_t> tail(tailSize);
+    in.seekg(static_cast<std::streamoff>(fileSize - tailSize));
+    in.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tailSize));
+
+    const uint8_t* eocd = nullptr;
+    for (size_t i = tailSize - END_SIZE + 1; i-- > 0; ) {
+        if (read32(&tail[i]) == END_SIGNATURE) {
+            eocd = &tail[i];
+            break;
+        }
+    }
+    if (!eocd)
+        throw std::runtime_error(m_filename + " is not a zip archive");
+
+    const uint16_t count = read16(eocd + 10);
+    const uint32_t cdSize = read32(eocd + 12);
+    const uint32_t cdOffset = read32(eocd + 16);
+    if (count == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF)
+        throw std::runtime_error(m_filename + " : zip64 archives are not supported");
+
+    std::vector<uint8_t> cd(cdSize);
+    in.seekg(cdOffset);
+    in.read(reinterpret_cast<char*>(cd.data()), cdSize);
+    if (!in)
+        throw std::runtime_error(m_filename + " : corrupted central directory");
+
+    m_entries.clear();
+    size_t p = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (p + CENTRAL_HEADER_SIZE > cd.size() || read32(&cd[p]) != CENTRAL_SIGNATURE)
+            throw std::runtime_error(m_filename + " : corrupted central directory");
+        const uint8_t* h = &cd[p];
+        Entry e;
+        e.versionMadeBy     = read16(h + 4);
+        e.versionNeeded     = read16(h + 6);
+        e.flags             = read16(h + 8);
+        e.method            = read16(h + 10);
+        e.time              = read16(h + 12);
+        e.date              = read16(h + 14);
+        e.crc               = read32(h + 16);
+        e.compressedSize    = read32(h + 20);
+        e.size              = read32(h + 24);
+        e.internalAttr      = read16(h + 36);
+        e.externalAttr      = read32(h + 38);
+        e.offset            = read32(h + 42);
+        // Their zip64 extra field would be lost when copied
+        if (e.compressedSize == 0xFFFFFFFF || e.size == 0xFFFFFFFF || e.offset == 0xFFFFFFFF)
+            throw std::runtime_error(m_filename + " : zip64 entries are not supported");
+        const size_t nameLen = read16(h + 28);
+        const size_t extraLen = read16(h + 30);
+        const size_t commentLen = read16(h + 32);
+        if (p + CENTRAL_HEADER_SIZE + nameLen + extraLen + commentLen > cd.size())
+            throw std::runtime_error(m_filename + " : corrupted central directory");
+        const char* s = reinterpret_cast<const char*>(h + CENTRAL_HEADER_SIZE);
+        e.name.assign(s, nameLen);
+        e.comment.assign(s + nameLen + extraLen, commentLen);
+        m_entries.push_back(std::move(e));
+        p += CENTRAL_HEADER_SIZE + nameLen + extraLen + commentLen;
+    }
+}
+
+std::string HCSheetWriter::readEntry(std::ifstream& in, const Entry& e) const
+{
+    std::vector<uint8_t> data(e.compressedSize);
+    in.seekg(static_cast<std::streamoff>(dataOffset(in, e.offset, m_filename)));
+    in.read(reinterpret_cast<char*>(data.data()), e.compressedSize);
+    if (!in)
+        throw std::runtime_error(m_filename + " : unable to read " + e.name);
+
+    if (e.method == METHOD_STORED)
+        return std::string(data.begin(), data.end());
+
+    std::vector<uint8_t> xml;
+    xml.reserve(e.size);
+    if (e.method != METHOD_DEFLATED
+            || !HCDeflate::decompress(data.data(), data.size(), xml))
+        throw std::runtime_error(m_filename + " : unable to decompress " + e.name);
+    return std::string(xml.begin(), xml.end());
+}
+
+void HCSheetWriter::resolveSheets(std::ifstream& in)
+{
+    auto findEntry = [this](const std::string& name) -> const Entry& {
+        for (const Entry& e : m_entries)
+            if (e.name == name)
+                return e;
+        throw std::runtime_error(m_filename + " : missing " + name);
+    };
+
+    const std::string workbook = readEntry(in, findEntry("xl/workbook.xml"));
+    const std::string rels = readEntry(in, findEntry("xl/_rels/workbook.xml.rels"));
+
+    for (Sheet& sheet : m_sheets) {
+        // Relationship id of the sheet in the workbook
+        std::string rId;
+        for (size_t pos = workbook.find("<sheet "); pos != std::string::npos;
+                    pos = workbook.find("<sheet ", pos + 1)) {
+            size_t end = workbook.find('>', pos);
+            if (attribute(workbook, pos, end, "name") == sheet.name) {
+                rId = attribute(workbook, pos, end, "r:id");
+                break;
+            }
+        }
+        if (rId.empty())
+            throw std::runtime_error(m_filename + " : missing sheet " + sheet.name);
+
+        // Part of the sheet
+        std::string target;
+        for (size_t pos = rels.find("<Relationship "); pos != std::string::npos;
+                    pos = rels.find("<Relationship ", pos + 1)) {
+            size_t end = rels.find('>', pos);
+            if (attribute(rels, pos, end, "Id") == rId) {
+                target = attribute(rels, pos, end, "Target");
+                break;
+            }
+        }
+        if (target.empty())
+            throw std::runtime_error(m_filename + " : missing part of sheet " + sheet.name);
+
+        sheet.path = target[0] == '/' ? target.substr(1) : "xl/" + target;
+        findEntry(sheet.path);
+    }
+}
+
+HCSheetWriter::Entry HCSheetWriter::copyEntry(std::ifstream& in, std::ofstream& out,
+                                            const Entry& e) const
+{
+    Entry res = e;
+    res.flags = e.flags & ~FLAG_DESCRIPTOR; // sizes are known, in the header
+    res.offset = checked32(static_cast<uint64_t>(out.tellp()));
+
+    const std::string h = localHeader(res.versionNeeded, res.flags, res.method,
+                            res.time, res.date, res.crc, res.compressedSize, res.size, res.name);
+    out.write(h.data(), static_cast<std::streamsize>(h.size()));
+
+    in.seekg(static_cast<std::streamoff>(dataOffset(in, e.offset, m_filename)));
+    std::vector<char> buffer(std::min<size_t>(e.compressedSize, size_t(1) << 20));
+    for (uint64_t left = e.compressedSize; left > 0; ) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(left, buffer.size()));
+        in.read(buffer.data(), static_cast<std::streamsize>(n));
+        if (!in)
+            throw std::runtime_error(m_filename + " : unable to read " + e.name);
+        out.write(buffer.data(), static_cast<std::streamsize>(n));
+        left -= n;
+    }
+    return res;
+}
+
+HCSheetWriter::Entry HCSheetWriter::writeSheet(std::ifstream& in, std::ofstream& out,
+                                const Entry& e, const Sheet& sheet, HCScheduler* scheduler) const
+{
+    std::string xml = readEntry(in, e);
+    const size_t nRows = sheet.columns.empty() ? 0 : sheet.columns[0].size();
+
+    // The rows go at the end of sheetData
+    size_t insertPos = xml.find("</sheetData>");
+    if (insertPos == std::string::npos) {
+        size_t emptyPos = xml.find("<sheetData/>");
+        if (emptyPos == std::string::npos)
+            throw std::runtime_error(m_filename + " : no sheetData in " + e.name);
+        xml.replace(emptyPos, 12, "<sheetData></sheetData>");
+        insertPos = emptyPos + 11;
+    }
+
+    // Dimension of the sheet, including the new rows
+    const std::string dimKey = "<dimension ref=\"";
+    size_t dimPos = xml.find(dimKey);
+    if (nRows > 0 && dimPos != std::string::npos && dimPos < insertPos) {
+        size_t first = dimPos + dimKey.size();
+        size_t last = xml.find('"', first);
+        std::string ref = "A1:" + columnName(sheet.columns.size() - 1)
+                        + std::to_string(sheet.firstRow + nRows - 1);
+        xml.replace(first, last - first, ref);
+        insertPos = insertPos - (last - first) + ref.size();
+    }
+
+    Entry res = e;
+    res.method = METHOD_DEFLATED;
+    res.flags = 0;
+    res.versionNeeded = std::max<uint16_t>(e.versionNeeded, 20);
+    res.offset = checked32(static_cast<uint64_t>(out.tellp()));
+
+    // Header with the sizes and CRC patched at the end
+    const std::string h = localHeader(res.versionNeeded, res.flags, res.method,
+                                    res.time, res.date, 0, 0, 0, res.name);
+    out.write(h.data(), static_cast<std::streamsize>(h.size()));
+
+    uint32_t crc = 0;
+    uint64_t size = 0;
+    uint64_t compressedSize = 0;
+    std::vector<uint8_t> segment;
+    auto writeSegment = [&](const char* data, size_t n, bool final) {
+        segment.clear();
+        HCDeflate::compress(data, n, final, segment);
+        crc = HCDeflate::crc32(crc, data, n);
+        size += n;
+        compressedSize += segment.size();
+        out.write(reinterpret_cast<const char*>(segment.data()),
+                static_cast<std::streamsize>(segment.size()));
+    };
+
+    writeSegment(xml.data(), insertPos, false);
+
+    // Rows, by batches of blocks formatted and compressed in parallel
+    const size_t nBlocks = (nRows + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    const size_t batchSize = 4 * static_cast<size_t>(scheduler ? scheduler->getThreadCount() : 1);
+    std::vector<std::string> blockXml(std::min(batchSize, nBlocks));
+    std::vector<std::vector<uint8_t>> blockData(blockXml.size());
+    for (size_t b0 = 0; b0 < nBlocks; b0 += batchSize) {
+        const size_t count = std::min(batchSize, nBlocks - b0);
+        auto work = [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const size_t first = (b0 + k) * ROWS_PER_BLOCK;
+                blockXml[k].clear();
+                blockData[k].clear();
+                formatRows(sheet, first, std::min(first + ROWS_PER_BLOCK, nRows), blockXml[k]);
+                HCDeflate::compress(blockXml[k].data(), blockXml[k].size(), false, blockData[k]);
+            }
+        };
+        if (scheduler)
+            scheduler->parallelFor(0, count, 1, work);
+        else
+            work(0, count);
+
+        for (size_t k = 0; k < count; ++k) {
+            crc = HCDeflate::crc32(crc, blockXml[k].data(), blockXml[k].size());
+            size += blockXml[k].size();
+            compressedSize += blockData[k].size();
+            out.write(reinterpret_cast<const char*>(blockData[k].data()),
+                    static_cast<std::streamsize>(blockData[k].size()));
+        }
+        // Stop as soon as the entry needs zip64, not once all is written
+        checked32(size);
+        checked32(static_cast<uint64_t>(out.tellp()));
+    }
+
+    writeSegment(xml.data() + insertPos, xml.size() - insertPos, true);
+
+    res.crc = crc;
+    res.size = checked32(size);
+    res.compressedSize = checked32(compressedSize);
+
+    const std::streampos endPos = out.tellp();
+    std::string sizes;
+    put32(sizes, res.crc);
+    put32(sizes, res.compressedSize);
+    put32(sizes, res.size);
+    out.seekp(static_cast<std::streamoff>(res.offset) + 14);
+    out.write(sizes.data(), static_cast<std::streamsize>(sizes.size()));
+    out.seekp(endPos);
+
+    return res;
+}
+
+void HCSheetWriter::formatRows(const Sheet& sheet, size_t begin, size_t end, std::string& xml)
+{
+    const size_t nCols = sheet.columns.size();
+    std::vector<std::string> names(nCols);
+    for (size_t c = 0; c < nCols; ++c)
+        names[c] = columnName(c);
+
+    char row[16];
+    char value[32];
+    xml.reserve(xml.size() + (end - begin) * (16 + nCols * 40));
+    for (size_t i = begin; i < end; ++i) {
+        const size_t rowLen = static_cast<size_t>(
+                std::to_chars(row, row + sizeof(row), sheet.firstRow + i).ptr - row);
+        xml += "<row r=\"";
+        xml.append(row, rowLen);
+        xml += "\">";
+        for (size_t c = 0; c < nCols; ++c) {
+            const double v = sheet.columns[c][i];
+            if (v == HCCurves::NOT_AVAILABLE || !std::isfinite(v))
+                continue;
+            // Shortest representation giving back the same double
+            const size_t valueLen = static_cast<size_t>(
+                    std::to_chars(value, value + sizeof(value), v).ptr - value);
+            xml += "<c r=\"";
+            xml += names[c];
+            xml.append(row, rowLen);
+            xml += "\"><v>";
+            xml.append(value, valueLen);
+            xml += "</v></c>";
+        }
+        xml += "</row>";
+    }
+}
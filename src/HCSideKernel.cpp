@@ -0,0 +1,791 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+// ===== Standards Includes ===== //
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+// ===== External Includes ===== //
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HC_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ===== HydroCpp Includes ===== //
+#include "HCSideKernel.hpp"
+
+// This file shall be compiled with -ffp-contract=off (see CMakeLists.txt):
+// a fused multiply-add in one variant only would break the bit for bit
+// equality between the scalar and the vectorised kernels.
+
+using namespace HydroCpp;
+
+static_assert(sizeof(HCPoint) == 2 * sizeof(double), "HCPoint shall be 2 packed doubles");
+static_assert(sizeof(HCPointF) == 2 * sizeof(float), "HCPointF shall be 2 packed floats");
+
+namespace
+{
+    constexpr double ON_LINE_TOLERANCE = 1e-8;
+
+    /**
+     * @brief line parameters shared by the kernels, in the scalar
+     * type of the vertices
+     */
+    template<typename T>
+    struct LineT
+    {
+        T cx, cy;           // start point C
+        T dcx, dcy;         // vector CD
+        T tol;              // on the line below, for the distance of the kernel
+
+        /**
+         * @param horizontal true for the kernels of horizontal lines, which
+         * compare y to cy: the tolerance is scaled by the length of CD so
+         * that the vertices are classified as by the general kernels
+         */
+        explicit LineT(const std::pair<HCPointT<T>,HCPointT<T>>& line, bool horizontal = false)
+            : cx(line.first.x), cy(line.first.y),
+              dcx(line.second.x - line.first.x), dcy(line.second.y - line.first.y),
+              tol(static_cast<T>(horizontal ? ON_LINE_TOLERANCE / std::abs(static_cast<double>(dcx))
+                                            : ON_LINE_TOLERANCE))
+        {}
+    };
+    using Line = LineT<double>;
+    using LineF = LineT<float>;
+
+    inline uint32_t summaryOf(uint32_t onMask, uint32_t rightMask, uint32_t laneMask)
+    {
+        uint32_t res = 0;
+        if (onMask)
+            res |= HCSideKernel::HAS_ON;
+        if (rightMask & ~onMask)
+            res |= HCSideKernel::HAS_RIGHT;
+        if (laneMask & ~rightMask & ~onMask)
+            res |= HCSideKernel::HAS_LEFT;
+        return res;
+    }
+
+    /**
+     * @brief sides of 4 lanes packed in 4 bytes (little endian), indexed by
+     * the on the line mask (bits 0-3) and the right mask (bits 4-7)
+     */
+    struct SideTable
+    {
+        uint32_t    bytes[256];
+
+        constexpr SideTable() : bytes()
+        {
+            for (uint32_t idx = 0; idx < 256; ++idx) {
+                uint32_t w = 0;
+                for (uint32_t j = 0; j < 4; ++j) {
+                    uint32_t side = ((idx >> j) & 1) ? 0x00 : (((idx >> (j + 4)) & 1) ? 0x01 : 0xFF);
+                    w |= side << (8 * j);
+                }
+                bytes[idx] = w;
+            }
+        }
+    };
+    constexpr SideTable SIDE_TABLE;
+
+    inline void writeSides(uint32_t onMask, uint32_t rightMask, size_t lanes, int8_t* sides)
+    {
+        for (size_t j = 0; j < lanes; j += 4) {
+            uint32_t w = SIDE_TABLE.bytes[((onMask >> j) & 0xF) | (((rightMask >> j) & 0xF) << 4)];
+            std::memcpy(sides + j, &w, lanes - j < 4 ? lanes - j : 4);
+        }
+    }
+
+    //////////////////////////////////////////////
+    //
+    // Scalar
+    //
+    //////////////////////////////////////////////
+
+    // inlined in each variant for the remaining vertices, so that
+    // it is compiled with the same instruction set
+    template<bool Horizontal, typename T>
+    __attribute__((always_inline))
+    inline uint32_t classifyTail(const HCPointT<T>* v, size_t n, const LineT<T>& L, int8_t* sides)
+    {
+        uint32_t res = 0;
+        for (size_t i = 0; i < n; ++i) {
+            // Same as distPtToSegment, or its sign only for a horizontal line
+            T dist;
+            if constexpr (Horizontal)
+                dist = v[i].y - L.cy;
+            else
+                dist = L.dcx * (v[i].y - L.cy) - L.dcy * (v[i].x - L.cx);
+            if (std::abs(dist) < L.tol) {
+                sides[i] = 0;
+                res |= HCSideKernel::HAS_ON;
+            } else if (dist < 0) {
+                sides[i] = 1;
+                res |= HCSideKernel::HAS_RIGHT;
+            } else {
+                sides[i] = -1;
+                res |= HCSideKernel::HAS_LEFT;
+            }
+        }
+        return res;
+    }
+
+    template<bool Horizontal, typename T>
+    uint32_t classifyScalar(const HCPointT<T>* v, size_t n, const LineT<T>& L, int8_t* sides)
+    {
+        return classifyTail<Horizontal>(v, n, L, sides);
+    }
+
+    template<typename T>
+    __attribute__((always_inline))
+    inline size_t intersectTail(const HCPointT<T>* v, size_t n, const uint32_t* edges, size_t count,
+                            const LineT<T>& L, HCPointT<T>* points, uint8_t* inRange)
+    {
+        size_t parallel = 0;
+        for (size_t e = 0; e < count; ++e) {
+            const HCPointT<T>& A = v[edges[e]];
+            const HCPointT<T>& B = v[edges[e] + 1 < n ? edges[e] + 1 : 0];
+            // Same as HCPolygonSplitter::intersection
+            T abx = B.x - A.x;
+            T aby = B.y - A.y;
+            T div = abx * L.dcy - aby * L.dcx;
+            if (div == 0) {
+                points[e] = HCPointT<T>(0, 0);
+                if (inRange)
+                    inRange[e] = 0;
+                ++parallel;
+                continue;
+            }
+            T m = (abx * A.y - abx * L.cy - aby * A.x + aby * L.cx) / div;
+            T k = (L.dcx * A.y - L.dcx * L.cy - L.dcy * A.x + L.dcy * L.cx) / div;
+            points[e] = HCPointT<T>(abx * k + A.x, aby * k + A.y);
+            if (inRange)
+                inRange[e] = (0 <= m) && (m < 1) && (0 <= k) && (k < 1);
+        }
+        return parallel;
+    }
+
+    template<typename T>
+    size_t intersectScalar(const HCPointT<T>* v, size_t n, const uint32_t* edges, size_t count,
+                            const LineT<T>& L, HCPointT<T>* points, uint8_t* inRange)
+    {
+        return intersectTail(v, n, edges, count, L, points, inRange);
+    }
+
+    /**
+     * @brief intersections with a horizontal line, one interpolation of x,
+     * the crossing point being on the line exactly
+     */
+    template<typename T>
+    size_t intersectHorizontalScalar(const HCPointT<T>* v, size_t n, const uint32_t* edges,
+                            size_t count, const LineT<T>& L, HCPointT<T>* points, uint8_t* inRange)
+    {
+        size_t parallel = 0;
+        for (size_t e = 0; e < count; ++e) {
+            const HCPointT<T>& A = v[edges[e]];
+            const HCPointT<T>& B = v[edges[e] + 1 < n ? edges[e] + 1 : 0];
+            T aby = B.y - A.y;
+            if (aby == 0) {
+                points[e] = HCPointT<T>(0, 0);
+                if (inRange)
+                    inRange[e] = 0;
+                ++parallel;
+                continue;
+            }
+            T k = (L.cy - A.y) / aby;
+            T x = A.x + k * (B.x - A.x);
+            points[e] = HCPointT<T>(x, L.cy);
+            if (inRange) {
+                T m = (x - L.cx) / L.dcx;
+                inRange[e] = (0 <= m) && (m < 1) && (0 <= k) && (k < 1);
+            }
+        }
+        return parallel;
+    }
+
+#ifdef HC_SIMD_X86
+
+    //////////////////////////////////////////////
+    //
+    // SSE2, 2 vertices per iteration
+    //
+    //////////////////////////////////////////////
+
+    template<bool Horizontal>
+    __attribute__((target("sse2")))
+    uint32_t classifySSE2(const HCPoint* v, size_t n, const Line& L, int8_t* sides)
+    {
+        const __m128d cx = _mm_set1_pd(L.cx), cy = _mm_set1_pd(L.cy);
+        const __m128d dcx = _mm_set1_pd(L.dcx), dcy = _mm_set1_pd(L.dcy);
+        const __m128d tol = _mm_set1_pd(L.tol);
+        const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        const __m128d zero = _mm_setzero_pd();
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128d a = _mm_loadu_pd(&v[i].x);
+            __m128d b = _mm_loadu_pd(&v[i + 1].x);
+            __m128d x = _mm_unpacklo_pd(a, b);
+            __m128d y = _mm_unpackhi_pd(a, b);
+            __m128d dist;
+            if constexpr (Horizontal)
+                dist = _mm_sub_pd(y, cy);
+            else
+                dist = _mm_sub_pd(_mm_mul_pd(dcx, _mm_sub_pd(y, cy)),
+                                  _mm_mul_pd(dcy, _mm_sub_pd(x, cx)));
+            uint32_t on = _mm_movemask_pd(_mm_cmplt_pd(_mm_and_pd(dist, absMask), tol));
+            uint32_t right = _mm_movemask_pd(_mm_cmplt_pd(dist, zero));
+            writeSides(on, right, 2, sides + i);
+            res |= summaryOf(on, right, 0x3);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+    __attribute__((target("sse2")))
+    size_t intersectSSE2(const HCPoint* v, size_t n, const uint32_t* edges, size_t count,
+                            const Line& L, HCPoint* points, uint8_t* inRange)
+    {
+        const __m128d cx = _mm_set1_pd(L.cx), cy = _mm_set1_pd(L.cy);
+        const __m128d dcx = _mm_set1_pd(L.dcx), dcy = _mm_set1_pd(L.dcy);
+        const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+
+        size_t parallel = 0;
+        size_t e = 0;
+        for (; e + 2 <= count; e += 2) {
+            const HCPoint& A0 = v[edges[e]];
+            const HCPoint& A1 = v[edges[e + 1]];
+            const HCPoint& B0 = v[edges[e] + 1 < n ? edges[e] + 1 : 0];
+            const HCPoint& B1 = v[edges[e + 1] + 1 < n ? edges[e + 1] + 1 : 0];
+            __m128d a0 = _mm_loadu_pd(&A0.x), a1 = _mm_loadu_pd(&A1.x);
+            __m128d b0 = _mm_loadu_pd(&B0.x), b1 = _mm_loadu_pd(&B1.x);
+            __m128d ax = _mm_unpacklo_pd(a0, a1), ay = _mm_unpackhi_pd(a0, a1);
+            __m128d bx = _mm_unpacklo_pd(b0, b1), by = _mm_unpackhi_pd(b0, b1);
+
+            __m128d abx = _mm_sub_pd(bx, ax);
+            __m128d aby = _mm_sub_pd(by, ay);
+            __m128d div = _mm_sub_pd(_mm_mul_pd(abx, dcy), _mm_mul_pd(aby, dcx));
+            __m128d m = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(_mm_mul_pd(abx, ay), _mm_mul_pd(abx, cy)),
+                                              _mm_mul_pd(aby, ax)), _mm_mul_pd(aby, cx));
+            __m128d k = _mm_add_pd(_mm_sub_pd(_mm_sub_pd(_mm_mul_pd(dcx, ay), _mm_mul_pd(dcx, cy)),
+                                              _mm_mul_pd(dcy, ax)), _mm_mul_pd(dcy, cx));
+            m = _mm_div_pd(m, div);
+            k = _mm_div_pd(k, div);
+            __m128d px = _mm_add_pd(_mm_mul_pd(abx, k), ax);
+            __m128d py = _mm_add_pd(_mm_mul_pd(aby, k), ay);
+
+            uint32_t isParallel = _mm_movemask_pd(_mm_cmpeq_pd(div, zero));
+            uint32_t ok = _mm_movemask_pd(_mm_and_pd(
+                            _mm_and_pd(_mm_cmple_pd(zero, m), _mm_cmplt_pd(m, one)),
+                            _mm_and_pd(_mm_cmple_pd(zero, k), _mm_cmplt_pd(k, one))));
+
+            _mm_storeu_pd(&points[e].x, _mm_unpacklo_pd(px, py));
+            _mm_storeu_pd(&points[e + 1].x, _mm_unpackhi_pd(px, py));
+            for (size_t j = 0; j < 2; ++j) {
+                if ((isParallel >> j) & 1) {
+                    points[e + j] = HCPoint(0.0, 0.0);
+                    ++parallel;
+                }
+                if (inRange)
+                    inRange[e + j] = ((ok & ~isParallel) >> j) & 1;
+            }
+        }
+        if (e < count)
+            parallel += intersectTail(v, n, edges + e, count - e, L, points + e,
+                                        inRange ? inRange + e : nullptr);
+        return parallel;
+    }
+
+    //////////////////////////////////////////////
+    //
+    // AVX2, 4 vertices per iteration
+    //
+    //////////////////////////////////////////////
+
+    template<bool Horizontal>
+    __attribute__((target("avx2")))
+    uint32_t classifyAVX2(const HCPoint* v, size_t n, const Line& L, int8_t* sides)
+    {
+        const __m256d cx = _mm256_set1_pd(L.cx), cy = _mm256_set1_pd(L.cy);
+        const __m256d dcx = _mm256_set1_pd(L.dcx), dcy = _mm256_set1_pd(L.dcy);
+        const __m256d tol = _mm256_set1_pd(L.tol);
+        const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        const __m256d zero = _mm256_setzero_pd();
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(&v[i].x);       // x0 y0 x1 y1
+            __m256d b = _mm256_loadu_pd(&v[i + 2].x);   // x2 y2 x3 y3
+            __m256d x = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xD8);
+            __m256d y = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+            __m256d dist;
+            if constexpr (Horizontal)
+                dist = _mm256_sub_pd(y, cy);
+            else
+                dist = _mm256_sub_pd(_mm256_mul_pd(dcx, _mm256_sub_pd(y, cy)),
+                                     _mm256_mul_pd(dcy, _mm256_sub_pd(x, cx)));
+            uint32_t on = _mm256_movemask_pd(
+                            _mm256_cmp_pd(_mm256_and_pd(dist, absMask), tol, _CMP_LT_OQ));
+            uint32_t right = _mm256_movemask_pd(_mm256_cmp_pd(dist, zero, _CMP_LT_OQ));
+            writeSides(on, right, 4, sides + i);
+            res |= summaryOf(on, right, 0xF);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+    __attribute__((target("avx2")))
+    size_t intersectAVX2(const HCPoint* v, size_t n, const uint32_t* edges, size_t count,
+                            const Line& L, HCPoint* points, uint8_t* inRange)
+    {
+        const __m256d cx = _mm256_set1_pd(L.cx), cy = _mm256_set1_pd(L.cy);
+        const __m256d dcx = _mm256_set1_pd(L.dcx), dcy = _mm256_set1_pd(L.dcy);
+        const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+
+        size_t parallel = 0;
+        size_t e = 0;
+        for (; e + 4 <= count; e += 4) {
+            alignas(32) double lane[4][4];  // ax, ay, bx, by
+            for (size_t j = 0; j < 4; ++j) {
+                const HCPoint& A = v[edges[e + j]];
+                const HCPoint& B = v[edges[e + j] + 1 < n ? edges[e + j] + 1 : 0];
+                lane[0][j] = A.x;
+                lane[1][j] = A.y;
+                lane[2][j] = B.x;
+                lane[3][j] = B.y;
+            }
+            __m256d ax = _mm256_load_pd(lane[0]), ay = _mm256_load_pd(lane[1]);
+            __m256d bx = _mm256_load_pd(lane[2]), by = _mm256_load_pd(lane[3]);
+
+            __m256d abx = _mm256_sub_pd(bx, ax);
+            __m256d aby = _mm256_sub_pd(by, ay);
+            __m256d div = _mm256_sub_pd(_mm256_mul_pd(abx, dcy), _mm256_mul_pd(aby, dcx));
+            __m256d m = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(abx, ay),
+                            _mm256_mul_pd(abx, cy)), _mm256_mul_pd(aby, ax)), _mm256_mul_pd(aby, cx));
+            __m256d k = _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(dcx, ay),
+                            _mm256_mul_pd(dcx, cy)), _mm256_mul_pd(dcy, ax)), _mm256_mul_pd(dcy, cx));
+            m = _mm256_div_pd(m, div);
+            k = _mm256_div_pd(k, div);
+            __m256d px = _mm256_add_pd(_mm256_mul_pd(abx, k), ax);
+            __m256d py = _mm256_add_pd(_mm256_mul_pd(aby, k), ay);
+
+            uint32_t isParallel = _mm256_movemask_pd(_mm256_cmp_pd(div, zero, _CMP_EQ_OQ));
+            uint32_t ok = _mm256_movemask_pd(_mm256_and_pd(
+                    _mm256_and_pd(_mm256_cmp_pd(zero, m, _CMP_LE_OQ), _mm256_cmp_pd(m, one, _CMP_LT_OQ)),
+                    _mm256_and_pd(_mm256_cmp_pd(zero, k, _CMP_LE_OQ), _mm256_cmp_pd(k, one, _CMP_LT_OQ))));
+
+            // interleave back to points: x0 y0 x1 y1 | x2 y2 x3 y3
+            __m256d lo = _mm256_unpacklo_pd(px, py);    // x0 y0 x2 y2
+            __m256d hi = _mm256_unpackhi_pd(px, py);    // x1 y1 x3 y3
+            _mm256_storeu_pd(&points[e].x, _mm256_permute2f128_pd(lo, hi, 0x20));
+            _mm256_storeu_pd(&points[e + 2].x, _mm256_permute2f128_pd(lo, hi, 0x31));
+            for (size_t j = 0; j < 4; ++j) {
+                if ((isParallel >> j) & 1) {
+                    points[e + j] = HCPoint(0.0, 0.0);
+                    ++parallel;
+                }
+                if (inRange)
+                    inRange[e + j] = ((ok & ~isParallel) >> j) & 1;
+            }
+        }
+        if (e < count)
+            parallel += intersectTail(v, n, edges + e, count - e, L, points + e,
+                                        inRange ? inRange + e : nullptr);
+        return parallel;
+    }
+
+    //////////////////////////////////////////////
+    //
+    // AVX-512, 8 vertices per iteration
+    //
+    //////////////////////////////////////////////
+
+    template<bool Horizontal>
+    __attribute__((target("avx512f")))
+    uint32_t classifyAVX512(const HCPoint* v, size_t n, const Line& L, int8_t* sides)
+    {
+        const __m512d cx = _mm512_set1_pd(L.cx), cy = _mm512_set1_pd(L.cy);
+        const __m512d dcx = _mm512_set1_pd(L.dcx), dcy = _mm512_set1_pd(L.dcy);
+        const __m512d tol = _mm512_set1_pd(L.tol);
+        const __m512d zero = _mm512_setzero_pd();
+        const __m512i evenIdx = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i oddIdx = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512d a = _mm512_loadu_pd(&v[i].x);
+            __m512d b = _mm512_loadu_pd(&v[i + 4].x);
+            __m512d x = _mm512_permutex2var_pd(a, evenIdx, b);
+            __m512d y = _mm512_permutex2var_pd(a, oddIdx, b);
+            __m512d dist;
+            if constexpr (Horizontal)
+                dist = _mm512_sub_pd(y, cy);
+            else
+                dist = _mm512_sub_pd(_mm512_mul_pd(dcx, _mm512_sub_pd(y, cy)),
+                                     _mm512_mul_pd(dcy, _mm512_sub_pd(x, cx)));
+            uint32_t on = _mm512_cmp_pd_mask(_mm512_abs_pd(dist), tol, _CMP_LT_OQ);
+            uint32_t right = _mm512_cmp_pd_mask(dist, zero, _CMP_LT_OQ);
+            writeSides(on, right, 8, sides + i);
+            res |= summaryOf(on, right, 0xFF);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+    __attribute__((target("avx512f")))
+    size_t intersectAVX512(const HCPoint* v, size_t n, const uint32_t* edges, size_t count,
+                            const Line& L, HCPoint* points, uint8_t* inRange)
+    {
+        const __m512d cx = _mm512_set1_pd(L.cx), cy = _mm512_set1_pd(L.cy);
+        const __m512d dcx = _mm512_set1_pd(L.dcx), dcy = _mm512_set1_pd(L.dcy);
+        const __m512d zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1.0);
+
+        size_t parallel = 0;
+        size_t e = 0;
+        for (; e + 8 <= count; e += 8) {
+            alignas(64) double lane[4][8];  // ax, ay, bx, by
+            for (size_t j = 0; j < 8; ++j) {
+                const HCPoint& A = v[edges[e + j]];
+                const HCPoint& B = v[edges[e + j] + 1 < n ? edges[e + j] + 1 : 0];
+                lane[0][j] = A.x;
+                lane[1][j] = A.y;
+                lane[2][j] = B.x;
+                lane[3][j] = B.y;
+            }
+            __m512d ax = _mm512_load_pd(lane[0]), ay = _mm512_load_pd(lane[1]);
+            __m512d bx = _mm512_load_pd(lane[2]), by = _mm512_load_pd(lane[3]);
+
+            __m512d abx = _mm512_sub_pd(bx, ax);
+            __m512d aby = _mm512_sub_pd(by, ay);
+            __m512d div = _mm512_sub_pd(_mm512_mul_pd(abx, dcy), _mm512_mul_pd(aby, dcx));
+            __m512d m = _mm512_add_pd(_mm512_sub_pd(_mm512_sub_pd(_mm512_mul_pd(abx, ay),
+                            _mm512_mul_pd(abx, cy)), _mm512_mul_pd(aby, ax)), _mm512_mul_pd(aby, cx));
+            __m512d k = _mm512_add_pd(_mm512_sub_pd(_mm512_sub_pd(_mm512_mul_pd(dcx, ay),
+                            _mm512_mul_pd(dcx, cy)), _mm512_mul_pd(dcy, ax)), _mm512_mul_pd(dcy, cx));
+            m = _mm512_div_pd(m, div);
+            k = _mm512_div_pd(k, div);
+            __m512d px = _mm512_add_pd(_mm512_mul_pd(abx, k), ax);
+            __m512d py = _mm512_add_pd(_mm512_mul_pd(aby, k), ay);
+
+            uint32_t isParallel = _mm512_cmp_pd_mask(div, zero, _CMP_EQ_OQ);
+            uint32_t ok = _mm512_cmp_pd_mask(zero, m, _CMP_LE_OQ)
+                        & _mm512_cmp_pd_mask(m, one, _CMP_LT_OQ)
+                        & _mm512_cmp_pd_mask(zero, k, _CMP_LE_OQ)
+                        & _mm512_cmp_pd_mask(k, one, _CMP_LT_OQ);
+
+            alignas(64) double outX[8], outY[8];
+            _mm512_store_pd(outX, px);
+            _mm512_store_pd(outY, py);
+            for (size_t j = 0; j < 8; ++j) {
+                if ((isParallel >> j) & 1) {
+                    points[e + j] = HCPoint(0.0, 0.0);
+                    ++parallel;
+                } else {
+                    points[e + j] = HCPoint(outX[j], outY[j]);
+                }
+                if (inRange)
+                    inRange[e + j] = ((ok & ~isParallel) >> j) & 1;
+            }
+        }
+        if (e < count)
+            parallel += intersectTail(v, n, edges + e, count - e, L, points + e,
+                                        inRange ? inRange + e : nullptr);
+        return parallel;
+    }
+
+    //////////////////////////////////////////////
+    //
+    // Single precision, twice the lanes of the double variants. The
+    // intersections are left to the scalar code: a section usually
+    // crosses the waterline twice
+    //
+    //////////////////////////////////////////////
+
+    template<bool Horizontal>
+    __attribute__((target("sse2")))
+    uint32_t classifySSE2(const HCPointF* v, size_t n, const LineF& L, int8_t* sides)
+    {
+        const __m128 cx = _mm_set1_ps(L.cx), cy = _mm_set1_ps(L.cy);
+        const __m128 dcx = _mm_set1_ps(L.dcx), dcy = _mm_set1_ps(L.dcy);
+        const __m128 tol = _mm_set1_ps(L.tol);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 zero = _mm_setzero_ps();
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 a = _mm_loadu_ps(&v[i].x);       // x0 y0 x1 y1
+            __m128 b = _mm_loadu_ps(&v[i + 2].x);   // x2 y2 x3 y3
+            __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 dist;
+            if constexpr (Horizontal)
+                dist = _mm_sub_ps(y, cy);
+            else
+                dist = _mm_sub_ps(_mm_mul_ps(dcx, _mm_sub_ps(y, cy)),
+                                  _mm_mul_ps(dcy, _mm_sub_ps(x, cx)));
+            uint32_t on = _mm_movemask_ps(_mm_cmplt_ps(_mm_and_ps(dist, absMask), tol));
+            uint32_t right = _mm_movemask_ps(_mm_cmplt_ps(dist, zero));
+            writeSides(on, right, 4, sides + i);
+            res |= summaryOf(on, right, 0xF);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+    template<bool Horizontal>
+    __attribute__((target("avx2")))
+    uint32_t classifyAVX2(const HCPointF* v, size_t n, const LineF& L, int8_t* sides)
+    {
+        const __m256 cx = _mm256_set1_ps(L.cx), cy = _mm256_set1_ps(L.cy);
+        const __m256 dcx = _mm256_set1_ps(L.dcx), dcy = _mm256_set1_ps(L.dcy);
+        const __m256 tol = _mm256_set1_ps(L.tol);
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 zero = _mm256_setzero_ps();
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 a = _mm256_loadu_ps(&v[i].x);        // x0 y0 .. x3 y3
+            __m256 b = _mm256_loadu_ps(&v[i + 4].x);    // x4 y4 .. x7 y7
+            // x0 x1 x4 x5 | x2 x3 x6 x7, then the pairs in order
+            __m256 x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+                            _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), 0xD8));
+            __m256 y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+                            _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), 0xD8));
+            __m256 dist;
+            if constexpr (Horizontal)
+                dist = _mm256_sub_ps(y, cy);
+            else
+                dist = _mm256_sub_ps(_mm256_mul_ps(dcx, _mm256_sub_ps(y, cy)),
+                                     _mm256_mul_ps(dcy, _mm256_sub_ps(x, cx)));
+            uint32_t on = _mm256_movemask_ps(
+                            _mm256_cmp_ps(_mm256_and_ps(dist, absMask), tol, _CMP_LT_OQ));
+            uint32_t right = _mm256_movemask_ps(_mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+            writeSides(on, right, 8, sides + i);
+            res |= summaryOf(on, right, 0xFF);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+    template<bool Horizontal>
+    __attribute__((target("avx512f")))
+    uint32_t classifyAVX512(const HCPointF* v, size_t n, const LineF& L, int8_t* sides)
+    {
+        const __m512 cx = _mm512_set1_ps(L.cx), cy = _mm512_set1_ps(L.cy);
+        const __m512 dcx = _mm512_set1_ps(L.dcx), dcy = _mm512_set1_ps(L.dcy);
+        const __m512 tol = _mm512_set1_ps(L.tol);
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512i evenIdx = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16,
+                                                 14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i oddIdx = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17,
+                                                15, 13, 11, 9, 7, 5, 3, 1);
+
+        uint32_t res = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m512 a = _mm512_loadu_ps(&v[i].x);
+            __m512 b = _mm512_loadu_ps(&v[i + 8].x);
+            __m512 x = _mm512_permutex2var_ps(a, evenIdx, b);
+            __m512 y = _mm512_permutex2var_ps(a, oddIdx, b);
+            __m512 dist;
+            if constexpr (Horizontal)
+                dist = _mm512_sub_ps(y, cy);
+            else
+                dist = _mm512_sub_ps(_mm512_mul_ps(dcx, _mm512_sub_ps(y, cy)),
+                                     _mm512_mul_ps(dcy, _mm512_sub_ps(x, cx)));
+            uint32_t on = _mm512_cmp_ps_mask(_mm512_abs_ps(dist), tol, _CMP_LT_OQ);
+            uint32_t right = _mm512_cmp_ps_mask(dist, zero, _CMP_LT_OQ);
+            writeSides(on, right, 16, sides + i);
+            res |= summaryOf(on, right, 0xFFFF);
+        }
+        if (i < n)
+            res |= classifyTail<Horizontal>(v + i, n - i, L, sides + i);
+        return res;
+    }
+
+#endif // HC_SIMD_X86
+
+    HCIsa detectIsa()
+    {
+#ifdef HC_SIMD_X86
+        // Required in a static binary, the cpu model may not be
+        // initialised yet when called from a static constructor
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return HCIsa::AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return HCIsa::AVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return HCIsa::SSE2;
+#endif
+        return HCIsa::Scalar;
+    }
+
+    HCIsa supportedIsa()
+    {
+        static const HCIsa isa = detectIsa();
+        return isa;
+    }
+
+    std::atomic<int>    s_isa   {-1};   // -1: not selected yet
+
+    inline HCIsa activeIsa()
+    {
+        int isa = s_isa.load(std::memory_order_relaxed);
+        if (isa < 0) {
+            // 2 lanes don't pay for the packing of the sides, the SSE2
+            // variant is only used when requested
+            HCIsa best = supportedIsa();
+            isa = static_cast<int>(best == HCIsa::SSE2 ? HCIsa::Scalar : best);
+            s_isa.store(isa, std::memory_order_relaxed);
+        }
+        return static_cast<HCIsa>(isa);
+    }
+
+    /**
+     * @brief classify with the variant of the instruction set in use
+     */
+    template<bool Horizontal, typename T>
+    uint32_t classifyIsa(const HCPointT<T>* v, size_t n, const LineT<T>& L, int8_t* sides)
+    {
+        switch (activeIsa()) {
+#ifdef HC_SIMD_X86
+        case HCIsa::AVX512:
+            return classifyAVX512<Horizontal>(v, n, L, sides);
+        case HCIsa::AVX2:
+            return classifyAVX2<Horizontal>(v, n, L, sides);
+        case HCIsa::SSE2:
+            return classifySSE2<Horizontal>(v, n, L, sides);
+#endif
+        default:
+            return classifyScalar<Horizontal>(v, n, L, sides);
+        }
+    }
+}
+
+uint32_t HCSideKernel::classify(const HCPoint* vertices, size_t n,
+                            const std::pair<HCPoint,HCPoint>& line, int8_t* sides)
+{
+    return classifyIsa<false>(vertices, n, Line(line), sides);
+}
+
+size_t HCSideKernel::intersect(const HCPoint* vertices, size_t n,
+                            const uint32_t* edges, size_t count,
+                            const std::pair<HCPoint,HCPoint>& line,
+                            HCPoint* points, uint8_t* inRange)
+{
+    const Line L(line);
+    switch (activeIsa()) {
+#ifdef HC_SIMD_X86
+    case HCIsa::AVX512:
+        return intersectAVX512(vertices, n, edges, count, L, points, inRange);
+    case HCIsa::AVX2:
+        return intersectAVX2(vertices, n, edges, count, L, points, inRange);
+    case HCIsa::SSE2:
+        return intersectSSE2(vertices, n, edges, count, L, points, inRange);
+#endif
+    default:
+        return intersectScalar(vertices, n, edges, count, L, points, inRange);
+    }
+}
+
+uint32_t HCSideKernel::classify(const HCPointF* vertices, size_t n,
+                            const std::pair<HCPointF,HCPointF>& line, int8_t* sides)
+{
+    return classifyIsa<false>(vertices, n, LineF(line), sides);
+}
+
+size_t HCSideKernel::intersect(const HCPointF* vertices, size_t n,
+                            const uint32_t* edges, size_t count,
+                            const std::pair<HCPointF,HCPointF>& line,
+                            HCPointF* points, uint8_t* inRange)
+{
+    return intersectScalar(vertices, n, edges, count, LineF(line), points, inRange);
+}
+
+uint32_t HCSideKernel::classifyHorizontal(const HCPoint* vertices, size_t n,
+                            const std::pair<HCPoint,HCPoint>& line, int8_t* sides)
+{
+    return classifyIsa<true>(vertices, n, Line(line, true), sides);
+}
+
+uint32_t HCSideKernel::classifyHorizontal(const HCPointF* vertices, size_t n,
+                            const std::pair<HCPointF,HCPointF>& line, int8_t* sides)
+{
+    return classifyIsa<true>(vertices, n, LineF(line, true), sides);
+}
+
+size_t HCSideKernel::intersectHorizontal(const HCPoint* vertices, size_t n,
+                            const uint32_t* edges, size_t count,
+                            const std::pair<HCPoint,HCPoint>& line,
+                            HCPoint* points, uint8_t* inRange)
+{
+    return intersectHorizontalScalar(vertices, n, edges, count, Line(line, true),
+                                    points, inRange);
+}
+
+size_t HCSideKernel::intersectHorizontal(const HCPointF* vertices, size_t n,
+                            const uint32_t* edges, size_t count,
+                            const std::pair<HCPointF,HCPointF>& line,
+                            HCPointF* points, uint8_t* inRange)
+{
+    return intersectHorizontalScalar(vertices, n, edges, count, LineF(line, true),
+                                    points, inRange);
+}
+
+HCIsa HCSideKernel::getIsa()
+{
+    return activeIsa();
+}
+
+HCIsa HCSideKernel::getSupportedIsa()
+{
+    return supportedIsa();
+}
+
+HCIsa HCSideKernel::setIsa(HCIsa isa)
+{
+    if (static_cast<int>(isa) > static_cast<int>(supportedIsa()))
+        isa = supportedIsa();
+    s_isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return isa;
+}
+
+const char* HCSideKernel::getIsaName(HCIsa isa)
+{
+    switch (isa) {
+    case HCIsa::SSE2:
+        return "sse2";
+    case HCIsa::AVX2:
+        return "avx2";
+    case HCIsa::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+bool HCSideKernel::parseIsa(const std::string& name, HCIsa& isa)
+{
+    for (HCIsa i : { HCIsa::Scalar, HCIsa::SSE2, HCIsa::AVX2, HCIsa::AVX512 }) {
+        if (name == getIsaName(i)) {
+            isa = i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstdint>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Heap allocation counter, to check the allocations per call
+     * of the computation kernels. The global operator new is only
+     * replaced when the project is configured with HYDROCPP_COUNT_ALLOCS,
+     * otherwise the counts stay at 0.
+     */
+    class HCAllocCounter
+    {
+    public:
+        /**
+         * @brief return true if the allocations are counted in this build
+         */
+        static bool isEnabled();
+
+        /**
+         * @brief number of allocations done by the calling thread
+         */
+        static uint64_t getThreadCount();
+
+        /**
+         * @brief number of allocations done by all the threads
+         */
+        static uint64_t getTotalCount();
+    };
+
+}  // namespace std
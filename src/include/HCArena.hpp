@@ -0,0 +1,114 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Monotonic memory resource for the temporaries of a
+     * computation: allocating is a pointer bump, deallocating does
+     * nothing, and the whole memory is reclaimed at once by rewinding.
+     * Unlike std::pmr::monotonic_buffer_resource, the chunks are kept
+     * when rewinding, so once warmed up the arena doesn't allocate.
+     * Each thread has its own arena (local()), to be rewound by a Scope
+     * around each unit of work, e.g. a waterline evaluation.
+     */
+    class HCArena : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+        /**
+         * @brief position in the arena, to rewind to
+         */
+        struct Mark
+        {
+            size_t  chunk   {0};
+            size_t  offset  {0};
+        };
+
+        /**
+         * @brief rewind the arena of the thread at the end of the scope,
+         * releasing everything allocated since its construction.
+         * Scopes may be nested
+         */
+        class Scope
+        {
+        public:
+            explicit Scope(HCArena& arena = HCArena::local());
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            HCArena&    m_arena;
+            Mark        m_mark;
+        };
+
+        /**
+         * @brief constructor, no memory is allocated until the first use
+         * @param chunkSize size of the chunks requested to the heap
+         */
+        explicit HCArena(size_t chunkSize = CHUNK_SIZE);
+
+        /**
+         * @brief destructor, the chunks are freed
+         */
+        ~HCArena() override;
+
+        HCArena(const HCArena&) = delete;
+        HCArena& operator=(const HCArena&) = delete;
+
+        /**
+         * @brief return the arena of the calling thread
+         */
+        static HCArena& local();
+
+        /**
+         * @brief return the current position
+         */
+        Mark mark() const;
+
+        /**
+         * @brief release everything allocated after a position
+         * @param mark a position returned by mark(), not rewound yet
+         */
+        void rewind(const Mark& mark);
+
+        /**
+         * @brief return the memory held by the arena, in bytes
+         */
+        size_t getCapacity() const;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<std::byte[]>    data;
+            size_t                          size;
+        };
+
+        std::vector<Chunk>  m_chunks;
+        size_t              m_chunkSize;
+        size_t              m_current   {0};    // chunk in use
+        size_t              m_offset    {0};    // first free byte of the chunk in use
+    };
+
+}  // namespace std
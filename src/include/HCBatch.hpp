@@ -0,0 +1,100 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+#pragma once
+// ===== External Includes ===== //
+#include <string>
+#include <vector>
+#include <istream>
+#include <functional>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    class HCLoader;
+
+    /**
+     * @brief timings and status of one file processed in batch
+     */
+    struct BatchResult
+    {
+        std::string file;
+        double      loadMs          {0.0};
+        double      computeMs       {0.0};
+        double      writeMs         {0.0};
+        bool        isValid         {false};
+        std::string error;
+    };
+
+    /**
+     * @brief Headless processing of a list of workbooks.
+     * Files go through a 3 stages pipeline: a loader thread reads the
+     * workbooks, a bounded pool of workers computes the tables, and a
+     * writer thread saves the results. So one file I/O overlaps other
+     * files computation.
+     */
+    class HCBatch
+    {
+    public:
+        /**
+         * @brief constructor
+         * @param files list of the workbooks to be processed
+         * @param workers number of compute workers (0: hardware concurrency)
+         * @param setup called on each loaded file before computation,
+         * to set the computation options
+         */
+        HCBatch(const std::vector<std::string>& files, unsigned workers,
+                const std::function<void(HCLoader&)>& setup = nullptr);
+
+        /**
+         * @brief destructor
+         */
+        ~HCBatch();
+
+        /**
+         * @brief process all the files and log per file and aggregate timings
+         * @return the number of files that failed
+         */
+        size_t run();
+
+        /**
+         * @brief return the results, in the order of the input files
+         */
+        const std::vector<BatchResult>& getResults() const;
+
+        /**
+         * @brief expand a command line pattern in a list of files.
+         * Wildcards '*' and '?' are only allowed in the file name part
+         * @param pattern file name or glob pattern
+         * @return the sorted list of matching files, the pattern itself
+         * if it contains no wildcard
+         */
+        static std::vector<std::string> expandPattern(const std::string& pattern);
+
+        /**
+         * @brief read a manifest, one file per line. Empty lines and
+         * lines starting with '#' are ignored
+         * @param in the stream to read from
+         */
+        static std::vector<std::string> readManifest(std::istream& in);
+
+    private:
+        /**
+         * @brief log the timing of each file and the aggregate
+         * @param wallMs the total elapsed time of the run
+         */
+        void report(double wallMs) const;
+
+    private:
+        std::vector<std::string>    m_files;
+        unsigned                    m_workers;
+        std::function<void(HCLoader&)> m_setup;
+        std::vector<BatchResult>    m_results;
+    };
+
+}  // namespace std
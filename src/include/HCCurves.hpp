@@ -0,0 +1,144 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <limits>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Piecewise linear curves sharing a sorted abscissa column
+     * (e.g. KN, waterline and volume as function of the displacement).
+     * Values are stored column by column. Lookups are done by binary
+     * search, or with a cursor for monotone queries, and a whole output
+     * column can be filled in one merge pass over sorted abscissas.
+     */
+    class HCCurves
+    {
+    public:
+        /**
+         * @brief value returned when the curve is not defined at the abscissa
+         */
+        static constexpr double NOT_AVAILABLE = std::numeric_limits<double>::min();
+
+        /**
+         * @brief position of the last lookup, for monotone queries
+         */
+        struct Cursor
+        {
+            size_t  index   {0};
+        };
+
+        /**
+         * @brief constructor
+         * @param nColumns number of value columns
+         * @param toOrigin if true, the curves go linearly to 0 at abscissa 0
+         * below the first point, otherwise they are not defined there
+         */
+        explicit HCCurves(size_t nColumns = 1, bool toOrigin = false);
+
+        /**
+         * @brief destructor
+         */
+        ~HCCurves();
+
+        /**
+         * @brief remove all the points
+         */
+        void clear();
+
+        /**
+         * @brief reserve the storage of n points
+         */
+        void reserve(size_t n);
+
+        /**
+         * @brief add a point, the abscissa shall not decrease
+         * @param x abscissa
+         * @param values one value per column
+         */
+        void append(double x, const double* values);
+
+        /**
+         * @brief number of points
+         */
+        size_t size() const;
+
+        /**
+         * @brief return true if there is no point
+         */
+        bool empty() const;
+
+        /**
+         * @brief number of value columns
+         */
+        size_t getColumnCount() const;
+
+        /**
+         * @brief abscissa of a point
+         */
+        double getAbscissa(size_t i) const;
+
+        /**
+         * @brief value of a point
+         * @param column
+         * @param i index of the point
+         */
+        double getValue(size_t column, size_t i) const;
+
+        /**
+         * @brief interpolate a column by binary search
+         * @param column
+         * @param x abscissa
+         * @return the value or NOT_AVAILABLE
+         */
+        double interpolate(size_t column, double x) const;
+
+        /**
+         * @brief interpolate a column from the cursor position, efficient
+         * when x increases (or slowly moves) from one call to the next
+         * @param column
+         * @param x abscissa
+         * @param cursor updated to the interval of x
+         * @return the value or NOT_AVAILABLE
+         */
+        double interpolate(size_t column, double x, Cursor& cursor) const;
+
+        /**
+         * @brief interpolate a column at sorted abscissas, in one pass
+         * @param column
+         * @param xs abscissas, increasing
+         * @param n number of abscissas
+         * @param out n values, NOT_AVAILABLE where the curve is not defined
+         */
+        void fillColumn(size_t column, const double* xs, size_t n, double* out) const;
+
+    private:
+        /**
+         * @brief index of the first point with abscissa >= x
+         * from the cursor position
+         */
+        size_t seek(double x, size_t from) const;
+
+        /**
+         * @brief interpolate in the interval ending at point j
+         * (j == size() or x not strictly inside: not available)
+         */
+        double valueAt(size_t column, double x, size_t j) const;
+
+    private:
+        std::vector<double>                 m_x;        // abscissas, not decreasing
+        std::vector<std::vector<double>>    m_columns;  // values, column by column
+        bool                                m_toOrigin;
+    };
+
+}  // namespace std
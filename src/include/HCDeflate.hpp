@@ -0,0 +1,68 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Raw deflate (RFC 1951) and CRC-32 of zlib, as the entries
+     * of an xlsx archive need them.
+     * Each compressed segment starts from an empty window and ends with
+     * a full flush, byte aligned, so consecutive blocks of a stream can
+     * be compressed in parallel and simply concatenated, only the last
+     * one being final. The zip backend of OpenXLSX is only reached
+     * through XLZipArchive, whole entries in and out as strings: it gives
+     * neither a deflate stream to feed by blocks nor the CRC of the bytes
+     * written.
+     */
+    class HCDeflate
+    {
+    public:
+        /**
+         * @brief compression level, the fastest: the sheets are mostly
+         * digits, the higher levels gain little for much more time
+         */
+        static constexpr int LEVEL = 1;
+
+        /**
+         * @brief update a CRC-32 (zip polynomial) with some bytes
+         * @param crc the CRC of the previous bytes, 0 to start
+         * @param data
+         * @param n number of bytes
+         * @return the updated CRC
+         */
+        static uint32_t crc32(uint32_t crc, const void* data, size_t n);
+
+        /**
+         * @brief compress a segment of a deflate stream
+         * @param data
+         * @param n number of bytes
+         * @param final true for the last segment of the stream
+         * @param out the compressed bytes are appended to it
+         * @throw std::runtime_error if zlib fails (out of memory)
+         */
+        static void compress(const void* data, size_t n, bool final,
+                            std::vector<uint8_t>& out);
+
+        /**
+         * @brief decompress a complete deflate stream
+         * @param data
+         * @param n number of compressed bytes
+         * @param out the decompressed bytes are appended to it
+         * @return false if the stream is corrupted or truncated
+         */
+        static bool decompress(const void* data, size_t n, std::vector<uint8_t>& out);
+    };
+
+}  // namespace std
@@ -0,0 +1,167 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCHull.hpp"
+#include "HCPoint.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief loading condition: weight and centre of gravity, in the
+     * axes of the hull (x from aft to fore, y transverse, z up)
+     */
+    struct HCLoadCondition
+    {
+        double  displacement    {0.0};  // t
+        double  LCG             {0.0};  // m
+        double  TCG             {0.0};  // m
+        double  VCG             {0.0};  // m
+    };
+
+    /**
+     * @brief floating position of a loading condition. The waterplane is
+     * z = draught + tan(trim) (x - xRef) + tan(heel) y: a positive trim
+     * is by the head, a positive heel immerses the positive y side
+     */
+    struct HCFloatingPosition
+    {
+        double  draught         {0.0};  // at xRef, on the centerline
+        double  draughtAft      {0.0};  // at the first station
+        double  draughtFore     {0.0};  // at the end of the last element
+        double  trim            {0.0};  // degrees
+        double  heel            {0.0};  // degrees
+        double  xRef            {0.0};  // middle of the hull length
+        double  volume          {0.0};
+        double  LCB             {0.0};
+        double  TCB             {0.0};
+        double  VCB             {0.0};
+        double  GMT             {0.0};  // transverse and longitudinal initial
+        double  GML             {0.0};  // metacentric heights at the position
+        unsigned iterations     {0};
+        bool    converged       {false};
+        bool    submerged       {false};// a section is under the waterplane
+    };
+
+    /**
+     * @brief Free floating equilibrium of a hull: for a loading
+     * condition, the draught, trim and heel at which the buoyancy equals
+     * the displacement and the centre of buoyancy is on the normal to the
+     * waterplane through the centre of gravity.
+     *
+     * Each section is clipped against the line the waterplane draws in
+     * it, and the wet area, its moments and the integrals of the
+     * waterline chords are accumulated in one pass. The chords give the
+     * derivatives of the volume and of its moments, so the Newton
+     * iteration on the 3 residuals has its exact Jacobian, and is damped
+     * when a step doesn't reduce them. The bounding box and the moments of
+     * each section are cached, so that the sections far from the
+     * waterplane cost a few comparisons.
+     */
+    class HCEquilibrium
+    {
+    public:
+        /**
+         * @brief constructor
+         * @param hull the hull, referenced, shall outlive the solver
+         * @param d_sw density of the water, t/m3
+         */
+        HCEquilibrium(const HCHull& hull, double d_sw);
+
+        /**
+         * @brief destructor
+         */
+        ~HCEquilibrium();
+
+        /**
+         * @brief solve a loading condition, from the upright position
+         * at the draught of a wall sided hull
+         */
+        HCFloatingPosition solve(const HCLoadCondition& condition) const;
+
+        /**
+         * @brief solve a loading condition from a close position, e.g.
+         * the one of the previous condition of a loop
+         */
+        HCFloatingPosition solve(const HCLoadCondition& condition,
+                                const HCFloatingPosition& start) const;
+
+        /**
+         * @brief solve loading conditions in order, each one starting from
+         * the position of the previous one if it converged
+         */
+        std::vector<HCFloatingPosition> solve(const std::vector<HCLoadCondition>& conditions) const;
+
+        /**
+         * @brief relative tolerance on the residuals: volume, and
+         * moments of the buoyancy about the centre of gravity divided by
+         * the volume and the length or the breadth of the hull
+         */
+        void setTolerance(double tolerance);
+
+    private:
+        /**
+         * @brief cached data of a section
+         */
+        struct Section
+        {
+            double  zMin, zMax, yMin, yMax;     // bounding box
+            double  area, Sy, Sz;               // area, integrals of y dA and z dA
+        };
+
+        /**
+         * @brief buoyancy at a waterplane, and its derivatives with the
+         * draught, tan(trim) and tan(heel)
+         */
+        struct Buoyancy
+        {
+            double  V   {0.0};
+            double  Mx  {0.0};
+            double  My  {0.0};
+            double  Mz  {0.0};
+            double  dV[3]   {0.0, 0.0, 0.0};
+            double  dMx[3]  {0.0, 0.0, 0.0};
+            double  dMy[3]  {0.0, 0.0, 0.0};
+            double  dMz[3]  {0.0, 0.0, 0.0};
+            bool    submerged   {false};
+        };
+
+        /**
+         * @brief compute the buoyancy of the waterplane
+         * z = T + a (x - xRef) + b y
+         */
+        Buoyancy evaluate(double T, double a, double b) const;
+
+        /**
+         * @brief residuals of the equilibrium and their Jacobian
+         * @param p draught, tan(trim), tan(heel)
+         * @param F residuals
+         * @param J Jacobian, row by row
+         * @return the scaled norm of the residuals
+         */
+        double residuals(const Buoyancy& B, const double p[3], const HCLoadCondition& condition,
+                        double F[3], double J[9]) const;
+
+    private:
+        const HCHull&           m_hull;
+        double                  m_d_sw;
+        double                  m_tolerance     {1e-10};
+        std::vector<Section>    m_sections;
+        double                  m_xRef          {0.0};
+        double                  m_length        {0.0};
+        double                  m_breadth       {0.0};
+        double                  m_zMin          {0.0};
+        double                  m_zMax          {0.0};
+        double                  m_boxArea       {0.0};  // waterplane of the bounding boxes
+    };
+
+}  // namespace std
@@ -0,0 +1,67 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <utility>
+// ===== HydroCpp Includes ===== //
+#include "HCPoint.hpp"
+#include "HCSectionCut.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief kernels of HCHalfPlaneClip for any waterline
+     */
+    struct HCGeneralLine {};
+
+    /**
+     * @brief kernels of HCHalfPlaneClip for a horizontal waterline, from
+     * the lower x to the higher x (upright hull): a vertex is classified
+     * by comparing its y, and a crossing is one interpolation
+     */
+    struct HCHorizontalLine {};
+
+    /**
+     * @brief Clip of a simple section by the waterline half plane.
+     * The vertices are classified in bulk with HCSideKernel, then the wet
+     * polygon is streamed vertex by vertex into the moment accumulators,
+     * without building any polygon nor allocating.
+     * Only the common case is handled: no vertex on the waterline and
+     * at most one wet loop (2 crossings). Other cases are reported so
+     * that the caller falls back on HCPolygonSplitter.
+     * The clip is compiled for HCPoint and HCPointF vertices: in single
+     * precision the vertices are classified and the crossings computed
+     * in float, the moments being accumulated in double anyway.
+     * The kernels are selected at compile time by the kind of line,
+     * HCGeneralLine or HCHorizontalLine.
+     */
+    class HCHalfPlaneClip
+    {
+    public:
+        /**
+         * @brief cut a section by the waterline, wet side on the right
+         * @tparam T scalar type of the vertices
+         * @tparam Line HCGeneralLine, or HCHorizontalLine if the waterline
+         * is horizontal and oriented towards the positive x
+         * @param vertices pointer to the first vertex, counterclockwise
+         * @param n number of vertices
+         * @param line the waterline
+         * @param wl the waterline height at x=0, reference of the chord inertia
+         * @param cut the properties of the wet part
+         * @return false if the case is not handled (vertex on the line,
+         * several wet loops), cut is then meaningless
+         */
+        template<typename T, typename Line = HCGeneralLine>
+        static bool cutSection(const HCPointT<T>* vertices, size_t n,
+                            const std::pair<HCPointT<T>,HCPointT<T>>& line,
+                            double wl, HCSectionCut& cut);
+    };
+
+}  // namespace std
@@ -0,0 +1,138 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCPoint.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Immutable hull, stored as structure of arrays. The vertices
+     * of all the sections are in one contiguous array, from aft to fore,
+     * each section being counterclockwise. The station x, the length of
+     * the element starting at the station and its mid x are computed once
+     * at construction, so the computation loops stream over the arrays.
+     * The vertex arrays are either owned by the hull or by an external
+     * storage, e.g. a mapped hull file, used in place without copying.
+     */
+    class HCHull
+    {
+    public:
+        /**
+         * @brief constructor of an empty hull
+         */
+        HCHull();
+
+        /**
+         * @brief constructor
+         * @param sections key: x of the station, value: vertices (y, z)
+         * of the full section, in any orientation
+         */
+        explicit HCHull(const std::map<double,std::vector<HCPoint>>& sections);
+
+        /**
+         * @brief constructor on arrays held by an external storage
+         * @param storage kept alive as long as the hull
+         * @param nSections number of sections
+         * @param stationX x of each section, increasing
+         * @param offsets first vertex of each section, nSections + 1 values
+         * @param points vertices of all the sections, each one counterclockwise
+         */
+        HCHull(std::shared_ptr<const void> storage, size_t nSections,
+                const double* stationX, const uint32_t* offsets, const HCPoint* points);
+
+        HCHull(const HCHull&) = delete;
+        HCHull& operator=(const HCHull&) = delete;
+        HCHull(HCHull&&) = default;
+        HCHull& operator=(HCHull&&) = default;
+
+        /**
+         * @brief destructor
+         */
+        ~HCHull();
+
+        /**
+         * @brief number of sections
+         */
+        size_t size() const { return m_size; }
+
+        /**
+         * @brief return true if the hull has no section
+         */
+        bool empty() const { return m_size == 0; }
+
+        /**
+         * @brief x of the station of the section
+         * @param i index of the section, from aft to fore
+         */
+        double getStationX(size_t i) const { return m_stationData[i]; }
+
+        /**
+         * @brief length of the element starting at the section,
+         * the last element has the same length as the previous one
+         * @param i index of the section
+         */
+        double getElmtLength(size_t i) const { return m_elmtLength[i]; }
+
+        /**
+         * @brief x of the middle of the element starting at the section
+         * @param i index of the section
+         */
+        double getMidX(size_t i) const { return m_midX[i]; }
+
+        /**
+         * @brief vertices of the section, counterclockwise
+         * @param i index of the section
+         */
+        const HCPoint* getVertices(size_t i) const { return m_pointData + m_offsetData[i]; }
+
+        /**
+         * @brief index of the first vertex of the section in the
+         * vertices of the whole hull
+         * @param i index of the section
+         */
+        size_t getVertexOffset(size_t i) const { return m_offsetData[i]; }
+
+        /**
+         * @brief number of vertices of the section
+         * @param i index of the section
+         */
+        size_t getVertexCount(size_t i) const { return m_offsetData[i + 1] - m_offsetData[i]; }
+
+        /**
+         * @brief number of vertices of the whole hull
+         */
+        size_t getTotalVertexCount() const { return m_offsetData[m_size]; }
+
+    private:
+        /**
+         * @brief compute the length and the mid x of the elements
+         */
+        void computeElements();
+
+    private:
+        std::vector<HCPoint>    m_points;       // owned vertices of all the sections
+        std::vector<uint32_t>   m_offsets;      // owned first vertex of each section, size() + 1
+        std::vector<double>     m_stationX;     // owned x of each section
+        std::shared_ptr<const void> m_storage;  // external storage of the arrays, if any
+        const HCPoint*          m_pointData;
+        const uint32_t*         m_offsetData;
+        const double*           m_stationData;
+        size_t                  m_size;
+        std::vector<double>     m_elmtLength;   // length of each element
+        std::vector<double>     m_midX;         // x of the middle of each element
+    };
+
+}  // namespace std
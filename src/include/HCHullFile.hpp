@@ -0,0 +1,77 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstdint>
+#include <string>
+// ===== HydroCpp Includes ===== //
+#include "HCHull.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief formats of the hull input files
+     */
+    enum class HCHullFormat
+    {
+        Workbook,   // xlsx, tbl_Hullform table
+        CSV,        // .csv, one x,y,z point per line
+        Binary      // .hcb, HydroCpp hull binary
+    };
+
+    /**
+     * @brief Hull files other than workbooks.
+     *
+     * CSV: one point x,y,z per line, separated by commas, semicolons or
+     * blanks. An optional header line and '#' comments are skipped.
+     * Points are gathered by station x as in the tbl_Hullform table.
+     *
+     * Binary (.hcb), little endian, made to be mapped and used in place:
+     *  - char[8]   magic "HCHULL\x1a\0"
+     *  - uint32    version (1)
+     *  - uint32    byte order mark 0x01020304
+     *  - uint64    number of sections S
+     *  - uint64    number of vertices P
+     *  - double    x of each station [S], increasing
+     *  - uint32    first vertex of each section [S + 1], padded to 8 bytes
+     *  - double    y, z of each vertex [P][2], each section counterclockwise
+     */
+    class HCHullFile
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+
+        /**
+         * @brief format of a hull file, from its extension
+         */
+        static HCHullFormat getFormat(const std::string& filename);
+
+        /**
+         * @brief read a CSV hull
+         * @throw std::runtime_error if the file can't be read or a
+         * line is invalid
+         */
+        static HCHull readCSV(const std::string& filename);
+
+        /**
+         * @brief map a binary hull, the vertices are used in place
+         * @throw std::runtime_error if the file can't be mapped or is invalid,
+         * including a section of less than 3 vertices, a non finite vertex
+         * or a section which is not counterclockwise
+         */
+        static HCHull readBinary(const std::string& filename);
+
+        /**
+         * @brief write a hull in the binary format
+         * @throw std::runtime_error if the file can't be written
+         */
+        static void writeBinary(const std::string& filename, const HCHull& hull);
+    };
+
+}  // namespace std
@@ -0,0 +1,127 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <utility>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCCurves.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Indexed KN table: the heel angles are sorted in an array,
+     * and for each one KNsin, waterline and volume are curves of the
+     * displacement, going linearly to 0 below the first computed point.
+     * Angles are addressed by index, arbitrary angles are interpolated
+     * linearly between the 2 closest ones.
+     */
+    class HCKNTable
+    {
+    public:
+        enum Column
+        {
+            KNSIN       = 0,
+            WATERLINE   = 1,
+            VOLUME      = 2,
+            NB_COLUMNS  = 3
+        };
+
+        /**
+         * @brief constructor of an empty table
+         */
+        HCKNTable();
+
+        /**
+         * @brief destructor
+         */
+        ~HCKNTable();
+
+        /**
+         * @brief remove all the angles
+         */
+        void clear();
+
+        /**
+         * @brief add an angle, greater than the previous ones
+         * @param angle in degrees
+         * @return the index of the angle
+         */
+        size_t addAngle(double angle);
+
+        /**
+         * @brief add a point to the curves of an angle,
+         * by increasing displacement
+         * @param angleIndex
+         * @param displ displacement
+         * @param KNsin
+         * @param waterline
+         * @param volume
+         */
+        void append(size_t angleIndex, double displ, double KNsin,
+                    double waterline, double volume);
+
+        /**
+         * @brief number of angles
+         */
+        size_t getAngleCount() const;
+
+        /**
+         * @brief angle of an index
+         */
+        double getAngle(size_t angleIndex) const;
+
+        /**
+         * @brief the curves of an angle
+         */
+        const HCCurves& getCurves(size_t angleIndex) const;
+
+        /**
+         * @brief KNsin at a displacement, by binary search
+         * @param angleIndex index of a computed angle, see getAngle()
+         * @param displ
+         * @return the value or HCCurves::NOT_AVAILABLE
+         */
+        double getKNsinAt(size_t angleIndex, double displ) const;
+
+        /**
+         * @brief KNsin at an arbitrary angle and displacement
+         * @param angle in degrees, within the computed angles, interpolated
+         * between them
+         * @param displ
+         * @return the value or HCCurves::NOT_AVAILABLE
+         */
+        double getKNsin(double angle, double displ) const;
+
+        /**
+         * @brief waterline and volume of the first (upright) angle
+         * @param displ
+         * @return a pair first is Waterline, second is Volume,
+         * HCCurves::NOT_AVAILABLE if not available
+         */
+        std::pair<double,double> getWlandVol(double displ) const;
+
+        /**
+         * @brief fill a column for sorted displacements, in one pass
+         * @param angleIndex
+         * @param column KNSIN, WATERLINE or VOLUME
+         * @param displ displacements, increasing
+         * @param n number of displacements
+         * @param out n values, HCCurves::NOT_AVAILABLE if not available
+         */
+        void fillColumn(size_t angleIndex, Column column,
+                        const double* displ, size_t n, double* out) const;
+
+    private:
+        std::vector<double>     m_angles;   // increasing
+        std::vector<HCCurves>   m_curves;   // for each angle
+    };
+
+}  // namespace std
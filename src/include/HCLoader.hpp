@@ -11,11 +11,28 @@
 #include <vector>
 #include <map>
 #include <limits>
+#include <memory>
 // ===== HydroCpp Includes ===== //
 #include "HCPoint.hpp"
-#include "HCPolygon.hpp"
+#include "HCCurves.hpp"
+#include "HCEquilibrium.hpp"
+#include "HCHull.hpp"
+#include "HCKNTable.hpp"
+#include "HCMetrics.hpp"
+#include "HCParams.hpp"
+#include "HCResultCache.hpp"
+#include "HCScheduler.hpp"
+#include "HCSectionCut.hpp"
+#include "HCSectionShape.hpp"
+#include "HCSectionSweep.hpp"
 
 
+// The workbook is an implementation detail of the loader
+namespace OpenXLSX
+{
+    class XLWorkbook;
+    class XLWorksheet;
+}
 
 namespace HydroCpp
 {
@@ -54,6 +71,36 @@ namespace HydroCpp
         bool   submerged        {false};
     };
 
+    /**
+     * @brief columns of the hydrostatic curves, as function of the draught
+     */
+    enum HydroColumn
+    {
+        HC_VOLUME = 0,
+        HC_DISPLACEMENT,
+        HC_IMMERSION,
+        HC_MCT,
+        HC_LCB,
+        HC_TCB,
+        HC_LCF,
+        HC_KMT,
+        HC_WATERPLANE_AREA,
+        HC_RMT,
+        HC_RML,
+        HC_VCB,
+        HC_LPP,
+        HC_NB_COLUMNS
+    };
+
+    /**
+     * @brief scalar type of the vertices of the section cuts
+     */
+    enum class HCScalar
+    {
+        Double,
+        Float   // vertices and crossings in float, moments in double
+    };
+
     struct KNdata
     {
         double angle            {0.0};
@@ -67,14 +114,36 @@ namespace HydroCpp
 
     class HCLoader
     {
+        /**
+         * @brief partial sums of the hydrodata over a range of sections
+         */
+        struct SectionSums
+        {
+            Hydrodata   hydro;              // moments, not yet divided
+            uint32_t    nLCF        {0};    // number of LCF terms
+            double      firstWetX   {0.0};  // x of the first wet section
+        };
+
     public:
         /**
          * @brief constructor
-         * @param filename of the excel filename containing the data
-         * @param loc
+         * @param filename of the excel filename containing the data, or
+         * of a CSV (.csv) or binary (.hcb) hull file, see HCHullFile.
+         * The parameters of a hull file are read in its sidecar file
+         * (HCParams::getSidecarName), if any. The sidecar of a workbook
+         * gives the parameters without named range
          */
         HCLoader(const std::string& filename);
 
+        /**
+         * @brief constructor on a hull in memory, e.g. in an optimisation
+         * loop: no file is read, and the results are written only if an
+         * output workbook is set (setOutput)
+         * @param hull the sections, see HCHull
+         * @param params the parameters, the default values for the others
+         */
+        explicit HCLoader(HCHull hull, const HCParams& params = HCParams());
+
         /**
          * @brief destructor
          */
@@ -92,64 +161,437 @@ namespace HydroCpp
         void computeKNdatas();
 
         /**
-         * @brief write data to workbook
+         * @brief write data to workbook, and the metrics if enabled
+         * @throw std::runtime_error if there is no output workbook
          */
         void writeToWorkbook();
 
+        /**
+         * @brief override the parameters read from the input file
+         * @param params the parameters to override
+         * @throw std::runtime_error if a parameter, or a default one, is
+         * not finite and positive; the parameters are then unchanged
+         */
+        void setParams(const HCParams& params);
+
+        /**
+         * @brief set the workbook the results are written to. It is
+         * created if it doesn't exist, a workbook input is copied into it
+         * @param filename default: the input workbook, or the hull file
+         * with the xlsx extension
+         */
+        void setOutput(const std::string& filename);
+
+        /**
+         * @brief return the input file
+         */
+        const std::string& getFilename() const;
+
+        /**
+         * @brief return the workbook the results are written to
+         */
+        const std::string& getOutput() const;
+
+        /**
+         * @brief write the hull in the binary format, to be loaded
+         * faster the next times
+         * @param filename the .hcb file
+         */
+        void exportHull(const std::string& filename) const;
+
+        /**
+         * @brief set the number of threads used to compute the tables
+         * @param threads number of threads, 1 run the serial path,
+         * 0 use all the cores
+         */
+        void setThreadCount(unsigned threads);
+
+        /**
+         * @brief return the number of threads used to compute the tables
+         */
+        unsigned getThreadCount() const;
+
+        /**
+         * @brief record the time of each phase and the hot path counters,
+         * written by writeToWorkbook in getMetricsFile()
+         * @param enable true to enable, the load phase is recorded anyway
+         * @note kn_interpolation is nested in kn_sweep (KN table build)
+         * and write (resampling of the rows)
+         */
+        void setMetrics(bool enable);
+
+        /**
+         * @brief return the metrics, nullptr if disabled
+         */
+        const HCMetrics* getMetrics() const;
+
+        /**
+         * @brief return the JSON metrics file, next to the output
+         * workbook: <output>.metrics.json
+         */
+        std::string getMetricsFile() const;
+
+        /**
+         * @brief split the sections of each waterline evaluation in chunks
+         * computed in parallel, to cut the latency of a single waterline
+         * on large hulls. Require more than one thread
+         * @param grain number of sections per chunk, 0 to disable
+         * @note the order of the floating point sums differs from the
+         * serial path, results may differ in the last digits
+         */
+        void setSectionGrain(size_t grain);
+
+        /**
+         * @brief compute the waterline families (hydrostatic table and
+         * each KN angle) with sweeps: each section is prepared once per
+         * direction, then every waterline is answered by evaluating
+         * piecewise polynomials instead of splitting the section
+         * @param sweep true to enable
+         * @note the inertia of sections cut in several chords is the
+         * exact one, where the splitter path accumulates chord lengths
+         */
+        void setSweepMode(bool sweep);
+
+        /**
+         * @brief compute the KN directly at the displacements of the KN
+         * table: for each angle and displacement, the equal volume
+         * waterline is found by a safeguarded Newton iteration (the
+         * derivative of the volume being the waterplane area), instead
+         * of stepping the waterlines and interpolating
+         * @param direct true to enable
+         */
+        void setDirectKN(bool direct);
+
+        /**
+         * @brief compute the hydrostatic table with adaptive waterline
+         * steps: the draughts are first computed every 16 steps, and each
+         * interval is halved while the volume and the KMT in its middle
+         * are not predicted within the tolerance, or its volume differs
+         * from the integral of the waterplane area (knuckles). The other
+         * rows are interpolated, the table keeps the uniform draughts
+         * @param tolerance relative error allowed on the volume and the
+         * KMT, estimated in the middle of the intervals, 0 to disable
+         * @note the volume and its vertical moment are interpolated with
+         * their derivatives, from the waterplane, the other moments
+         * linearly, so that wall sided parts are exact
+         */
+        void setAdaptiveTolerance(double tolerance);
+
+        /**
+         * @brief scalar type of the vertices when the sections are cut
+         * by the waterlines. In float, a single precision copy of the
+         * vertices is classified and clipped with the HCPointF
+         * instantiations of the kernels, twice the SIMD lanes for half
+         * the memory traffic, the moments and the sums of the hydrodata
+         * staying in double
+         * @param scalar HCScalar::Double by default
+         * @note the vertices are rounded to about 7 significant digits,
+         * see the README for the accuracy. The sections the single
+         * precision clip doesn't handle (vertex on the waterline, several
+         * wet parts) and the sweeps (setSweepMode) are computed in double
+         */
+        void setScalar(HCScalar scalar);
+
+        /**
+         * @brief cut the sections by the waterlines with the kernel of
+         * their shape, classified at load (see HCSectionShape): closed
+         * form for the rectangles, binary search of the 2 crossings for
+         * the convex sections, HCHalfPlaneClip for the others. The
+         * sections are also triangulated, the waterlines through a vertex
+         * cut their triangles instead of splitting them
+         * @param enable true by default
+         * @note in single precision (setScalar), every section is cut by
+         * the float clip
+         */
+        void setShapeKernels(bool enable);
+
+        /**
+         * @brief cache the hydrostatic table and the KN datas on disk,
+         * computeHydroTable and computeKNdatas then read them back when
+         * the hull, the parameters and the options are unchanged
+         * @param cache the cache, may be shared by several loaders,
+         * nullptr to disable
+         */
+        void setCache(std::shared_ptr<HCResultCache> cache);
+
+        /**
+         * @brief return the hydrostatic table, one row per waterline
+         * step, available after computeHydroTable
+         */
+        const std::vector<Hydrodata>& getHydroTable() const;
+
+        /**
+         * @brief return the KN datas, key: angle, value: one data per
+         * waterline step, or per displacement of the KN table in direct
+         * mode, available after computeKNdatas
+         */
+        const std::map<double,std::vector<KNdata>>& getKNdatas() const;
+
+        /**
+         * @brief return the KN table, to be queried at any angle and
+         * displacement, available after computeKNdatas
+         */
+        const HCKNTable& getKNTable() const;
+
+        /**
+         * @brief return the hydrostatic curves as function of the draught
+         * (columns in HydroColumn), available after computeHydroTable
+         */
+        const HCCurves& getHydroCurves() const;
+
+        /**
+         * @brief compute the hydrodata for a given waterline
+         * @param waterline the waterline, wet side on the right
+         * @param sweeps the sections sweeps for the waterline direction,
+         * nullptr to split each section
+         * @note return HCPoint(0,-1) in case of error
+         * @note the temporaries of the waterline (the partial sums of the
+         * --section-grain chunks) are taken from the arena of the thread,
+         * rewound on return. The section cuts keep their own per thread
+         * buffers instead (splitter, clip sides, triangle distances): their
+         * capacity is reused from a waterline to the next, so they don't
+         * allocate either once warmed up
+         */
+        Hydrodata computeHydroFromWaterline(const std::pair<HCPoint,HCPoint>& waterline,
+                                const std::vector<HCSectionSweep>* sweeps = nullptr) const;
+
+        /**
+         * @brief compute the hydrodata for a waterline given by its draught
+         * and heel, across the whole hull
+         * @param draught height of the waterline at the centerline
+         * @param heel angle in degrees, the waterline rising towards the
+         * positive y as for the KN table
+         */
+        Hydrodata computeHydro(double draught, double heel = 0.0) const;
+
+        /**
+         * @brief compute the free floating position of a loading
+         * condition, see HCEquilibrium
+         */
+        HCFloatingPosition solveEquilibrium(const HCLoadCondition& condition);
+
+        /**
+         * @brief compute the free floating positions of loading
+         * conditions, each one starting from the previous position
+         */
+        std::vector<HCFloatingPosition> solveEquilibrium(
+                        const std::vector<HCLoadCondition>& conditions);
+
     private:
 
          /**
          * @brief read data from name range in workbook
          * @param wb the excel workbook
          * @param rngName the range name
-         * @param defautVal which will be returned if named range doesn't exist
+         * @param defautVal which will be used if named range doesn't exist
+         * @param params the value is set in, if the named range exists
          */
-        double getValueFromRange(const OpenXLSX::XLWorkbook& wb,
+        void getValueFromRange(const OpenXLSX::XLWorkbook& wb,
                                 const std::string& rngName, 
-                                double defautVal );
+                                double defautVal,
+                                HCParams& params );
+
+        /**
+         * @brief default max displacement, the box of the hull up to
+         * the max waterline
+         */
+        double getDefaultMaxDispl(double maxWl) const;
         
         /**
          * @brief check that the xmin xmax ymin ymax of the section
          * and ajust the corresponding member variable (struct MinMax)
          */
-        void checkMinMax(const std::vector<HCPoint>& section );
+        void checkMinMax(const HCPoint* section, size_t n);
 
         /**
-         * @brief compute the hydrodata for a given waterline
-         * @note return HCPoint(0,-1) in case of error
+         * @brief prepare the sweep of each section for waterlines
+         * of a given direction
+         * @param direction of the waterlines
+         */
+        std::vector<HCSectionSweep> buildSweeps(const HCPoint& direction) const;
+
+        /**
+         * @brief cut a section by the waterline with HCPolygonSplitter,
+         * for the cases HCHalfPlaneClip doesn't handle
+         * @param vertices of the section to be cut, counterclockwise
+         * @param n number of vertices
+         * @param waterline the waterline, wet side on the right
+         * @param wl the waterline height at x=0
+         */
+        static HCSectionCut splitSection(const HCPoint* vertices, size_t n,
+                                const std::pair<HCPoint,HCPoint>& waterline,
+                                double wl);
+
+        /**
+         * @brief cut a section by the waterline with the kernels of its
+         * shape in double, HCHalfPlaneClip for the kernels of Line, its
+         * triangles for a vertex on the line, or splitSection for the
+         * cases they don't handle
+         * @param i index of the section
+         * @param points vertices of the whole hull, in the scalar type T
+         * @param line the waterline, in the scalar type T
+         * @param waterline the waterline
+         * @param wl the waterline height at x=0
+         */
+        template<typename Line, typename T>
+        HCSectionCut clipSection(size_t i, const HCPointT<T>* points,
+                                const std::pair<HCPointT<T>,HCPointT<T>>& line,
+                                const std::pair<HCPoint,HCPoint>& waterline, double wl) const;
+
+        /**
+         * @brief accumulate the moments of the sections [first, last)
+         * cut by the waterline, with the kernels fitting the waterline
+         * @param wl the waterline height at x=0
+         * @param sweeps the sections sweeps if any, nullptr to use the splitter
+         * @param sums the partial sums to be updated
+         */
+        void accumulateSections(size_t first, size_t last,
+                                const std::pair<HCPoint,HCPoint>& waterline,
+                                double wl, const std::vector<HCSectionSweep>* sweeps,
+                                SectionSums& sums) const;
+
+        /**
+         * @brief accumulate the moments of the sections [first, last)
+         * @param sums the partial sums to be updated
+         * @param cutFn returns the HCSectionCut of a section index, inlined
+         * in the loop
+         */
+        template<typename CutFn>
+        void accumulateCuts(size_t first, size_t last, SectionSums& sums, CutFn cutFn) const;
+
+        /**
+         * @brief merge the partial sums of the following range of sections
+         * @param sums the partial sums to be updated
+         * @param other the partial sums of the next range
+         */
+        static void mergeSums(SectionSums& sums, const SectionSums& other);
+
+        /**
+         * @brief compute in parallel families of waterlines. Each family
+         * starts from a base line, shifted vertically by step for
+         * each new waterline, until a submerged waterline or maxSteps
+         * @param bases the base line of each family (not computed)
+         * @param step vertical shift between 2 waterlines
+         * @param maxSteps max number of waterlines of a family
+         * @return for each family, the hydrodata of each waterline, in the
+         * serial order, the last one being the submerged one if any
+         */
+        std::vector<std::vector<Hydrodata>> computeFamilies(
+                        const std::vector<std::pair<HCPoint,HCPoint>>& bases,
+                        double step, size_t maxSteps) const;
+
+        /**
+         * @brief compute m_hydroTable with adaptive steps, see
+         * setAdaptiveTolerance. The hull is assumed dry below its first
+         * wet waterline, and submerged above its first submerged one
+         */
+        void computeHydroTableAdaptive();
+
+        /**
+         * @brief compute the KN datas at the displacements of the KN table,
+         * see setDirectKN
+         */
+        void computeKNdatasDirect();
+
+        /**
+         * @brief find the equal volume waterlines of an angle for each
+         * target displacement, in increasing order
+         * @param angle the heel angle
+         * @param evaluations incremented by the number of waterlines computed
+         * @return the KN data of each target, not valid if the displacement
+         * can't be reached before a section is submerged
+         */
+        std::vector<KNdata> solveKNAngle(double angle, size_t& evaluations) const;
+
+        /**
+         * @brief estimate the step of a waterlines family at which 
+         * the hull will be submerged, to avoid over scheduling
+         * @param base the base line of the family
+         * @param step vertical shift between 2 waterlines
+         * @return the number of steps
          */
-        Hydrodata computeHydroFromWaterline(const std::pair<HCPoint,HCPoint>& waterline );
+        size_t estimateSubmergedStep(const std::pair<HCPoint,HCPoint>& base,
+                                    double step) const;
         
         /**
-         * @brief retrieve Waterline and Volume from linear interpolation
-         * in the KN datas stored
-         * @param Displ displacement to be considered
-         * @return a pair first is Waterline, second is Volume
+         * @brief tables stored in the cache
+         */
+        enum class CacheTable : uint32_t
+        {
+            Hydro = 0,
+            KN
+        };
+
+        /**
+         * @brief hash of the inputs of a table: the hull, the parameters
+         * and the options the results depend on
+         */
+        uint64_t getCacheKey(CacheTable table) const;
+
+        /**
+         * @brief read m_hydroTable from the cache
+         * @return false on a miss or without cache
+         */
+        bool loadHydroTable(uint64_t key);
+
+        /**
+         * @brief write m_hydroTable in the cache, if any
+         */
+        void storeHydroTable(uint64_t key) const;
+
+        /**
+         * @brief read m_KNdatas and m_KNtargets from the cache
+         * @return false on a miss or without cache
+         */
+        bool loadKNdatas(uint64_t key);
+
+        /**
+         * @brief write m_KNdatas and m_KNtargets in the cache, if any
+         */
+        void storeKNdatas(uint64_t key) const;
+
+        /**
+         * @brief build m_KNTable from m_KNdatas
+         */
+        void buildKNTable();
+
+        /**
+         * @brief build m_hydroCurves from m_hydroTable
+         */
+        void buildHydroCurves();
+
+        /**
+         * @brief write the tables and the notes in the output workbook
          */
-        std::pair<double,double> getWlandVol(double displ) const;
+        void saveWorkbook();
 
         /**
-         * @brief retrieve KNsin from linear interpolation
-         * in the KN datas stored
-         * @param angle angle be considered
-         * @param Displ displacement to be considered
-         * @return the interpolated KNsin value or 
-         * std::numeric_limits<double>::min() if not available
+         * @brief write the metrics in getMetricsFile()
          */
-        double getKNsin(double angle, double displ) const;
+        void writeMetrics() const;
 
         /**
-         * @brief write Hydrotable on the corresponding sheet
+         * @brief write the header of the Hydrotable on the corresponding sheet
          * @param wks the worksheet to write on 
          */
-        void writeHydroTable(OpenXLSX::XLWorksheet& wks) const;
+        void writeHydroHeader(OpenXLSX::XLWorksheet& wks) const;
 
-         /**
-         * @brief write KN on the corresponding sheet
+        /**
+         * @brief Hydrotable rows, column by column, as in the header
+         */
+        std::vector<std::vector<double>> getHydroColumns() const;
+
+        /**
+         * @brief write the header of the KN table on the corresponding sheet
          * @param wks the worksheet to write on 
-         * @return the number of written lines
          */
-        uint32_t writeKNTable(OpenXLSX::XLWorksheet& wks) const;
+        void writeKNHeader(OpenXLSX::XLWorksheet& wks) const;
+
+        /**
+         * @brief KN table rows, column by column, as in the header.
+         * Missing values are HCCurves::NOT_AVAILABLE
+         */
+        std::vector<std::vector<double>> getKNColumns() const;
         
         /**
          * @brief write notes in the dedicated worksheet
@@ -161,17 +603,24 @@ namespace HydroCpp
 
     private:
         std::string                 m_filename;
+        std::string                 m_output;
+        HCParams                    m_params;
 
-         /**
-         * @brief key:x, value: pointer HCpolygon of cross section
-         */
-        std::map<double,HCPolygon*>  m_hull;
+        HCHull                      m_hull;
         std::vector<Hydrodata>      m_hydroTable;
 
         /**
          * @brief key:angle, value: vector of KN data
          */
         std::map<double,std::vector<KNdata>>     m_KNdatas; 
+
+        /**
+         * @brief displacements of the KN table, set in direct mode only,
+         * m_KNdatas then holds one data per displacement for each angle
+         */
+        std::vector<double>         m_KNtargets;
+        HCKNTable                   m_KNTable;
+        HCCurves                    m_hydroCurves   {HC_NB_COLUMNS};
         MinMax                      m_minMax {
                     std::numeric_limits<double>::max(), //xmin
                     std::numeric_limits<double>::min(), //xmax
@@ -186,6 +635,22 @@ namespace HydroCpp
         double                      m_deltaDispl;
         double                      m_d_sw;
 
+        std::unique_ptr<HCScheduler> m_scheduler;
+        size_t                      m_sectionGrain  {0};
+        bool                        m_sweepMode     {false};
+        bool                        m_directKN      {false};
+        double                      m_adaptiveTol   {0.0};
+        HCScalar                    m_scalar        {HCScalar::Double};
+        std::vector<HCPointF>       m_floatPoints;  // vertices of the hull, in float mode
+        std::vector<HCSectionShape> m_shapes;       // one per section, empty if disabled
+
+        std::unique_ptr<HCEquilibrium> m_equilibrium;   // created on the first condition
+
+        std::shared_ptr<HCResultCache> m_cache;
+        uint64_t                    m_hullKey       {0};  // hash of the hull, set with the cache
+
+        std::unique_ptr<HCMetrics>  m_metrics;
+        HCMetrics::PhaseTime        m_loadTime;
 
     };
 
@@ -11,16 +11,28 @@
 #include <string>
 #include <stdexcept>
 #include <iostream>
+#include <mutex>
 
 // ===== HydroCpp Includes ===== //
 
 namespace HydroCpp
 {
+    /**
+     * @brief mutex shared by the loggers, so that lines written
+     * from several threads are not interleaved
+     */
+    inline std::mutex& logMutex()
+    {
+        static std::mutex mtx;
+        return mtx;
+    }
+
     class HCLogError
     {
     public:
         inline explicit HCLogError(const std::string& err) 
         {
+            std::lock_guard<std::mutex> lock(logMutex());
             std::cerr << err << std::endl;
         };
     };
@@ -30,6 +42,7 @@ namespace HydroCpp
     public:
         inline explicit HCLogInfo(const std::string& err) 
         {
+            std::lock_guard<std::mutex> lock(logMutex());
             std::cout << err << std::endl;
         };
     };
@@ -0,0 +1,193 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief counters of the hot paths
+     */
+    enum HCMetricCounter
+    {
+        HC_WATERLINES = 0,          // computeHydroFromWaterline calls
+        HC_SPLITTER_RUNS,           // HCPolygonSplitter builds
+        HC_VERTICES_CLASSIFIED,     // vertices classified against a waterline
+        HC_INTERSECTIONS,           // edge / waterline intersections computed
+        HC_ON_LINE_VERTICES,        // degenerate vertices, LineSide::On
+        HC_TRIANGLES,               // triangles produced by HCPolygon
+        HC_NB_METRIC_COUNTERS
+    };
+
+    /**
+     * @brief phases of a run
+     */
+    enum HCPhase
+    {
+        HC_PHASE_LOAD = 0,          // HCLoader constructor, hull and parameters
+        HC_PHASE_HYDRO_TABLE,       // computeHydroTable
+        HC_PHASE_KN_SWEEP,          // computeKNdatas, the waterlines
+        HC_PHASE_KN_INTERPOLATION,  // KN table build and resampling
+        HC_PHASE_WRITE,             // writeToWorkbook
+        HC_NB_PHASES
+    };
+
+    /**
+     * @brief Metrics of a run: wall and CPU time of each phase, and
+     * counters of the hot paths.
+     *
+     * The hot paths call HCMetrics::add(), which increments a thread
+     * local counter only when the thread is bound to a metrics object,
+     * so the disabled cost is a thread local load and a branch. The
+     * thread local counters are flushed to the metrics object when the
+     * binding ends: a Phase binds the calling thread, and HCScheduler
+     * binds the workers to the metrics of the thread queuing the tasks.
+     */
+    class HCMetrics
+    {
+    public:
+        /**
+         * @brief time spent in a phase
+         */
+        struct PhaseTime
+        {
+            double      wallMs  {0.0};
+            double      cpuMs   {0.0};  // process CPU time, all threads
+            uint64_t    calls   {0};
+        };
+
+        /**
+         * @brief bind the calling thread to a metrics object, the
+         * counts are flushed to it at the end of the scope. Nested
+         * bindings to the same object cost nothing
+         */
+        class Binding
+        {
+        public:
+            explicit Binding(HCMetrics* metrics);
+            ~Binding();
+
+            Binding(const Binding&) = delete;
+            Binding& operator=(const Binding&) = delete;
+
+        private:
+            HCMetrics*  m_previous;
+            bool        m_switched;
+        };
+
+        /**
+         * @brief measure a phase from construction to destruction,
+         * the calling thread is bound to the metrics meanwhile.
+         * If metrics is nullptr, nothing is recorded but elapsed()
+         */
+        class Phase
+        {
+        public:
+            Phase(HCMetrics* metrics, HCPhase phase);
+            ~Phase();
+
+            Phase(const Phase&) = delete;
+            Phase& operator=(const Phase&) = delete;
+
+            /**
+             * @brief return the time elapsed since construction
+             */
+            PhaseTime elapsed() const;
+
+        private:
+            HCMetrics*                              m_metrics;
+            HCPhase                                 m_phase;
+            Binding                                 m_binding;
+            std::chrono::steady_clock::time_point   m_wallStart;
+            double                                  m_cpuStart;
+        };
+
+        HCMetrics();
+        ~HCMetrics();
+
+        HCMetrics(const HCMetrics&) = delete;
+        HCMetrics& operator=(const HCMetrics&) = delete;
+
+        /**
+         * @brief increment a counter of the metrics the calling thread
+         * is bound to, if any
+         */
+        static void add(HCMetricCounter counter, uint64_t n = 1)
+        {
+            if (t_metrics)
+                t_counts[counter] += n;
+        }
+
+        /**
+         * @brief return the metrics the calling thread is bound to,
+         * nullptr if none
+         */
+        static HCMetrics* current() { return t_metrics; }
+
+        /**
+         * @brief return the process CPU time, in ms
+         */
+        static double getCpuTime();
+
+        /**
+         * @brief add the time of a phase, measured elsewhere
+         */
+        void addPhase(HCPhase phase, const PhaseTime& time);
+
+        /**
+         * @brief return a counter, the counts of the threads still
+         * bound are not included
+         */
+        uint64_t get(HCMetricCounter counter) const;
+
+        /**
+         * @brief return the time of a phase
+         */
+        PhaseTime getPhase(HCPhase phase) const;
+
+        /**
+         * @brief return the name of a counter, as in the JSON file
+         */
+        static const char* getName(HCMetricCounter counter);
+
+        /**
+         * @brief return the name of a phase, as in the JSON file
+         */
+        static const char* getName(HCPhase phase);
+
+        /**
+         * @brief write the metrics as a JSON object
+         * @param input the input file of the run
+         * @param threads number of threads of the run
+         */
+        void writeJson(std::ostream& out, const std::string& input, unsigned threads) const;
+
+    private:
+        /**
+         * @brief add the counts of the calling thread and reset them
+         */
+        void flush();
+
+    private:
+        inline static thread_local HCMetrics*   t_metrics   { nullptr };
+        inline static thread_local uint64_t     t_counts[HC_NB_METRIC_COUNTERS] {};
+
+        std::atomic<uint64_t>   m_counters[HC_NB_METRIC_COUNTERS];
+        std::atomic<uint64_t>   m_wallNs[HC_NB_PHASES];
+        std::atomic<uint64_t>   m_cpuNs[HC_NB_PHASES];
+        std::atomic<uint64_t>   m_calls[HC_NB_PHASES];
+    };
+
+}  // namespace std
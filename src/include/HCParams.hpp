@@ -0,0 +1,112 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <map>
+#include <string>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Run parameters (max_wl, Δwl, φMax...) given outside of a
+     * workbook: on the command line or in a sidecar file.
+     * Parameters are stored under the names of the named ranges
+     * (HCConfig.hpp), ASCII aliases are accepted: max_wl, delta_wl,
+     * phi_max, delta_phi, max_disp, delta_disp, rho_sw.
+     * Only the parameters that were set are stored, the others keep
+     * the value of the workbook or the default one.
+     * All the parameters are steps, maxima or the density: a value that
+     * is not finite and positive is rejected, a null step would never
+     * end the loops of the tables.
+     */
+    class HCParams
+    {
+    public:
+        /**
+         * @brief constructor, no parameter set
+         */
+        HCParams();
+
+        /**
+         * @brief destructor
+         */
+        ~HCParams();
+
+        /**
+         * @brief set a parameter
+         * @param name name of the named range or ASCII alias
+         * @param value
+         * @return false if the name is unknown or the value is not
+         * finite and positive
+         */
+        bool set(const std::string& name, double value);
+
+        /**
+         * @brief set a parameter from a "name=value" string
+         * @return false if the name is unknown or the value invalid
+         */
+        bool parse(const std::string& assignment);
+
+        /**
+         * @brief read a parameter file, one "name = value" (or
+         * "name value") per line, '#' starting a comment
+         * @throw std::runtime_error if the file can't be read or a
+         * line is invalid (unknown name, value not finite and positive)
+         */
+        void readFile(const std::string& filename);
+
+        /**
+         * @brief write the parameters that were set in a parameter
+         * file, under their ASCII aliases
+         * @throw std::runtime_error if the file can't be written
+         */
+        void writeFile(const std::string& filename) const;
+
+        /**
+         * @brief set the parameters of another set, overriding these ones
+         */
+        void merge(const HCParams& other);
+
+        /**
+         * @brief return true if the parameter was set
+         * @param name name of the named range
+         */
+        bool has(const std::string& name) const;
+
+        /**
+         * @brief value of a parameter
+         * @param name name of the named range
+         * @param defaultValue returned if the parameter is not set
+         */
+        double get(const std::string& name, double defaultValue) const;
+
+        /**
+         * @brief return true if no parameter is set
+         */
+        bool empty() const;
+
+        /**
+         * @brief name of the named range of a parameter
+         * @param name name of the named range or ASCII alias
+         * @return the name, empty if unknown
+         */
+        static std::string canonicalName(const std::string& name);
+
+        /**
+         * @brief name of the sidecar parameter file of a hull file,
+         * hull.csv -> hull.params
+         */
+        static std::string getSidecarName(const std::string& hullFile);
+
+    private:
+        std::map<std::string, double>   m_values;
+    };
+
+}  // namespace std
@@ -9,8 +9,11 @@
 // ===== External Includes ===== //
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 // ===== HydroCpp Includes ===== //
 #include "HCPoint.hpp"
+#include "HCSmallVector.hpp"
 
 
 namespace HydroCpp
@@ -22,10 +25,32 @@ namespace HydroCpp
         HCPoint    P2;   
     };
 
+    /**
+     * @brief area, first and second moments of a polygon, relative to
+     * the origin of the coordinates system
+     */
+    struct HCMoments
+    {
+        double  area    {0.0};  // positive if counterclockwise
+        double  Mx      {0.0};  // integral of x dA
+        double  My      {0.0};  // integral of y dA
+        double  Ixx     {0.0};  // integral of y² dA
+        double  Iyy     {0.0};  // integral of x² dA
+        double  Ixy     {0.0};  // integral of x.y dA
+    };
+
     class HCPolygon 
     {
 
     public:
+        /**
+         * @brief number of vertices stored in the polygon itself, most
+         * of the sections have less, more are stored on the heap
+         */
+        static constexpr size_t INLINE_VERTICES = 64;
+
+        using Vertices = HCSmallVector<HCPoint, INLINE_VERTICES>;
+
         /**
          * @brief constructor
          * @param x
@@ -33,6 +58,13 @@ namespace HydroCpp
          */
         HCPolygon(const std::vector<HCPoint>& vertexVect);
 
+        /**
+         * @brief constructor
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         */
+        HCPolygon(const HCPoint* vertices, size_t n);
+
         /**
          * @brief
          */
@@ -58,7 +90,7 @@ namespace HydroCpp
         HCPolygon& operator=(const HCPolygon& other);
 
         /**
-         * @brief Move assignment operator [deleted]
+         * @brief Move assignment operator
          * @param other The object to be move assigned
          * @return A reference to the new object
          */
@@ -68,7 +100,7 @@ namespace HydroCpp
          * @brief return const ref of the vertices
          * @return A reference to the mertices
          */
-        const std::vector<HCPoint>& getVertices() const;
+        const Vertices& getVertices() const;
 
         /**
          * @brief get the area of the polygon
@@ -82,10 +114,66 @@ namespace HydroCpp
          */
         const HCPoint& getCog();
 
+        /**
+         * @brief get the area, first and second moments of the polygon
+         * @return a ref to the moments, relative to the origin
+         */
+        const HCMoments& getMoments();
+
+        /**
+         * @brief get the second moment about the x axis (integral of y² dA)
+         */
+        double getIxx();
+
+        /**
+         * @brief get the second moment about the y axis (integral of x² dA)
+         */
+        double getIyy();
+
+        /**
+         * @brief get the product of inertia (integral of x.y dA)
+         */
+        double getIxy();
+
+        /**
+         * @brief Compute the area and the first moments by triangulation
+         * @return the moments, second moments are not computed
+         * @note slow, kept as a reference to validate the closed form.
+         * Runs the recursive triangulator, independent of triangulate()
+         */
+        HCMoments computeByTriangulation();
+
+        /**
+         * @brief Compute area, first and second moments of a polygon
+         * in a single pass over the vertex ring (Green's theorem)
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         * @return the moments, area is negative if clockwise
+         * @note no allocation, could be used on any vertex buffer
+         */
+        static HCMoments computeMoments(const HCPoint* vertices, size_t n);
+
+        /**
+         * @brief triangulate a simple polygon by ear clipping, on an
+         * index ring without copying the vertices
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         * @param triangles output, n - 2 triangles of vertex indices,
+         * in the orientation of the polygon
+         * @note O(n log n + n r) for r reflex vertices: the ears are
+         * only tested against them, and taken from a heap. That is
+         * O(n log n) for a convex polygon, but O(n²) in the worst case,
+         * not the bound of a monotone partition; the sections have few
+         * reflex corners. Degenerate rings (self intersecting) are still
+         * cut in n - 2 triangles, some of them overlapping
+         */
+        static void triangulate(const HCPoint* vertices, size_t n,
+                                std::vector<std::array<uint32_t, 3>>& triangles);
+
     private:
 
         /**
-         * @brief Compute the area of the triangulated polygone
+         * @brief Compute the moments of the polygon
          * @note shall be called before grabbing data
          */
         void compute();
@@ -164,11 +252,12 @@ namespace HydroCpp
                                         size_t start, size_t end);
 
     private:
-        std::vector<HCPoint>    m_vertices;
+        Vertices                m_vertices;
         bool                    m_isComputed;
         std::vector<HCTriangle> m_trianglesList;
         double                  m_area;
         HCPoint                 m_cog;
+        HCMoments               m_moments;
 
     };
 
@@ -7,8 +7,8 @@
 #pragma once
 
 // ===== External Includes ===== //
+#include <cstdint>
 #include <vector>
-#include <list>
 // ===== HydroCpp Includes ===== //
 #include "HCPolygon.hpp"
 #include "HCPolygons.hpp"
@@ -26,10 +26,12 @@ namespace HydroCpp
     class Vertex
     {
     public:
+        static constexpr uint32_t npos = UINT32_MAX;
+
         HCPoint     pt          { 0.0, 0.0 };
         LineSide    side        { LineSide::Undef};
-        Vertex*     next        { nullptr };
-        Vertex*     prev        { nullptr };
+        uint32_t    next        { npos };   // index in the vertex pool
+        uint32_t    prev        { npos };   // index in the vertex pool
         double      distToStart { 0.0 }; 
         bool        isSrc       { false };
         bool        isDest      { false };
@@ -41,17 +43,15 @@ namespace HydroCpp
         ~Vertex() = default;
     };
 
-    class SplitPoly
+    /**
+     * @brief a loop of the splitted polygon, as a range of
+     * the collected points
+     */
+    struct SplitLoop
     {
-    public:
-        std::vector<HCPoint>    vertices;
+        uint32_t    first       { 0 };
+        uint32_t    count       { 0 };
         LineSide    side        { LineSide::Undef };
-    public:
-        SplitPoly() : vertices(), side( LineSide::Undef )
-        {}
-
-        ~SplitPoly() = default;
-
     };
 
     class HCPolygonSplitter 
@@ -62,6 +62,12 @@ namespace HydroCpp
                     const HCPoint& M);
 
     public:
+        /**
+         * @brief default constructor, the splitter shall be reset
+         * with a polygon prior to grabbing any data
+         */
+        HCPolygonSplitter();
+
         /**
          * @brief constructor
          * @param vertices
@@ -112,13 +118,53 @@ namespace HydroCpp
         HCPolygonSplitter& operator=(HCPolygonSplitter&& other);
 
 
+        /**
+         * @brief split another polygon, reusing the storage of the
+         * previous split (no allocation once the splitter is warmed up)
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         * @param line
+         */
+        void reset(const HCPoint* vertices, size_t n,
+                    const std::pair<HCPoint,HCPoint>& line);
+
+        /**
+         * @brief split another polygon, reusing the storage
+         * @param vertices
+         * @param line
+         */
+        void reset(const std::vector<HCPoint>& vertices,
+                    const std::pair<HCPoint,HCPoint>& line);
+
+        /**
+         * @brief split the same polygon by another line, reusing the storage
+         * @param line
+         */
+        void reset(const std::pair<HCPoint,HCPoint>& line);
+
         /**
          * @brief split the polygon in 2 part 
          * @param side The object to be move assigned
          * @return the splitted polygon on the requested side of the line
+         * @note the polygons are copied, prefer getMomentsFromSide
+         * in the computation loops
          */
         HCPolygons& getPolygonFromSide(LineSide side);
 
+        /**
+         * @brief moments of the part of the polygon on the requested
+         * side of the line, computed on the collected loops in place
+         * @param side
+         * @return the sum of the moments of the loops, counterclockwise
+         */
+        HCMoments getMomentsFromSide(LineSide side);
+
+        /**
+         * @brief check if a part of the polygon lies on the requested side
+         * @param side
+         */
+        bool hasSide(LineSide side);
+
         /**
          * @brief split the polygon in 2 part and get the intersected segments
          * @return a vector of the intersected segments
@@ -151,7 +197,12 @@ namespace HydroCpp
         /**
          * @brief creates the new edges along the split line
          */
-        void createBridge(Vertex* srcPt, Vertex* dstPt);
+        void createBridge(uint32_t srcPt, uint32_t dstPt);
+
+        /**
+         * @brief build the vertex pool from m_source and m_line
+         */
+        void build();
 
         /**
          * @brief scalar projection on line. in case of co-linear
@@ -167,31 +218,18 @@ namespace HydroCpp
          */
         double distanceFromStart(const HCPoint& M) const;
 
-        /**
-         * @brief return the side of the point from oriented segment
-         * @param M
-         * @return LineSide enum
-         * @note could be static
-         */
-        LineSide getSide( const HCPoint& M) const;
-        
-        /**
-         * @brief Compute the intersection between the line and the segment
-         * @param line
-         * @param start the start point of the segment
-         * @param end the end point of the segment
-         * @return The intersection point
-         * @note could be static
-         */
-        HCPoint intersection(const std::pair<HCPoint,HCPoint>& line, 
-                            const HCPoint& A, const HCPoint& B) const;
-
     private:
-        std::list<Vertex>       m_vertices;       // polygons vertices
-        std::vector<Vertex*>    m_intersections; // pointers of vertex along the line
+        std::vector<HCPoint>    m_source;        // vertices of the polygon to split
+        std::vector<int8_t>     m_sides;         // side of each source vertex (HCSideKernel)
+        std::vector<uint32_t>   m_crossEdges;    // source edges crossing the line
+        std::vector<HCPoint>    m_crossPoints;   // intersection of each crossing edge
+        std::vector<uint8_t>    m_crossInRange;  // intersection within the edge
+        std::vector<Vertex>     m_vertices;      // vertex pool, linked by index
+        std::vector<uint32_t>   m_intersections; // index of vertex along the line
         std::vector<std::pair<HCPoint,HCPoint>> m_edges; //  segments along the line
-        const std::pair<HCPoint,HCPoint>& m_line;
-        std::vector<SplitPoly>  m_collected;
+        std::pair<HCPoint,HCPoint> m_line;
+        std::vector<HCPoint>    m_loopPoints;    // vertices of the collected loops
+        std::vector<SplitLoop>  m_collected;     // ranges in m_loopPoints
         HCPolygons              m_polys;
         bool                    m_isComputed;
 
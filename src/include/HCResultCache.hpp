@@ -0,0 +1,123 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief 64 bits FNV-1a hash of the inputs of a computation
+     */
+    class HCCacheKey
+    {
+    public:
+        /**
+         * @brief hash bytes
+         */
+        HCCacheKey& add(const void* data, size_t n);
+
+        /**
+         * @brief hash the bytes of a value
+         */
+        template <typename T>
+        HCCacheKey& add(const T& value) { return add(&value, sizeof(T)); }
+
+        /**
+         * @brief return the hash of all the bytes added
+         */
+        uint64_t value() const { return m_hash; }
+
+    private:
+        uint64_t    m_hash  { 0xcbf29ce484222325ULL };
+    };
+
+    /**
+     * @brief Persistent cache of computed tables, content addressed: each
+     * table is stored in its own file, named after the hash of everything
+     * it depends on (hull, parameters, options), so a changed input is a
+     * miss and stale entries are never read.
+     *
+     * Entry file (<key>.hcr), little endian:
+     *  - char[8]   magic "HCCACHE\0"
+     *  - uint32    version
+     *  - uint32    crc32 of the values
+     *  - uint64    key
+     *  - uint64    number of values N
+     *  - double    values [N]
+     *
+     * Entries are written in a temporary file then renamed, so concurrent
+     * runs sharing a directory never read a partial entry. Reading an entry
+     * touches it, the least recently used entries are removed when the
+     * directory exceeds its size limit.
+     */
+    class HCResultCache
+    {
+    public:
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint64_t DEFAULT_MAX_SIZE = 256ULL << 20;
+
+        /**
+         * @brief constructor, the directory is created if needed
+         * @param directory where the entries are stored
+         * @param maxSize max size of all the entries in bytes
+         * @throw std::runtime_error if the directory can't be created
+         */
+        HCResultCache(const std::string& directory, uint64_t maxSize = DEFAULT_MAX_SIZE);
+
+        /**
+         * @brief destructor
+         */
+        ~HCResultCache();
+
+        /**
+         * @brief read an entry
+         * @param key the hash of the entry inputs
+         * @param values set to the stored values on a hit
+         * @return false if the entry doesn't exist or is corrupted
+         */
+        bool load(uint64_t key, std::vector<double>& values) const;
+
+        /**
+         * @brief write an entry, then evict the oldest ones if the
+         * size limit is exceeded. Errors are logged, never thrown:
+         * the cache is only an optimization
+         * @param key the hash of the entry inputs
+         * @param values to be stored
+         */
+        void store(uint64_t key, const std::vector<double>& values);
+
+        /**
+         * @brief remove the least recently used entries until the
+         * directory fits in the size limit
+         */
+        void evict();
+
+        /**
+         * @brief return the directory of the entries
+         */
+        const std::string& getDirectory() const;
+
+    private:
+        /**
+         * @brief path of the entry file of a key
+         */
+        std::string getPath(uint64_t key) const;
+
+    private:
+        std::string     m_directory;
+        uint64_t        m_maxSize;
+        std::mutex      m_evictMutex;
+    };
+
+}  // namespace std
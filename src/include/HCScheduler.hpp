@@ -0,0 +1,141 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+
+#pragma once
+// ===== External Includes ===== //
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    class HCMetrics;
+
+    /**
+     * @brief Task scheduler with one deque per thread and work stealing.
+     * Each thread pops its own tasks from the back of its deque (LIFO,
+     * cache friendly) and steals from the front of the others when idle.
+     * The thread calling parallelFor() takes part in the work, so a
+     * scheduler of N threads spawns N-1 workers, and a scheduler of
+     * 1 thread runs everything inline.
+     */
+    class HCScheduler
+    {
+    public:
+        /**
+         * @brief constructor
+         * @param threads total number of threads (0: hardware concurrency)
+         */
+        explicit HCScheduler(unsigned threads);
+
+        /**
+         * @brief destructor, join the workers
+         */
+        ~HCScheduler();
+
+        HCScheduler(const HCScheduler& other) = delete;
+        HCScheduler& operator=(const HCScheduler& other) = delete;
+
+        /**
+         * @brief return the total number of threads, including the caller
+         */
+        unsigned getThreadCount() const;
+
+        /**
+         * @brief run fn on [begin, end) split in chunks of grain items,
+         * and wait for completion. Could be called from inside a task.
+         * @param begin first index
+         * @param end past the last index
+         * @param grain number of indices per task (0: automatic)
+         * @param fn callable receiving a sub range [b, e)
+         * @note the first exception thrown by a task is rethrown here
+         */
+        void parallelFor(size_t begin, size_t end, size_t grain,
+                        const std::function<void(size_t, size_t)>& fn);
+
+    private:
+        struct TaskGroup
+        {
+            std::atomic<size_t>     pending     { 0 };
+            std::exception_ptr      error;
+            std::mutex              errorMutex;
+        };
+
+        struct Task
+        {
+            const std::function<void(size_t, size_t)>* fn;
+            size_t      begin;
+            size_t      end;
+            TaskGroup*  group;
+            HCMetrics*  metrics;    // of the thread queuing the task
+        };
+
+        /**
+         * @brief deque of tasks in a ring buffer, the capacity is kept
+         * so queuing doesn't allocate once warmed up (std::deque frees
+         * and allocates its blocks as the tasks go through)
+         */
+        class TaskDeque
+        {
+        public:
+            bool empty() const { return m_size == 0; }
+            const Task& front() const { return m_ring[m_head]; }
+            const Task& back() const { return m_ring[(m_head + m_size - 1) & (m_ring.size() - 1)]; }
+            void pop_front() { m_head = (m_head + 1) & (m_ring.size() - 1); --m_size; }
+            void pop_back() { --m_size; }
+            void push_back(const Task& task);
+
+        private:
+            std::vector<Task>   m_ring;         // size is a power of 2
+            size_t              m_head  {0};
+            size_t              m_size  {0};
+        };
+
+        struct Worker
+        {
+            TaskDeque           tasks;
+            std::mutex          mutex;
+        };
+
+        /**
+         * @brief worker thread loop
+         * @param index of the worker deque
+         */
+        void workerLoop(unsigned index);
+
+        /**
+         * @brief pop a task from own deque, or steal one from another
+         * @param index of the calling thread deque, or m_workers.size()
+         * for an external thread that only steals
+         * @param task the task found
+         * @return true if a task was found
+         */
+        bool findTask(unsigned index, Task& task);
+
+        /**
+         * @brief execute a task and update its group
+         */
+        void execute(const Task& task);
+
+    private:
+        std::vector<std::unique_ptr<Worker>>    m_workers;
+        std::vector<std::thread>                m_threads;
+        std::atomic<size_t>                     m_queued    { 0 };
+        std::atomic<bool>                       m_stop      { false };
+        std::mutex                              m_sleepMutex;
+        std::condition_variable                 m_wakeUp;
+        std::atomic<unsigned>                   m_nextVictim{ 0 };
+    };
+
+}  // namespace std
@@ -0,0 +1,31 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief properties of one section cut by a waterline,
+     * as required to accumulate the hydrostatic data
+     */
+    struct HCSectionCut
+    {
+        double  area            {0.0};  // wet area
+        double  Mx              {0.0};  // integral of x dA over the wet area
+        double  My              {0.0};  // integral of y dA over the wet area
+        double  chordLength     {0.0};  // length of the waterline inside the section
+        double  chordInertia    {0.0};  // second moment of the waterline chords
+                                        // about the point x = 0 of the waterline
+        bool    dryEmpty        {false};// no part of the section above the waterline
+    };
+
+}  // namespace std
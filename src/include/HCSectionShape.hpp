@@ -0,0 +1,171 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCHalfPlaneClip.hpp"
+#include "HCPoint.hpp"
+#include "HCSectionCut.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief shape of a section, from the cheapest cut to the general one
+     */
+    enum class HCShape : uint8_t
+    {
+        General = 0,    // HCHalfPlaneClip, or the triangles
+        Convex,         // 2 crossings found by binary search
+        Rectangle       // closed form, the sides parallel to the axes
+    };
+
+    /**
+     * @brief Section classified once at load, with the data of the fast
+     * cuts of its shape.
+     *
+     * The signed distance to a waterline of the vertices of a convex
+     * section decreases from its highest vertex to its lowest one, and
+     * increases back, in the ring order. The edge angles being sorted,
+     * the highest and lowest vertices of any waterline are found by
+     * binary search, then the 2 crossed edges on each side. The moments
+     * of the wet vertices are the difference of prefix sums of the
+     * shoelace terms, so the whole cut is O(log n).
+     * The wet part of a rectangle is integrated in closed form, at any
+     * heel.
+     * The vertices are classified with the tolerance and the distance of
+     * HCSideKernel, and the crossings computed by it, so that a fast cut
+     * is the one of HCHalfPlaneClip to the last digits. As there, a
+     * vertex on the waterline (a corner for a rectangle) is reported to
+     * fall back on the general cut.
+     * Every section is also triangulated once (HCPolygon::triangulate,
+     * its corners only), with the moments of each triangle. The vertices
+     * are classified, then each triangle is either wet, its moments
+     * summed, dry, or cut in a triangle or a quadrilateral, the chord
+     * being the segment of the line through it. This cut is only the
+     * fallback of the waterlines through a vertex, the kernels above and
+     * HCHalfPlaneClip leave: it is about twice as slow as the clip, which
+     * streams the vertices once, and stays the cut of every other
+     * waterline.
+     */
+    class HCSectionShape
+    {
+    public:
+        /**
+         * @brief constructor, classify the section
+         * @param vertices of the section, counterclockwise
+         * @param n number of vertices
+         */
+        HCSectionShape(const HCPoint* vertices, size_t n);
+
+        /**
+         * @brief destructor
+         */
+        ~HCSectionShape();
+
+        /**
+         * @brief return the shape of the section
+         */
+        HCShape getShape() const;
+
+        /**
+         * @brief cut the section by the waterline, wet side on the right,
+         * with the kernel of its shape
+         * @tparam Line HCGeneralLine, or HCHorizontalLine if the waterline
+         * is horizontal and oriented towards the positive x
+         * @param vertices the ones of the constructor
+         * @param line the waterline
+         * @param wl the waterline height at x=0, reference of the chord inertia
+         * @param cut the properties of the wet part
+         * @return false for a general section, or a vertex on the line,
+         * cut is then meaningless
+         */
+        template<typename Line = HCGeneralLine>
+        bool cut(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                double wl, HCSectionCut& cut) const;
+
+        /**
+         * @brief cut the triangles of the section by the waterline, only
+         * the fallback of the waterlines through a vertex the kernels and
+         * HCHalfPlaneClip leave
+         * @tparam Line as cut()
+         * @param vertices the ones of the constructor
+         * @param line the waterline
+         * @param wl the waterline height at x=0, reference of the chord inertia
+         * @param cut the properties of the wet part
+         * @return false if the waterline crosses the section more than
+         * twice, left to HCPolygonSplitter for the inertia of its chords,
+         * cut is then meaningless
+         */
+        template<typename Line = HCGeneralLine>
+        bool cutTriangles(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                        double wl, HCSectionCut& cut) const;
+
+        /**
+         * @brief return the shape of a section
+         * @param vertices of the section, counterclockwise
+         * @param n number of vertices
+         */
+        static HCShape classify(const HCPoint* vertices, size_t n);
+
+    private:
+        /**
+         * @brief cut a rectangle in closed form, for a waterline oriented
+         * towards the positive x (wet side below)
+         */
+        template<typename Line>
+        bool cutRectangle(const std::pair<HCPoint,HCPoint>& line, double wl,
+                        HCSectionCut& cut) const;
+
+        /**
+         * @brief cut a convex section with 2 binary searches
+         */
+        template<typename Line>
+        bool cutConvex(const HCPoint* vertices, const std::pair<HCPoint,HCPoint>& line,
+                        double wl, HCSectionCut& cut) const;
+
+        /**
+         * @brief first vertex whose edge has an angle not below the given
+         * one: the lowest vertex for a waterline of this direction
+         * @param angle of the waterline, radians
+         */
+        size_t extremeVertex(double angle) const;
+
+        /**
+         * @brief shoelace sums of the edges before a vertex
+         */
+        struct Sums
+        {
+            double  area    {0.0};  // 2 A
+            double  Mx      {0.0};  // 6 integral of x dA
+            double  My      {0.0};  // 6 integral of y dA
+        };
+
+    private:
+        HCShape             m_shape     {HCShape::General};
+        size_t              m_n         {0};
+        double              m_xMin      {0.0};  // bounding box
+        double              m_xMax      {0.0};
+        double              m_yMin      {0.0};
+        double              m_yMax      {0.0};
+        size_t              m_lowest    {0};    // vertices of min and max y
+        size_t              m_highest   {0};
+        size_t              m_firstEdge {0};    // edge of the min angle
+        std::vector<double> m_angles;           // from m_firstEdge, increasing
+        std::vector<Sums>   m_sums;             // prefix sums, n + 1
+        std::vector<std::array<uint32_t, 3>> m_triangles;  // of the corners, counterclockwise
+        std::vector<Sums>   m_triangleSums;     // shoelace sums of each triangle
+        std::vector<uint8_t> m_outline;         // bit j: edge j of the triangle on the outline
+    };
+
+}  // namespace std
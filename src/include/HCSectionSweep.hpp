@@ -0,0 +1,107 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCPoint.hpp"
+#include "HCSectionCut.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Sweep of a section by a family of parallel waterlines.
+     * With u along the waterline and v along its normal, the wet area,
+     * its moments and the waterline chords are piecewise polynomials of
+     * the waterline offset v = c, the breakpoints being the vertices.
+     * The vertices are sorted once along v, and the integrals carried
+     * from one breakpoint to the next, so any offset is then answered
+     * exactly by evaluating the polynomial of its piece.
+     */
+    class HCSectionSweep
+    {
+    public:
+        /**
+         * @brief constructor
+         * @param vertices of the section, counterclockwise
+         * @param n number of vertices
+         * @param direction of the waterlines (from the first to the second point)
+         */
+        HCSectionSweep(const HCPoint* vertices, size_t n, const HCPoint& direction);
+
+        /**
+         * @brief destructor
+         */
+        ~HCSectionSweep();
+
+        /**
+         * @brief offset of a point along the waterline normal
+         * @param M the point
+         * @return the offset v, the waterline through M is v = offset(M)
+         */
+        double offset(const HCPoint& M) const;
+
+        /**
+         * @brief abscissa of a point along the waterline direction
+         * @param M the point
+         */
+        double abscissa(const HCPoint& M) const;
+
+        /**
+         * @brief cut the section by the waterline v = c, the wet side
+         * being v < c (right side of the waterline)
+         * @param c offset of the waterline
+         * @param u0 abscissa of the reference point of the chord inertia
+         * @param tolerance offset below which a vertex is considered on
+         * the waterline, to flag the dry side as empty
+         * @return the properties of the wet part
+         */
+        HCSectionCut cut(double c, double u0, double tolerance) const;
+
+        /**
+         * @brief return the lowest offset of the section
+         */
+        double getMinOffset() const;
+
+        /**
+         * @brief return the highest offset of the section
+         */
+        double getMaxOffset() const;
+
+    private:
+        /**
+         * @brief state at a breakpoint, and sums over the edges crossing
+         * the piece, u being the edge abscissa at the breakpoint and k
+         * its slope du/dv, signed with the edge orientation
+         */
+        struct Piece
+        {
+            double  t       {0.0};  // breakpoint offset
+            double  A       {0.0};  // area below t
+            double  Mu      {0.0};  // integral of u dA below t
+            double  Mv      {0.0};  // integral of v dA below t
+            double  su      {0.0};
+            double  sk      {0.0};
+            double  suu     {0.0};
+            double  suk     {0.0};
+            double  skk     {0.0};
+            double  suuu    {0.0};
+            double  suuk    {0.0};
+            double  sukk    {0.0};
+            double  skkk    {0.0};
+        };
+
+    private:
+        HCPoint             m_dir;      // waterline direction (unit)
+        HCPoint             m_normal;   // normal, pointing to the dry side
+        std::vector<Piece>  m_pieces;   // sorted by offset
+    };
+
+}  // namespace std
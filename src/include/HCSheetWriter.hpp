@@ -0,0 +1,142 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+// ===== HydroCpp Includes ===== //
+#include "HCScheduler.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Streaming writer of numeric rows into the sheets of a saved
+     * xlsx workbook.
+     * The workbook is first laid out with OpenXLSX (sheets, header rows,
+     * tables), then this class rewrites the archive: the untouched entries
+     * are copied as they are, still compressed, and the XML of the
+     * registered sheets is generated from the numeric columns, block of
+     * rows by block of rows, formatted and compressed in parallel.
+     * Memory is bounded by a few blocks per thread, whatever the size
+     * of the tables.
+     */
+    class HCSheetWriter
+    {
+    public:
+        /**
+         * @brief number of rows formatted and compressed by a task
+         */
+        static constexpr size_t ROWS_PER_BLOCK = 1024;
+
+        /**
+         * @brief constructor
+         * @param filename the xlsx file, rewritten in place by write()
+         */
+        explicit HCSheetWriter(const std::string& filename);
+
+        /**
+         * @brief destructor
+         */
+        ~HCSheetWriter();
+
+        /**
+         * @brief register the rows of a sheet, appended after its
+         * existing rows (usually the header). The values equal to
+         * HCCurves::NOT_AVAILABLE, or not finite, are left empty.
+         * @param sheetName the sheet, shall exist in the workbook
+         * @param columns the values column by column, all of the same size
+         * @param firstRow the row number of the first value
+         */
+        void addSheet(const std::string& sheetName,
+                    std::vector<std::vector<double>> columns, uint32_t firstRow = 2);
+
+        /**
+         * @brief rewrite the workbook with the rows of the registered sheets
+         * @param scheduler to format the blocks in parallel, may be null
+         * @throw std::runtime_error if the archive can't be read or written,
+         * or needs zip64 records (4 GiB or more, in an entry or the
+         * archive), which are not written: the workbook is then left as is
+         */
+        void write(HCScheduler* scheduler = nullptr);
+
+    private:
+        /**
+         * @brief entry of the zip central directory
+         */
+        struct Entry
+        {
+            uint16_t    versionMadeBy   {0};
+            uint16_t    versionNeeded   {0};
+            uint16_t    flags           {0};
+            uint16_t    method          {0};
+            uint16_t    time            {0};
+            uint16_t    date            {0};
+            uint32_t    crc             {0};
+            uint32_t    compressedSize  {0};
+            uint32_t    size            {0};
+            uint16_t    internalAttr    {0};
+            uint32_t    externalAttr    {0};
+            uint32_t    offset          {0};
+            std::string name;
+            std::string comment;
+        };
+
+        struct Sheet
+        {
+            std::string                         name;
+            std::string                         path;       // entry in the archive
+            std::vector<std::vector<double>>    columns;
+            uint32_t                            firstRow;
+        };
+
+        /**
+         * @brief read the central directory of the archive
+         */
+        void readDirectory(std::ifstream& in);
+
+        /**
+         * @brief read and decompress an entry
+         */
+        std::string readEntry(std::ifstream& in, const Entry& e) const;
+
+        /**
+         * @brief find the entries of the registered sheets, from the
+         * workbook and its relationships
+         */
+        void resolveSheets(std::ifstream& in);
+
+        /**
+         * @brief copy an entry without decompressing it
+         * @return the entry with its new offset
+         */
+        Entry copyEntry(std::ifstream& in, std::ofstream& out, const Entry& e) const;
+
+        /**
+         * @brief write the entry of a sheet, its original XML around the
+         * generated rows
+         * @return the entry with its new offset, sizes and CRC
+         */
+        Entry writeSheet(std::ifstream& in, std::ofstream& out, const Entry& e,
+                        const Sheet& sheet, HCScheduler* scheduler) const;
+
+        /**
+         * @brief format the rows [begin, end) of a sheet
+         */
+        static void formatRows(const Sheet& sheet, size_t begin, size_t end, std::string& xml);
+
+    private:
+        std::string             m_filename;
+        std::vector<Entry>      m_entries;
+        std::vector<Sheet>      m_sheets;
+    };
+
+}  // namespace std
@@ -0,0 +1,161 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+// ===== HydroCpp Includes ===== //
+#include "HCPoint.hpp"
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief instruction sets of the kernels, by increasing width
+     */
+    enum class HCIsa
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * @brief Bulk kernels classifying the vertices of a section against
+     * a waterline and computing the crossing points. The vectorised
+     * variants are compiled for their target only, and the best one
+     * supported by the CPU is selected at run time, so a single static
+     * binary runs everywhere. All the variants give the same results,
+     * bit for bit, as the scalar one (same operations, no contraction).
+     * The single precision kernels (HCPointF) compute in float, with
+     * twice the lanes per instruction.
+     */
+    class HCSideKernel
+    {
+    public:
+        static constexpr uint32_t HAS_RIGHT = 1;    // some vertex on the right (wet)
+        static constexpr uint32_t HAS_LEFT  = 2;    // some vertex on the left (dry)
+        static constexpr uint32_t HAS_ON    = 4;    // some vertex on the line
+
+        /**
+         * @brief classify the vertices against the line, as
+         * HCPolygonSplitter::getSide (on the line below 1e-8)
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         * @param line the oriented line
+         * @param sides output, for each vertex 1 right, -1 left, 0 on the line
+         * @return the union of HAS_RIGHT, HAS_LEFT, HAS_ON
+         */
+        static uint32_t classify(const HCPoint* vertices, size_t n,
+                                const std::pair<HCPoint,HCPoint>& line, int8_t* sides);
+
+        /**
+         * @brief compute the intersection of the line with some edges
+         * of the polygon, as HCPolygonSplitter::intersection
+         * @param vertices pointer to the first vertex
+         * @param n number of vertices
+         * @param edges index of the first vertex of each edge
+         * @param count number of edges
+         * @param line the line
+         * @param points output, the intersection points, (0,0) for an
+         * edge parallel to the line
+         * @param inRange optional output, 1 if the intersection lies
+         * in the edge and in the line segment, 0 otherwise
+         * @return the number of edges parallel to the line
+         */
+        static size_t intersect(const HCPoint* vertices, size_t n,
+                                const uint32_t* edges, size_t count,
+                                const std::pair<HCPoint,HCPoint>& line,
+                                HCPoint* points, uint8_t* inRange = nullptr);
+
+        /**
+         * @brief classify single precision vertices, as above, the
+         * distance being computed in float
+         */
+        static uint32_t classify(const HCPointF* vertices, size_t n,
+                                const std::pair<HCPointF,HCPointF>& line, int8_t* sides);
+
+        /**
+         * @brief compute the intersections of single precision vertices,
+         * as above, in float
+         */
+        static size_t intersect(const HCPointF* vertices, size_t n,
+                                const uint32_t* edges, size_t count,
+                                const std::pair<HCPointF,HCPointF>& line,
+                                HCPointF* points, uint8_t* inRange = nullptr);
+
+        /**
+         * @brief classify the vertices against a horizontal line, oriented
+         * towards the positive x: the vertices below are on the right.
+         * Each vertex costs a comparison of its y, the tolerance being
+         * scaled so that the sides are the ones of classify
+         */
+        static uint32_t classifyHorizontal(const HCPoint* vertices, size_t n,
+                                const std::pair<HCPoint,HCPoint>& line, int8_t* sides);
+
+        /**
+         * @brief classify single precision vertices against a horizontal line
+         */
+        static uint32_t classifyHorizontal(const HCPointF* vertices, size_t n,
+                                const std::pair<HCPointF,HCPointF>& line, int8_t* sides);
+
+        /**
+         * @brief compute the intersections of a horizontal line with some
+         * edges, as intersect: one interpolation of x per edge, the points
+         * being on the line exactly
+         */
+        static size_t intersectHorizontal(const HCPoint* vertices, size_t n,
+                                const uint32_t* edges, size_t count,
+                                const std::pair<HCPoint,HCPoint>& line,
+                                HCPoint* points, uint8_t* inRange = nullptr);
+
+        /**
+         * @brief compute the intersections of single precision vertices
+         * with a horizontal line
+         */
+        static size_t intersectHorizontal(const HCPointF* vertices, size_t n,
+                                const uint32_t* edges, size_t count,
+                                const std::pair<HCPointF,HCPointF>& line,
+                                HCPointF* points, uint8_t* inRange = nullptr);
+
+        /**
+         * @brief return the instruction set in use
+         */
+        static HCIsa getIsa();
+
+        /**
+         * @brief return the widest instruction set supported by the CPU
+         * (and by the compiler)
+         */
+        static HCIsa getSupportedIsa();
+
+        /**
+         * @brief force the instruction set, limited to the supported one
+         * @param isa the requested instruction set
+         * @return the instruction set in use
+         */
+        static HCIsa setIsa(HCIsa isa);
+
+        /**
+         * @brief name of an instruction set
+         */
+        static const char* getIsaName(HCIsa isa);
+
+        /**
+         * @brief parse an instruction set name (scalar, sse2, avx2, avx512)
+         * @param name
+         * @param isa output
+         * @return false if the name is unknown
+         */
+        static bool parseIsa(const std::string& name, HCIsa& isa);
+    };
+
+}  // namespace std
@@ -0,0 +1,243 @@
+/*
+  HydroCpp
+  Repository: https://github.com/akira215/HydroCpp
+  License: GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+  Author: Akira Shimahara
+*/
+#pragma once
+
+// ===== External Includes ===== //
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+// ===== HydroCpp Includes ===== //
+
+
+namespace HydroCpp
+{
+    /**
+     * @brief Vector storing up to N elements inline, in the object
+     * itself. Beyond, the elements are moved to a buffer of the memory
+     * resource (the default one, i.e. the heap, unless given).
+     * Only the operations used on vertex rings are provided.
+     */
+    template <typename T, size_t N>
+    class HCSmallVector
+    {
+    public:
+        using value_type        = T;
+        using iterator          = T*;
+        using const_iterator    = const T*;
+
+        /**
+         * @brief constructor, empty
+         * @param resource where the elements go beyond N
+         */
+        explicit HCSmallVector(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_resource(resource)
+        { }
+
+        /**
+         * @brief constructor, copy of a range
+         */
+        HCSmallVector(const T* first, const T* last,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_resource(resource)
+        {
+            assign(first, last);
+        }
+
+        /**
+         * @brief destructor
+         */
+        ~HCSmallVector()
+        {
+            clear();
+            release();
+        }
+
+        /**
+         * @brief Copy constructor, on the default resource as the
+         * std::pmr containers: the copy may outlive the arena scope
+         * of other
+         */
+        HCSmallVector(const HCSmallVector& other)
+            : m_resource(std::pmr::get_default_resource())
+        {
+            assign(other.begin(), other.end());
+        }
+
+        /**
+         * @brief Move constructor, the buffer of other is taken if it
+         * is not inline
+         */
+        HCSmallVector(HCSmallVector&& other) noexcept
+            : m_resource(other.m_resource)
+        {
+            steal(other);
+        }
+
+        /**
+         * @brief Copy assignment operator, the resource is kept
+         */
+        HCSmallVector& operator=(const HCSmallVector& other)
+        {
+            if (&other != this)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment operator, the buffer of other is
+         * taken if it is not inline and from the same resource
+         */
+        HCSmallVector& operator=(HCSmallVector&& other) noexcept
+        {
+            if (&other != this) {
+                clear();
+                release();
+                if (other.isInline() || *m_resource == *other.m_resource) {
+                    steal(other);
+                } else {
+                    assign(other.begin(), other.end());
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * @brief replace the content by a copy of a range
+         */
+        void assign(const T* first, const T* last)
+        {
+            clear();
+            reserve(static_cast<size_t>(last - first));
+            std::uninitialized_copy(first, last, m_data);
+            m_size = static_cast<size_t>(last - first);
+        }
+
+        /**
+         * @brief make room for n elements
+         */
+        void reserve(size_t n)
+        {
+            if (n <= m_capacity)
+                return;
+            T* data = static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+            for (size_t i = 0; i < m_size; ++i) {
+                ::new (static_cast<void*>(data + i)) T(std::move(m_data[i]));
+                m_data[i].~T();
+            }
+            release();
+            m_data = data;
+            m_capacity = n;
+        }
+
+        void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if (m_size == m_capacity) {
+                // args may refer to an element, built before moving them
+                T value(std::forward<Args>(args)...);
+                reserve(2 * m_capacity);
+                return *::new (static_cast<void*>(m_data + m_size++)) T(std::move(value));
+            }
+            return *::new (static_cast<void*>(m_data + m_size++)) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief remove the elements, the capacity is kept
+         */
+        void clear()
+        {
+            for (size_t i = 0; i < m_size; ++i)
+                m_data[i].~T();
+            m_size = 0;
+        }
+
+        /**
+         * @brief return true if the elements are stored in the object
+         */
+        bool isInline() const { return m_data == inlineData(); }
+
+        T* data() { return m_data; }
+        const T* data() const { return m_data; }
+        size_t size() const { return m_size; }
+        size_t capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+
+        iterator begin() { return m_data; }
+        iterator end() { return m_data + m_size; }
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+        T& operator[](size_t i) { return m_data[i]; }
+        const T& operator[](size_t i) const { return m_data[i]; }
+
+        const T& at(size_t i) const
+        {
+            if (i >= m_size)
+                throw std::out_of_range("HCSmallVector::at");
+            return m_data[i];
+        }
+
+        T& front() { return m_data[0]; }
+        const T& front() const { return m_data[0]; }
+        T& back() { return m_data[m_size - 1]; }
+        const T& back() const { return m_data[m_size - 1]; }
+
+    private:
+        T* inlineData() { return reinterpret_cast<T*>(m_inline); }
+        const T* inlineData() const { return reinterpret_cast<const T*>(m_inline); }
+
+        /**
+         * @brief give back the buffer if not inline, the elements
+         * shall be destroyed
+         */
+        void release()
+        {
+            if (!isInline())
+                m_resource->deallocate(m_data, m_capacity * sizeof(T), alignof(T));
+            m_data = inlineData();
+            m_capacity = N;
+        }
+
+        /**
+         * @brief take the elements of other, this shall be empty and
+         * inline, other is left empty
+         */
+        void steal(HCSmallVector& other)
+        {
+            if (other.isInline()) {
+                for (size_t i = 0; i < other.m_size; ++i)
+                    ::new (static_cast<void*>(m_data + i)) T(std::move(other.m_data[i]));
+                m_size = other.m_size;
+                other.clear();
+            } else {
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.m_data = other.inlineData();
+                other.m_size = 0;
+                other.m_capacity = N;
+            }
+        }
+
+    private:
+        alignas(T) unsigned char        m_inline[N * sizeof(T)];
+        T*                              m_data      { inlineData() };
+        size_t                          m_size      { 0 };
+        size_t                          m_capacity  { N };
+        std::pmr::memory_resource*      m_resource;
+    };
+
+}  // namespace std
@@ -11,6 +11,13 @@
 #include <stdlib.h>
 #include <string>
 #include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <limits>
 
 // ===== External Includes ===== //
 #include <OpenXLSX.hpp>
@@ -21,6 +28,10 @@
 #include "HCLog.hpp"
 #include "HCConfig.hpp"
 #include "HCLoader.hpp"
+#include "HCBatch.hpp"
+#include "HCParams.hpp"
+#include "HCResultCache.hpp"
+#include "HCSideKernel.hpp"
 
 // ===== Config Includes ===== //
 #include "HydroCppConfig.h"
@@ -30,16 +41,192 @@ using namespace std;
 using namespace OpenXLSX;
 using namespace HydroCpp;
 
-int main() {
-    HCLogInfo("HydroCpp (c) v" + to_string(HydroCpp_VERSION_MAJOR) + "." 
-                + to_string(HydroCpp_VERSION_MINOR) + "."
-                + to_string(HydroCpp_VERSION_PATCH) + " Akira Corp." );
-    HCLogInfo(std::string("Workbook shall contain the hull hydro data in a table named \"") + HULL_TBL_NAME +"\"" );
-    HCLogInfo("All data shall be x: longitudinal forward y: transveral starboard z: vertical upward" );
-    HCLogInfo("x=0: aft perpendicular y=0: centerline z=0: keel" );
-    HCLogInfo("==========" );
-    HCLogInfo("Additional named range could be provided: max_wl, Δwl, φMax, Δφ, ρsw" );
-    
+static void printUsage()
+{
+    HCLogInfo("Usage: HydroCpp [options] [files...]");
+    HCLogInfo("  Without file, an open file dialog is displayed");
+    HCLogInfo("  files            workbooks, CSV (.csv) or binary (.hcb) hulls to process,");
+    HCLogInfo("                   wildcards * and ? are accepted");
+    HCLogInfo("  -                read the list of workbooks from stdin (one per line)");
+    HCLogInfo("  -j, --jobs N     number of files computed concurrently (default: all cores)");
+    HCLogInfo("  -t, --threads N  number of threads computing the tables of one file (default: 1)");
+    HCLogInfo("  --section-grain N split each waterline in chunks of N sections computed in parallel");
+    HCLogInfo("  --sweep          compute the waterline families with section sweeps");
+    HCLogInfo("  --direct-kn      solve the KN at each displacement of the table, no interpolation");
+    HCLogInfo("  --adaptive TOL   compute the hydrostatic table with adaptive waterline steps,");
+    HCLogInfo("                   TOL the relative error allowed on the volume and the KMT");
+    HCLogInfo("  --float          cut the sections with single precision vertices, the sums");
+    HCLogInfo("                   staying in double");
+    HCLogInfo("  --general-clip   cut every section with the general clip, not the closed form");
+    HCLogInfo("                   or binary search kernel of its shape (rectangle, convex)");
+    HCLogInfo("  --condition D,LCG,TCG,VCG  solve the free floating position (draught, trim,");
+    HCLogInfo("                   heel) of a loading condition, displacement in t, centre of");
+    HCLogInfo("                   gravity in m, may be repeated");
+    HCLogInfo("  --isa NAME       instruction set of the section kernels: scalar, sse2, avx2,");
+    HCLogInfo("                   avx512 (default: the widest supported, sse2 excepted)");
+    HCLogInfo("  -p, --param NAME=VALUE  set a parameter (max_wl, delta_wl, phi_max, delta_phi,");
+    HCLogInfo("                   max_disp, delta_disp, rho_sw), over the file ones");
+    HCLogInfo("  --params FILE    read the parameters of all the files in FILE");
+    HCLogInfo("  -o, --output PATH  workbook to write the results in, or directory");
+    HCLogInfo("                   (default: the input workbook, or the hull file as .xlsx)");
+    HCLogInfo("  --export-hull PATH  save the hull in the binary format (.hcb), or directory");
+    HCLogInfo("  --cache DIR      cache the computed tables in DIR, reused when the hull,");
+    HCLogInfo("                   the parameters and the options are unchanged");
+    HCLogInfo("  --cache-size MB  max size of the cache, least recently used tables are");
+    HCLogInfo("                   removed beyond (default: 256)");
+    HCLogInfo("  --metrics        write the time of each phase and the hot path counters");
+    HCLogInfo("                   in <output>.metrics.json");
+    HCLogInfo("  --scaling        report the computation time of each file from 1 to N threads");
+    HCLogInfo("  -h, --help       display this help");
+}
+
+/**
+ * @brief path of an output file: the option itself, or a file named
+ * after the input in the option directory
+ */
+static string resolvePath(const string& option, const string& input, const string& extension)
+{
+    filesystem::path p(option);
+    if (filesystem::is_directory(p))
+        return (p / filesystem::path(input).filename().replace_extension(extension)).string();
+    return option;
+}
+
+/**
+ * @brief unsigned integer value of an option
+ * @param max largest value accepted
+ * @return false if the value is not a number, or above max
+ */
+static bool parseUnsigned(const string& value, uint64_t max, uint64_t& result)
+{
+    // stoull accepts a sign, and wraps the negative values
+    if (value.empty() || value.find('-') != string::npos)
+        return false;
+    try {
+        size_t used = 0;
+        unsigned long long v = stoull(value, &used);
+        if (used != value.size() || v > max)
+            return false;
+        result = v;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief positive or zero real value of an option
+ * @return false if the value is not a finite number, or negative
+ */
+static bool parsePositive(const string& value, double& result)
+{
+    try {
+        size_t used = 0;
+        double v = stod(value, &used);
+        if (used != value.size() || !std::isfinite(v) || v < 0)
+            return false;
+        result = v;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief loading condition from "displacement,LCG,TCG,VCG"
+ * @return false if the value is not 4 numbers
+ */
+static bool parseCondition(const string& value, HCLoadCondition& condition)
+{
+    double v[4];
+    size_t pos = 0;
+    for (int k = 0; k < 4; ++k) {
+        size_t end = k < 3 ? value.find(',', pos) : value.size();
+        if (end == string::npos)
+            return false;
+        try {
+            size_t used = 0;
+            v[k] = stod(value.substr(pos, end - pos), &used);
+            if (used != end - pos)
+                return false;
+        } catch (const std::exception&) {
+            return false;
+        }
+        pos = end + 1;
+    }
+    condition = { v[0], v[1], v[2], v[3] };
+    return true;
+}
+
+/**
+ * @brief solve the loading conditions of a hull and log the positions
+ */
+static void logEquilibrium(HCLoader& ld, const vector<HCLoadCondition>& conditions)
+{
+    vector<HCFloatingPosition> positions = ld.solveEquilibrium(conditions);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const HCLoadCondition& c = conditions[i];
+        const HCFloatingPosition& p = positions[i];
+        char line[256];
+        if (!p.converged) {
+            snprintf(line, sizeof(line), "%s: no equilibrium found for %.3f t (G %.3f, %.3f, %.3f)",
+                        ld.getFilename().c_str(), c.displacement, c.LCG, c.TCG, c.VCG);
+            HCLogError(std::string(line));
+            continue;
+        }
+        snprintf(line, sizeof(line), "%s: %.3f t (G %.3f, %.3f, %.3f): draught %.4f m "
+                    "(aft %.4f, fore %.4f), trim %.4f deg, heel %.4f deg, GMT %.4f m, GML %.3f m",
+                    ld.getFilename().c_str(), c.displacement, c.LCG, c.TCG, c.VCG,
+                    p.draught, p.draughtAft, p.draughtFore, p.trim, p.heel, p.GMT, p.GML);
+        HCLogInfo(std::string(line));
+        if (p.submerged)
+            HCLogInfo(ld.getFilename() + ": a section is under the waterplane");
+    }
+}
+
+static bool runScaling(const string& file, unsigned maxThreads,
+                        const function<void(HCLoader&)>& setup)
+{
+    if (maxThreads == 0)
+        maxThreads = std::max(1u, thread::hardware_concurrency());
+
+    HCLogInfo("Scaling report for " + file);
+    try {
+        HCLoader ld(file);
+        setup(ld);
+        ld.setCache(nullptr); // each run computes
+
+        // 1, 2, 4, ... and maxThreads
+        vector<unsigned> counts;
+        for (unsigned t = 1; t < maxThreads; t *= 2)
+            counts.push_back(t);
+        counts.push_back(maxThreads);
+
+        double reference = 0.0;
+        for (unsigned t : counts) {
+            ld.setThreadCount(t);
+            auto tstart = chrono::steady_clock::now();
+            ld.computeHydroTable();
+            ld.computeKNdatas();
+            auto tstop = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(tstop - tstart).count();
+            if (t == 1)
+                reference = ms;
+
+            char line[128];
+            snprintf(line, sizeof(line), "threads %3u : %10.1f ms  speedup %5.2f  efficiency %5.1f %%",
+                        t, ms, reference / ms, 100.0 * reference / ms / t);
+            HCLogInfo(std::string(line));
+        }
+    } catch (const std::exception& e) {
+        HCLogError(file + " : FAILED (" + e.what() + ")");
+        return false;
+    }
+    return true;
+}
+
+static int runDialog()
+{
     // initialize NFD
     NFD::Guard nfdGuard;
 
@@ -47,14 +234,15 @@ int main() {
     NFD::UniquePath outPath;
 
     // prepare filters for the dialog
-    nfdfilteritem_t filterItem[1] = { {"Excel file", "xls,xlsx"} };
+    nfdfilteritem_t filterItem[2] = { {"Excel file", "xls,xlsx"}, {"Hull file", "csv,hcb"} };
 
     // show the dialog
-    nfdresult_t result = NFD::OpenDialog(outPath, filterItem, 1);
+    nfdresult_t result = NFD::OpenDialog(outPath, filterItem, 2);
     if (result == NFD_OKAY) {
         string file = string(outPath.get());
         HCLogInfo("Opening the file " + file + "..." );
         HCLoader ld(file);
+        ld.setThreadCount(0);
 
         auto tstart = chrono::high_resolution_clock::now();
         
@@ -65,7 +253,7 @@ int main() {
         auto tstop = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(tstop - tstart);
         HCLogInfo("Computation done in " + to_string(duration.count()) + " ms" );
-        HCLogInfo("Data saved in the file " + file);
+        HCLogInfo("Data saved in the file " + ld.getOutput());
 
     } else if (result == NFD_CANCEL)
         HCLogInfo("No file was selected, user pressed cancel.");
@@ -75,4 +263,210 @@ int main() {
     // NFD::Guard will automatically quit NFD.
 
     return 0;
+}
+
+int main(int argc, char* argv[]) {
+    HCLogInfo("HydroCpp (c) v" + to_string(HydroCpp_VERSION_MAJOR) + "." 
+                + to_string(HydroCpp_VERSION_MINOR) + "."
+                + to_string(HydroCpp_VERSION_PATCH) + " Akira Corp." );
+    HCLogInfo(std::string("Workbook shall contain the hull hydro data in a table named \"") + HULL_TBL_NAME +"\"" );
+    HCLogInfo("All data shall be x: longitudinal forward y: transveral starboard z: vertical upward" );
+    HCLogInfo("x=0: aft perpendicular y=0: centerline z=0: keel" );
+    HCLogInfo("==========" );
+    HCLogInfo("Additional named range could be provided: max_wl, Δwl, φMax, Δφ, ρsw" );
+    HCLogInfo("Hulls could also be given as CSV (.csv) or binary (.hcb) files, with a .params sidecar" );
+
+    // No argument: interactive mode
+    if (argc < 2)
+        return runDialog();
+
+    // Headless mode
+    vector<string> files;
+    unsigned jobs = 0;
+    unsigned threads = 1;
+    size_t sectionGrain = 0;
+    bool sweep = false;
+    bool directKN = false;
+    double adaptiveTol = 0.0;
+    HCScalar scalar = HCScalar::Double;
+    bool shapeKernels = true;
+    vector<HCLoadCondition> conditions;
+    bool scaling = false;
+    bool metrics = false;
+    HCParams params;        // --params files, in order
+    HCParams cliParams;     // -p, over the files
+    string output;
+    string exportHull;
+    string cacheDir;
+    uint64_t cacheSize = HCResultCache::DEFAULT_MAX_SIZE;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (arg == "-j" || arg == "--jobs" || arg == "-t" || arg == "--threads") {
+            uint64_t value;
+            if (i + 1 >= argc || !parseUnsigned(argv[i + 1], numeric_limits<unsigned>::max(), value)) {
+                HCLogError("Missing or invalid value for " + arg);
+                printUsage();
+                return 1;
+            }
+            ++i;
+            if (arg == "-j" || arg == "--jobs")
+                jobs = static_cast<unsigned>(value);
+            else
+                threads = static_cast<unsigned>(value);
+        } else if (arg == "--section-grain") {
+            uint64_t value;
+            if (i + 1 >= argc || !parseUnsigned(argv[i + 1], numeric_limits<size_t>::max(), value)) {
+                HCLogError("Missing or invalid value for " + arg);
+                printUsage();
+                return 1;
+            }
+            ++i;
+            sectionGrain = static_cast<size_t>(value);
+        } else if (arg == "--sweep") {
+            sweep = true;
+        } else if (arg == "--direct-kn") {
+            directKN = true;
+        } else if (arg == "--adaptive") {
+            if (i + 1 >= argc || !parsePositive(argv[i + 1], adaptiveTol)) {
+                HCLogError("Missing or invalid value for " + arg);
+                printUsage();
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--float") {
+            scalar = HCScalar::Float;
+        } else if (arg == "--general-clip") {
+            shapeKernels = false;
+        } else if (arg == "--condition") {
+            HCLoadCondition condition;
+            if (i + 1 >= argc || !parseCondition(argv[i + 1], condition)) {
+                HCLogError("Missing or invalid value for " + arg);
+                return 1;
+            }
+            conditions.push_back(condition);
+            ++i;
+        } else if (arg == "--isa") {
+            HCIsa isa;
+            if (i + 1 >= argc || !HCSideKernel::parseIsa(argv[i + 1], isa)) {
+                HCLogError("Missing or unknown value for " + arg);
+                return 1;
+            }
+            ++i;
+            HCIsa used = HCSideKernel::setIsa(isa);
+            if (used != isa)
+                HCLogInfo(string("Instruction set not supported, using ")
+                            + HCSideKernel::getIsaName(used));
+        } else if (arg == "-p" || arg == "--param") {
+            if (i + 1 >= argc || !cliParams.parse(argv[i + 1])) {
+                HCLogError("Missing or invalid value for " + arg);
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--cache-size") {
+            // In MB, the bytes shall not overflow
+            uint64_t value;
+            if (i + 1 >= argc || !parseUnsigned(argv[i + 1], numeric_limits<uint64_t>::max() >> 20, value)) {
+                HCLogError("Missing or invalid value for " + arg);
+                printUsage();
+                return 1;
+            }
+            ++i;
+            cacheSize = value << 20;
+        } else if (arg == "--params" || arg == "-o" || arg == "--output"
+                    || arg == "--export-hull" || arg == "--cache") {
+            if (i + 1 >= argc) {
+                HCLogError("Missing value for " + arg);
+                return 1;
+            }
+            string value = argv[++i];
+            if (arg == "--params") {
+                try {
+                    params.readFile(value);
+                } catch (const std::exception& e) {
+                    HCLogError(e.what());
+                    return 1;
+                }
+            } else if (arg == "--export-hull")
+                exportHull = value;
+            else if (arg == "--cache")
+                cacheDir = value;
+            else
+                output = value;
+        } else if (arg == "--metrics") {
+            metrics = true;
+        } else if (arg == "--scaling") {
+            scaling = true;
+        } else if (arg == "-") {
+            auto manifest = HCBatch::readManifest(cin);
+            files.insert(files.end(), manifest.begin(), manifest.end());
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            HCLogError("Unknown option " + arg);
+            printUsage();
+            return 1;
+        } else {
+            auto expanded = HCBatch::expandPattern(arg);
+            if (expanded.empty())
+                HCLogError("No file matching " + arg);
+            files.insert(files.end(), expanded.begin(), expanded.end());
+        }
+    }
+
+    if (files.empty()) {
+        HCLogError("No file to process");
+        return 1;
+    }
+
+    params.merge(cliParams);
+
+    for (const string* path : { &output, &exportHull }) {
+        if (!path->empty() && files.size() > 1 && !filesystem::is_directory(*path)) {
+            HCLogError(*path + " shall be a directory to process several files");
+            return 1;
+        }
+    }
+
+    shared_ptr<HCResultCache> cache;
+    if (!cacheDir.empty()) {
+        try {
+            cache = make_shared<HCResultCache>(cacheDir, cacheSize);
+        } catch (const std::exception& e) {
+            HCLogError(e.what());
+            return 1;
+        }
+    }
+
+    auto setup = [&](HCLoader& ld){
+        ld.setThreadCount(threads);
+        ld.setSectionGrain(sectionGrain);
+        ld.setSweepMode(sweep);
+        ld.setDirectKN(directKN);
+        ld.setAdaptiveTolerance(adaptiveTol);
+        ld.setScalar(scalar);
+        ld.setShapeKernels(shapeKernels);
+        ld.setParams(params);
+        ld.setCache(cache);
+        ld.setMetrics(metrics);
+        if (!output.empty())
+            ld.setOutput(resolvePath(output, ld.getFilename(), ".xlsx"));
+        if (!exportHull.empty())
+            ld.exportHull(resolvePath(exportHull, ld.getFilename(), ".hcb"));
+        if (!conditions.empty())
+            logEquilibrium(ld, conditions);
+    };
+
+    if (scaling) {
+        size_t failed = 0;
+        for (const auto& file : files)
+            if (!runScaling(file, threads == 1 ? 0 : threads, setup))
+                ++failed;
+        return failed == 0 ? 0 : 2;
+    }
+
+    HCBatch batch(files, jobs, setup);
+    size_t failed = batch.run();
+
+    return failed == 0 ? 0 : 2;
 }
\ No newline at end of file